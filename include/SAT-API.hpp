@@ -2,6 +2,8 @@
 #include "SAT-types.hpp"
 
 #include <vector>
+#include <string>
+#include <atomic>
 
 namespace napsat
 {
@@ -76,6 +78,175 @@ namespace napsat
    */
   status solve(NapSAT* solver);
 
+  /**
+   * @brief Solves the clause set under assumptions. The assumptions are
+   * decided before any other decision. The learned clauses, the variable
+   * activities and the phases of the previous calls are reused, and clauses
+   * can be added between calls.
+   * @param solver an instance of the SAT solver
+   * @param assumptions array of literals assumed to be true.
+   * @param n number of assumptions.
+   * @return SAT if the clause set is satisfiable with the assumptions, UNSAT
+   * otherwise. If get_failed_assumptions is empty, the clause set is
+   * unsatisfiable whatever the assumptions.
+   * @pre the solver is a valid instance of NapSAT
+   * @note The assumptions only hold for this call. The pointer assumptions is
+   * managed by the user.
+   */
+  status solve(NapSAT* solver, const Tlit* assumptions, unsigned n);
+
+  /**
+   * @brief Returns the subset of the assumptions of the last call to solve
+   * that is unsatisfiable with the clause set.
+   * @param solver an instance of the SAT solver
+   * @pre the solver is a valid instance of NapSAT
+   * @details The result is empty if the last call was satisfiable, or if the
+   * clause set itself is unsatisfiable. It is cleared when clauses are added.
+   */
+  const std::vector<Tlit>& get_failed_assumptions(NapSAT* solver);
+
+  /**
+   * @brief Splits the clause set into at most n cubes with a lookahead, for a
+   * cube-and-conquer distribution. Each cube can then be solved separately,
+   * with its literals as assumptions.
+   * @param solver an instance of the SAT solver
+   * @param n the maximum number of cubes.
+   * @return UNDEF if cubes were built (see get_cubes), SAT or UNSAT if the
+   * propagation at level 0 concludes, and UNSAT if the lookahead refuted
+   * every cube.
+   * @pre the solver is a valid instance of NapSAT
+   * @pre n > 0
+   * @details When the lookahead refutes every cube, the status of the solver
+   * becomes UNSAT, unless a resolution or DRAT proof is built. The proof
+   * would miss the refutation, hence the status remains UNDEF, and solving
+   * the clause set builds the proof.
+   */
+  status cube(NapSAT* solver, unsigned n);
+
+  /**
+   * @brief Returns the cubes of the last iCNF file parsed, or the cubes built
+   * by the last call to cube.
+   * @param solver an instance of the SAT solver
+   * @pre the solver is a valid instance of NapSAT
+   */
+  const std::vector<std::vector<Tlit>>& get_cubes(NapSAT* solver);
+
+  /**
+   * @brief Writes the clause set and the cubes in the iCNF format, that is, a
+   * header "p inccnf", the clauses, and one line "a <literals> 0" per cube.
+   * @param solver an instance of the SAT solver
+   * @param filename the name of the file.
+   * @return true if the file was written, false otherwise.
+   * @pre the solver is a valid instance of NapSAT
+   */
+  bool write_icnf(NapSAT* solver, const char* filename);
+
+  /**
+   * @brief Writes the state of the solver in a compact binary file, that is,
+   * the clause set with the learned clauses, the literals implied at level 0,
+   * the phases and activities of the variables, and the schedulers of the
+   * restarts and of the clause deletion. An interrupted search can be resumed
+   * from the file with load_state.
+   * @param solver an instance of the SAT solver
+   * @param filename the name of the file.
+   * @return true if the file was written, false otherwise.
+   * @pre the solver is a valid instance of NapSAT
+   */
+  bool save_state(NapSAT* solver, const char* filename);
+
+  /**
+   * @brief Loads a state written by save_state in a new solver. The watch
+   * lists and the decision heuristic are built once for the whole clause set.
+   * @param solver an instance of the SAT solver
+   * @param filename the name of the file.
+   * @return true if the state was loaded, false otherwise.
+   * @pre the solver is a valid instance of NapSAT, without clauses, and
+   * builds neither a resolution proof nor a DRAT proof.
+   * @details The options are those of the solver, not those of the solver
+   * that saved the state.
+   */
+  bool load_state(NapSAT* solver, const char* filename);
+
+  /**
+   * @brief Sets a flag that stops the search when it becomes true, typically
+   * from another thread. The search then returns with the status UNDEF, and
+   * can be resumed by calling solve again once the flag is false.
+   * @param solver an instance of the SAT solver
+   * @param flag pointer to the flag, owned by the caller, or nullptr to remove
+   * the flag.
+   * @pre the solver is a valid instance of NapSAT
+   */
+  void set_termination_flag(NapSAT* solver, const std::atomic<bool>* flag);
+
+  /**
+   * @brief Stops the search after n more conflicts. The search then returns
+   * with the status UNDEF, and keeps its learned clauses. It can be resumed by
+   * calling solve again after setting a new budget.
+   * @param solver an instance of the SAT solver
+   * @param n number of conflicts, or 0 to remove the budget.
+   * @pre the solver is a valid instance of NapSAT
+   */
+  void set_conflict_budget(NapSAT* solver, unsigned long n);
+
+  /**
+   * @brief Stops the search after n more propagations. The search then
+   * returns with the status UNDEF, and can be resumed as with the conflict
+   * budget.
+   * @param solver an instance of the SAT solver
+   * @param n number of propagations, or 0 to remove the budget.
+   * @pre the solver is a valid instance of NapSAT
+   */
+  void set_propagation_budget(NapSAT* solver, unsigned long n);
+
+  /**
+   * @brief Stops the search once the given wall-clock time has elapsed from
+   * now. The search then returns with the status UNDEF, and can be resumed as
+   * with the conflict budget.
+   * @param solver an instance of the SAT solver
+   * @param seconds the time budget, or 0 to remove the budget.
+   * @pre the solver is a valid instance of NapSAT
+   */
+  void set_time_budget(NapSAT* solver, double seconds);
+
+  /**
+   * @brief Stops the current search, which returns with the status UNDEF.
+   * This function is thread-safe, and is meant to be called while another
+   * thread is running solve. If the solver is not searching, the next call to
+   * solve returns UNDEF immediately.
+   * @param solver an instance of the SAT solver
+   * @pre the solver is a valid instance of NapSAT
+   */
+  void interrupt(NapSAT* solver);
+
+  /**
+   * @brief Derives n configurations from the given options for a portfolio.
+   * @param opt The options of the first configuration.
+   * @param n The number of configurations.
+   * @details The configurations cycle through the four backtracking modes,
+   * starting from the mode of opt. Every four configurations, the activity
+   * decay, the restart policy and the agility threshold change. Each
+   * configuration after the first one has a different seed.
+   */
+  std::vector<options> portfolio_configurations(const options& opt, unsigned n);
+
+  /**
+   * @brief Returns a short description of the configuration, as used in the
+   * portfolio.
+   */
+  std::string describe_configuration(const options& opt);
+
+  /**
+   * @brief Solves a DIMACS file with one solver per configuration, each on a
+   * separate thread. The solvers are stopped as soon as one of them concludes.
+   * @param filename the name of the file containing the clauses in dimacs format
+   * @param configurations the options of the solvers.
+   * @param winner set to the index of the configuration that concluded first.
+   * @return The solver that concluded first, or nullptr if the file could not
+   * be parsed. The other solvers are deleted. The returned solver must be
+   * deleted by the caller.
+   */
+  NapSAT* solve_portfolio(const char* filename, std::vector<options>& configurations, unsigned& winner);
+
   /**
    * @brief Returns the status of the solver.
    * @param solver an instance of the SAT solver
@@ -117,16 +288,62 @@ namespace napsat
    * @param solver an instance of the SAT solver
    * @param lits array of literals to add to the clause set.
    * @param size size of the clause.
-   * @return A handle to the added clause.
+   * @return A handle to the added clause, or CLAUSE_UNDEF if the clause is
+   * not added, e.g. because it has more than 2^25 - 1 literals.
    * @pre the solver is a valid instance of NapSAT
    * @note The memory of the clause is allocated by the solver. Therefore, the
    * pointer lits is managed by the user and is not freed by the solver.
    */
   Tclause add_clause(NapSAT* solver, const Tlit* lits, unsigned n_lits);
 
+  /**
+   * @brief Adds a batch of clauses to the clause set. This is faster than
+   * calling add_clause for each clause, since the data structures of the
+   * solver are sized once for the whole batch.
+   * @param solver an instance of the SAT solver
+   * @param lits the literals of all the clauses, one after the other.
+   * @param offsets array of n_clauses + 1 positions in lits. The clause i is
+   * made of the literals from lits[offsets[i]] to lits[offsets[i + 1] - 1].
+   * @param n_clauses the number of clauses.
+   * @pre the solver is a valid instance of NapSAT
+   * @note The handles of the clauses are not returned.
+   * @note The clauses with more than 2^25 - 1 literals are rejected with an
+   * error.
+   */
+  void add_clauses(NapSAT* solver, const Tlit* lits, const unsigned* offsets, unsigned n_clauses);
+
+  /**
+   * @brief Adds the constraint stating that at most bound literals of lits
+   * are true. The constraint is propagated natively, and its memory is linear
+   * in its size, whereas a clausal encoding is quadratic or needs auxiliary
+   * variables.
+   * @param solver an instance of the SAT solver
+   * @param lits array of literals of the constraint.
+   * @param n_lits number of literals.
+   * @param bound maximum number of true literals.
+   * @return false if the constraint could not be added, that is, if the
+   * solver builds a proof or is observed.
+   * @pre the solver is a valid instance of NapSAT
+   */
+  bool add_cardinality(NapSAT* solver, const Tlit* lits, unsigned n_lits, unsigned bound);
+
+  /**
+   * @brief Adds the constraint stating that at most one literal of lits is
+   * true (see add_cardinality).
+   * @param solver an instance of the SAT solver
+   * @param lits array of literals of the constraint.
+   * @param n_lits number of literals.
+   * @return false if the constraint could not be added.
+   * @pre the solver is a valid instance of NapSAT
+   */
+  bool add_at_most_one(NapSAT* solver, const Tlit* lits, unsigned n_lits);
+
   /**
    * @brief Returns a reference to the trail. The trail should not be modified
    * by the user.
+   * @details If the clause set is satisfiable, the trail is completed with the
+   * values of the variables eliminated by the preprocessing, such that it is
+   * a model of the clause set.
    * @param solver an instance of the SAT solver
    * @pre the solver is a valid instance of NapSAT
    */
@@ -138,13 +355,42 @@ namespace napsat
   bool is_decided(NapSAT* solver, Tlit lit);
 
   /**
-   * @brief Prints on the standard output the statistics collected by the solver
-   * if the observer was enabled. Otherwise prints a warning.
+   * @brief Prints on the standard output the counters collected by the solver,
+   * followed by the statistics collected by the observer if it was enabled.
    * @param solver an instance of the SAT solver
    * @pre the solver is a valid instance of NapSAT
   */
   void print_statistics(NapSAT* solver);
 
+  /**
+   * @brief Prints on the standard output the time spent in each phase of the
+   * solver, the number of propagations, conflicts and decisions, as well as
+   * the propagation and conflict rates.
+   * @param solver an instance of the SAT solver
+   * @pre the solver is a valid instance of NapSAT
+   * @pre the solver was built with the option benchmark set to true.
+  */
+  void print_benchmark(NapSAT* solver);
+
+  /**
+   * @brief Returns the counters collected by the solver (propagations,
+   * conflicts, decisions, restarts, watch list visits, learned clause
+   * histograms,...). Unlike print_statistics, this does not require the
+   * observer.
+   * @param solver an instance of the SAT solver
+   * @pre the solver is a valid instance of NapSAT
+  */
+  statistics get_statistics(NapSAT* solver);
+
+  /**
+   * @brief Returns an estimate of the number of bytes held by the clause
+   * store, the watch lists, the binary lists, the variables, the propagators,
+   * the proof and the observer of the solver.
+   * @param solver an instance of the SAT solver
+   * @pre the solver is a valid instance of NapSAT
+  */
+  memory_usage get_memory_usage(NapSAT* solver);
+
   /**
    * @brief Prints the proof of the last execution of the solver.
    * @param solver an instance of the SAT solver
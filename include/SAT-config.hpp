@@ -19,3 +19,7 @@
 // It is not recommended to enable this option for difficult problems, as it will slow down the solver significantly.
 // If the observer is not enabled, this option has no effect.
 #define NOTIFY_WATCH_CHANGES 1
+
+// If this option is enabled, the search of a replacement watched literal in long clauses tests several literals per
+// instruction when the processor supports AVX2. The processor is checked at run time.
+#define USE_SIMD 1
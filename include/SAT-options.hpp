@@ -127,12 +127,100 @@ namespace napsat
      */
     bool lazy_strong_chronological_backtracking = false;
 
+    /**
+     * @brief Chooses between chronological and non-chronological backtracking at each conflict. After the conflict analysis, the solver jumps to the assertion level, unless the jump undoes at least adaptive_backtracking_levels levels and more than adaptive_backtracking_margin times the moving average of the previous jumps, in which case it backtracks chronologically. The invariants of the selected chronological backtracking variant are maintained, and wcb is used if no variant is selected.
+     * acb => cb
+     * @alias -acb
+     */
+    bool adaptive_backtracking = false;
+
+    /**
+     * @brief Minimum number of levels undone by a jump for the adaptive backtracking to backtrack chronologically instead.
+     * @requires adaptive_backtracking is on
+     */
+    unsigned adaptive_backtracking_levels = 100;
+
+    /**
+     * @brief Ratio between a jump and the moving average of the previous jumps above which the adaptive backtracking backtracks chronologically instead.
+     * @requires adaptive_backtracking is on, margin >= 0
+     */
+    double adaptive_backtracking_margin = 2;
+
     /**
      * @brief Enables the solver to delete learned clauses.
      * @alias -del
     */
     bool delete_clauses = true;
 
+    /**
+     * @brief Enables the recursive minimization of learned clauses. A literal is removed from a learned clause if it is implied by the other literals of the clause through a chain of reasons.
+     * @alias -rmin
+    */
+    bool recursive_minimization = true;
+
+    /**
+     * @brief Enables the minimization of learned clauses with binary clauses. A literal is removed from a learned clause if a binary clause resolves it away with the asserting literal.
+     * @alias -bmin
+    */
+    bool binary_minimization = true;
+
+    /**
+     * @brief Seed of the random initial phases of the variables. If 0, the variables are initially decided false.
+     * @alias -seed
+    */
+    unsigned seed = 0;
+
+    /**
+     * @brief Number of solvers run in parallel on separate threads. Each solver uses a different configuration derived from the options, varying the backtracking mode, the activity decay, the restart policy, the agility threshold and the seed. The first solver uses the options as given. The search stops as soon as one solver concludes. If 0 or 1, a single solver is run. When a resolution proof is built, the solvers do not share clauses, and a DRAT proof cannot be written by a portfolio.
+     * @requires interactive is off
+     * @alias -portfolio
+    */
+    unsigned portfolio = 0;
+
+    /**
+     * @brief Enables the exchange of learned clauses between the solvers of the portfolio. The clauses are exported if they are short or have a low literal block distance, and the literals implied at level 0 are exported as units. The clauses are imported at level 0. Clause sharing is disabled when building a resolution proof, since the proof of a solver cannot justify the clauses learned by the others. Recording the imported clauses as input clauses would make the proof refute a stronger formula than the input. A DRAT proof cannot be written by a portfolio at all.
+     * @alias -share
+    */
+    bool share_clauses = true;
+
+    /**
+     * @brief Learned clauses with at most this number of literals are shared with the other solvers of the portfolio.
+     * @requires share_max_size <= 32
+     */
+    unsigned share_max_size = 8;
+
+    /**
+     * @brief Learned clauses with a literal block distance lower or equal to this value are shared with the other solvers of the portfolio, if they have at most 32 literals.
+     */
+    unsigned share_lbd = 2;
+
+    /**
+     * @brief Splits the clause set into at most this number of cubes instead of solving it, such that the cubes can be solved independently on several nodes. The cubes are built by a lookahead: at each node of the split, the candidate variables are decided in both polarities and propagated, and the variable whose two branches assign the most literals is branched on. If one branch of a candidate conflicts, the other literal is added to the cube without branching. If both conflict, the node is dropped. The nodes at depth ⌈log₂ n⌉ are the cubes. The clause set and the cubes are written in the iCNF format to cube_file. If 0, the clause set is solved.
+     * @requires portfolio and interactive are off
+     * @alias -cube
+    */
+    unsigned cubes = 0;
+
+    /**
+     * @brief File in which the clause set and the cubes are written, in the iCNF format.
+     * @requires cubes > 0
+     * @alias -cf
+    */
+    std::string cube_file = "cubes.icnf";
+
+    /**
+     * @brief Maximum number of variables evaluated by the lookahead at each node of the split. The candidates are the unassigned variables occurring in the most clauses.
+     * @requires lookahead_candidates > 0
+    */
+    unsigned lookahead_candidates = 50;
+
+    /**
+     * @brief Solves an input in the iCNF format under its n-th cube (from 1), the literals of the cube being assumptions. The result is the status of the cube. If 0, the cubes of the input are ignored and the clause set is solved.
+     * @requires cubes is 0
+     * @alias -conquer
+    */
+    unsigned conquer = 0;
+
     /** OBSERVER **/
     /**
      * @brief Sets the solver to interactive mode. Before each decision, the solver will wait for the user to enter a command before continuing.
@@ -154,6 +242,12 @@ namespace napsat
      * @alias -c
     */
     bool check_invariants = false;
+    /**
+     * @brief Checks every clause and the whole trail each time the invariants are checked. Otherwise, only the clauses, variables and trail literals changed since the last check are checked again.
+     * @details Implies check_invariants.
+     * @alias -fic
+    */
+    bool full_invariant_check = false;
     /**
      * @brief Enables the observer to print statistics during, and at the end of the execution.
      * @requires observing or interactive is on
@@ -161,7 +255,12 @@ namespace napsat
     */
     bool print_stats = false;
     /**
-     * @brief Enables the observer to build a proof during the execution.
+     * @brief Measures the time spent in each phase of the solver (parsing, preprocessing, propagation, conflict analysis, backtracking and clause deletion) and prints a machine-readable report at the end of the execution. Does not require the observer.
+     * @alias -bench
+    */
+    bool benchmark = false;
+    /**
+     * @brief Enables the observer to build a proof during the execution. In a portfolio, the solvers then do not share clauses.
      * @alias -bp
     */
     bool build_proof = false;
@@ -172,6 +271,13 @@ namespace napsat
     */
     bool check_proof = false;
 
+    /**
+     * @brief Number of threads used to check the proof. Only the clauses used to derive the empty clause are checked, and their resolution chains are checked independently. If 0, one thread per hardware thread is used.
+     * @requires check_proof is on
+     * @alias -cpt
+    */
+    unsigned check_proof_threads = 0;
+
     /**
      * @brief Enables the observer to print the proof during the execution.
      * @requires build_proof is on
@@ -179,6 +285,37 @@ namespace napsat
     */
     bool print_proof = false;
 
+    /**
+     * @brief File, or named pipe, to which a DRAT proof is written during the execution. The derived clauses and the deleted clauses are written as the solver runs, in buffered blocks, and are not kept in memory. The proof can be checked with drat-trim. If empty, no DRAT proof is written.
+     * @alias -drat
+    */
+    std::string proof_file = "";
+
+    /**
+     * @brief Writes the DRAT proof in the binary format instead of the text format.
+     * @requires proof_file is set
+    */
+    bool binary_proof = true;
+
+    /**
+     * @brief Maximum number of notifications kept by the observer. When the limit is reached, the oldest notifications are discarded and cannot be navigated back to anymore. If 0, all the notifications are kept. When only checking invariants, the notifications are deleted once applied and a compact record of the last ones is printed if an invariant is violated.
+     * @alias -hist
+    */
+    unsigned history_size = 0;
+
+    /**
+     * @brief Number of notifications between two snapshots of the state of the observer. Navigating to a notification restores the closest snapshot before it and replays the notifications from there, instead of applying or rolling back every notification in between. If 0, no snapshot is taken.
+     * @requires observing or interactive is on
+     * @alias -snap
+    */
+    unsigned snapshot_interval = 10000;
+
+    /**
+     * @brief File in which the observer streams a compact record of each notification, one per line.
+     * @alias -trace
+    */
+    std::string trace_file = "";
+
     /**
      * @brief File containing the commands to be executed by the solver.
      * @requires interactive is on
@@ -193,6 +330,14 @@ namespace napsat
     std::string save_folder = "";
 
     /** VARIABLE ACTIVITY **/
+    /**
+     * @brief Heuristic choosing the next decision variable. The available heuristics are:
+     * vsids: decides the variable with the highest activity. The variables involved in a conflict have their activity increased, and older bumps decay.
+     * vmtf: decides the unassigned variable involved in the most recent conflict. The variables involved in a conflict are moved to the front of a queue.
+     * @alias -dh
+     */
+    std::string decision_heuristic = "vsids";
+
     /**
      * @brief Decay factor of the _var_activity_increment.
      * @requires 0 < decay < 1
@@ -211,13 +356,101 @@ namespace napsat
      * @requires The multiplier must be greater than 1.
      */
     double clause_activity_multiplier = 1.001;
+
     /**
-     * @brief Decay factor of the clause activity threshold. If the solver deletes too many clauses, the solver will not make progress. Therefore, the threshold is multiplied by the threshold decay factor upon each clause deletion. This hyper parameter must be set to a value lower than 1.
-     * @requires 0 < decay < 1
+     * @brief Learned clauses with a literal block distance (number of distinct decision levels) lower or equal to this value are core clauses. Core clauses are never deleted.
+     */
+    unsigned core_lbd = 2;
+
+    /**
+     * @brief Learned clauses with a literal block distance lower or equal to this value (and greater than core_lbd) are tier 2 clauses. Tier 2 clauses are kept as long as they are used in conflict analysis between two clause deletions.
+     * @requires tier2_lbd >= core_lbd
+     */
+    unsigned tier2_lbd = 6;
+
+    /**
+     * @brief Fraction of the local clauses unused since the last clause deletion that are deleted. The clauses with the highest literal block distance are deleted first, and ties are broken by activity.
+     * @requires 0 < fraction <= 1
      */
-    double clause_activity_threshold_decay = 0.85;
+    double local_reduction_fraction = 0.5;
+
+    /**
+     * @brief Memory budget of the solver, in kilobytes. If 0, the memory is not limited. Every 1000 conflicts, the solver estimates the memory held by its clauses, watch lists, binary lists, proof and observer. Once it exceeds 90% of the budget, the tiers of the learned clauses are lowered, more learned clauses are deleted, and the clause store is compacted. The budget is soft, the solver does not stop when it is exceeded. In portfolio mode, the budget is shared among the solvers.
+     */
+    unsigned memory_limit = 0;
+
+    /**
+     * @brief After each clause deletion, shortens the learned clauses that are kept. The negations of the literals of a clause are decided one by one at level 1 and above, and propagated. If a literal is implied, or a conflict occurs, the clause is replaced by the literals involved, and literals implied false are removed. Clauses implied by other clauses are deleted.
+     * @requires interactive is off
+     * @alias -viv
+     */
+    bool vivification = true;
+
+    /**
+     * @brief Number of propagations allowed in a vivification round, as a fraction of the propagations of the search since the previous round.
+     * @requires 0 < effort <= 1
+     */
+    double vivification_effort = 0.1;
 
     /** RESTARTS **/
+    /**
+     * @brief Policy deciding when the solver restarts. The available policies are:
+     * agility: restarts when the agility (rate of polarity changes) is lower than agility_threshold.
+     * luby: restarts after restart_interval times the next element of the Luby sequence (1 1 2 1 1 2 4 ...) conflicts.
+     * geometric: restarts after restart_interval conflicts, and multiplies the interval by restart_geometric_factor after each restart.
+     * glucose: restarts when the fast moving average of the LBD of learned clauses exceeds restart_margin times the slow moving average.
+     * @alias -restart
+     */
+    std::string restart_policy = "agility";
+
+    /**
+     * @brief Number of conflicts between restarts. It is the unit of the Luby sequence, the first interval of the geometric policy, and the minimum number of conflicts between two glucose restarts.
+     * @requires restart_interval > 0
+     */
+    unsigned restart_interval = 50;
+
+    /**
+     * @brief Multiplier of the number of conflicts between two restarts in the geometric policy.
+     * @requires factor >= 1
+     */
+    double restart_geometric_factor = 1.5;
+
+    /**
+     * @brief Smoothing factor of the fast moving average of the LBD in the glucose policy.
+     * @requires 0 < alpha <= 1
+     */
+    double restart_ema_fast = 0.03;
+
+    /**
+     * @brief Smoothing factor of the slow moving average of the LBD in the glucose policy.
+     * @requires 0 < alpha <= 1
+     */
+    double restart_ema_slow = 1e-5;
+
+    /**
+     * @brief Margin of the glucose policy. The solver restarts when the fast moving average of the LBD is greater than the margin times the slow moving average.
+     * @requires margin >= 1
+     */
+    double restart_margin = 1.1;
+
+    /**
+     * @brief Enables partial restarts. Instead of backtracking to level 0, the solver keeps the decisions with a higher activity than the next decision, since they would be taken again.
+     * @alias -prst
+     */
+    bool partial_restarts = false;
+
+    /**
+     * @brief Enables target phases and rephasing. The target phase of a variable is its value in the longest conflict-free trail since the last rephasing, and is preferred to its last value when deciding. At the first restart after rephase_interval conflicts, the phases are reset in turn to the best phases (values in the longest conflict-free trail), the original phases (false, or random phases drawn when the variables are created if the solver is seeded), the best phases, the inverted original phases, the best phases, and random phases.
+     * @alias -rephase
+     */
+    bool rephase = false;
+
+    /**
+     * @brief Number of conflicts before the first rephasing. The interval between two rephasings grows linearly with the number of rephasings.
+     * @requires rephase_interval > 0
+     */
+    unsigned rephase_interval = 1000;
+
     /**
      * @brief Decay factor the of moving average of the agility.
      * @requires 0 < decay < 1
@@ -241,6 +474,24 @@ namespace napsat
      */
     double agility_threshold_decay = 1;
 
+    /** PREPROCESSING **/
+    /**
+     * @brief Simplifies the clause set before the first search with backward subsumption, self-subsuming resolution and bounded variable elimination. The values of the eliminated variables are reconstructed in the model. The variables of the assumptions are not eliminated, and the eliminated variables are restored if a later clause or assumption uses them. With a DRAT proof, no variable is eliminated, since the restored clauses could not be justified in the proof.
+     * @requires interactive is off
+     * @alias -pre
+     */
+    bool preprocess = false;
+
+    /**
+     * @brief Variables occurring in more clauses than this value, in one of their polarities, are not eliminated.
+     */
+    unsigned elim_max_occurrences = 16;
+
+    /**
+     * @brief A variable is not eliminated if one of the resolvents has more literals than this value.
+     */
+    unsigned elim_max_resolvent_size = 20;
+
     /** Stop Documentation **/
     // The tag above is used to generate the documentation of the options.
 
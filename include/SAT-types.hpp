@@ -105,4 +105,181 @@ namespace napsat
    */
   inline int lit_to_int(Tlit lit) { return (int) lit_pol(lit) ? (int) lit_to_var(lit) : -(int) lit_to_var(lit); }
 
+  /*************************************************************************/
+  /*                              Statistics                               */
+  /*************************************************************************/
+  /**
+   * @brief Number of buckets of the histograms in the statistics.
+   * @details Bucket i counts the clauses of size (or LBD) i. The last bucket
+   * counts all the clauses of size (or LBD) greater or equal to
+   * STAT_HISTOGRAM_SIZE - 1.
+   */
+  const unsigned STAT_HISTOGRAM_SIZE = 32;
+
+  /**
+   * @brief Counters collected by the solver during the search.
+   * @details The counters are always collected, even when the observer is
+   * compiled out. The structure is plain old data and can be copied freely.
+   */
+  typedef struct statistics
+  {
+    /**
+     * @brief Number of literals propagated.
+     */
+    unsigned long propagations;
+    /**
+     * @brief Number of conflicts encountered.
+     */
+    unsigned long conflicts;
+    /**
+     * @brief Number of decisions taken.
+     */
+    unsigned long decisions;
+    /**
+     * @brief Number of restarts.
+     */
+    unsigned long restarts;
+    /**
+     * @brief Number of times the saved phases were reset.
+     */
+    unsigned long rephases;
+    /**
+     * @brief Number of watch list entries visited during propagation.
+     */
+    unsigned long watch_visits;
+    /**
+     * @brief Number of watch list entries skipped because their blocker was
+     * satisfied, without dereferencing the clause.
+     */
+    unsigned long blocker_hits;
+    /**
+     * @brief Number of times a replacement for a watched literal was searched.
+     */
+    unsigned long replacement_searches;
+    /**
+     * @brief Number of clauses learned by conflict analysis.
+     */
+    unsigned long learned_clauses;
+    /**
+     * @brief Total number of literals in the learned clauses.
+     */
+    unsigned long learned_literals;
+    /**
+     * @brief Number of literals removed from the learned clauses by clause
+     * minimization.
+     */
+    unsigned long minimized_literals;
+    /**
+     * @brief Number of conflicts after which the adaptive backtracking
+     * backtracked chronologically instead of jumping to the assertion level.
+     */
+    unsigned long chronological_backtracks;
+    /**
+     * @brief Number of clauses exported to the other solvers of a portfolio.
+     */
+    unsigned long exported_clauses;
+    /**
+     * @brief Number of clauses imported from the other solvers of a
+     * portfolio.
+     */
+    unsigned long imported_clauses;
+    /**
+     * @brief Number of variables eliminated by the preprocessing.
+     */
+    unsigned long eliminated_variables;
+    /**
+     * @brief Number of clauses removed by the preprocessing because another
+     * clause subsumes them.
+     */
+    unsigned long subsumed_clauses;
+    /**
+     * @brief Number of literals removed from clauses by self-subsuming
+     * resolution during the preprocessing.
+     */
+    unsigned long strengthened_clauses;
+    /**
+     * @brief Number of learned clauses shortened by vivification.
+     */
+    unsigned long vivified_clauses;
+    /**
+     * @brief Number of literals removed from the learned clauses by
+     * vivification.
+     */
+    unsigned long vivified_literals;
+    /**
+     * @brief Number of learned clauses deleted by vivification because the
+     * other clauses imply them.
+     */
+    unsigned long vivification_deletions;
+    /**
+     * @brief Number of literals implied by the propagators of the constraints
+     * that are not clauses, such as the cardinality constraints.
+     */
+    unsigned long theory_propagations;
+    /**
+     * @brief Number of reasons and conflicts of the propagators added as
+     * learned clauses.
+     */
+    unsigned long theory_clauses;
+    /**
+     * @brief Number of reductions triggered because the memory held by the
+     * solver neared the memory limit.
+     */
+    unsigned long memory_reductions;
+    /**
+     * @brief Histogram of the sizes of the learned clauses.
+     */
+    unsigned long size_histogram[STAT_HISTOGRAM_SIZE];
+    /**
+     * @brief Histogram of the literal block distance (number of distinct
+     * decision levels) of the learned clauses when they were learned.
+     */
+    unsigned long lbd_histogram[STAT_HISTOGRAM_SIZE];
+  } statistics;
+
+  /**
+   * @brief Number of bytes held by the main structures of the solver.
+   * @details The sizes are the capacities of the containers, and the memory
+   * of the allocator itself is not counted.
+   */
+  typedef struct memory_usage
+  {
+    /**
+     * @brief Clause store, including the deleted clauses waiting for a
+     * compaction, and the activities of the clauses.
+     */
+    unsigned long clauses;
+    /**
+     * @brief Watch lists of the clauses with more than two literals.
+     */
+    unsigned long watches;
+    /**
+     * @brief Implication lists of the binary clauses.
+     */
+    unsigned long binaries;
+    /**
+     * @brief Assignment, levels, reasons and phases of the variables, and the
+     * trail.
+     */
+    unsigned long variables;
+    /**
+     * @brief Constraints of the propagators, such as the cardinality
+     * constraints.
+     */
+    unsigned long propagators;
+    /**
+     * @brief Resolution proof kept in memory. A DRAT proof is written to a
+     * file and is not counted.
+     */
+    unsigned long proof;
+    /**
+     * @brief Notifications, clauses and snapshots of the observer.
+     */
+    unsigned long observer;
+    /**
+     * @brief Sum of the above.
+     */
+    unsigned long total;
+  } memory_usage;
+
 }
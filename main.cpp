@@ -70,23 +70,61 @@ int main(int argc, char** argv)
   tokens = napsat::env::extract_environment_variables(tokens);
 
   napsat::options options(tokens);
-  napsat::NapSAT* solver = create_solver(0, 0, options);
+  napsat::NapSAT* solver;
+  chrono::time_point<chrono::high_resolution_clock> start;
+  napsat::status result;
 
-  if (!parse_dimacs(solver, argv[1])) {
-    LOG_ERROR("The input file could not be parsed.");
-    delete_solver(solver);
-    return 1;
+  if (options.portfolio > 1) {
+    // each solver of the portfolio parses the file on its own thread, so the time includes the parsing
+    vector<napsat::options> configurations = portfolio_configurations(options, options.portfolio);
+    unsigned winner;
+    start = chrono::high_resolution_clock::now();
+    solver = solve_portfolio(argv[1], configurations, winner);
+    if (!solver) {
+      LOG_ERROR("The input file could not be parsed.");
+      return 1;
+    }
+    cout << "c portfolio: configuration " << winner << " (" << describe_configuration(configurations[winner]) << ") concluded first" << endl;
+    result = get_status(solver);
+  }
+  else {
+    solver = create_solver(0, 0, options);
+    if (!parse_dimacs(solver, argv[1])) {
+      LOG_ERROR("The input file could not be parsed.");
+      delete_solver(solver);
+      return 1;
+    }
+    start = chrono::high_resolution_clock::now();
+    if (options.cubes > 0) {
+      result = cube(solver, options.cubes);
+      if (result == napsat::UNDEF) {
+        if (!write_icnf(solver, options.cube_file.c_str())) {
+          delete_solver(solver);
+          return 1;
+        }
+        cout << "c cubes: " << get_cubes(solver).size() << " written to " << options.cube_file << endl;
+      }
+    }
+    else if (options.conquer > 0) {
+      if (options.conquer > get_cubes(solver).size()) {
+        LOG_ERROR("The input has " << get_cubes(solver).size() << " cubes, cube " << options.conquer << " does not exist.");
+        delete_solver(solver);
+        return 1;
+      }
+      const vector<Tlit>& cube = get_cubes(solver)[options.conquer - 1];
+      result = solve(solver, cube.data(), cube.size());
+    }
+    else
+      result = solve(solver);
   }
-  chrono::time_point<chrono::high_resolution_clock> start = chrono::high_resolution_clock::now();
-  solve(solver);
   chrono::time_point<chrono::high_resolution_clock> end = chrono::high_resolution_clock::now();
   chrono::milliseconds duration = chrono::duration_cast<chrono::milliseconds>(end - start);
 
   cout << "Solution found in " << pretty_time(duration) << endl;
 
-  if (get_status(solver) == napsat::SAT)
+  if (result == napsat::SAT)
     cout << "s SATISFIABLE" << endl;
-  else if (get_status(solver) == napsat::UNSAT)
+  else if (result == napsat::UNSAT)
     cout << "s UNSATISFIABLE" << endl;
   else
     cout << "UNKNOWN" << endl;
@@ -94,10 +132,15 @@ int main(int argc, char** argv)
   if (options.print_stats) {
     print_statistics(solver);
   }
-  if (options.check_proof && get_status(solver) == napsat::UNSAT && !check_proof(solver)) {
+  if (options.benchmark) {
+    print_benchmark(solver);
+  }
+  // the proof only refutes the clause set, not a cube refuted by the lookahead or an unsatisfiable cube
+  bool refuted = get_status(solver) == napsat::UNSAT && get_failed_assumptions(solver).empty();
+  if (options.check_proof && refuted && !check_proof(solver)) {
     cout << WARNING_HEAD << "The proof is invalid." << endl;
   }
-  if (options.print_proof && get_status(solver) == napsat::UNSAT) {
+  if (options.print_proof && refuted) {
     print_proof(solver);
   }
 
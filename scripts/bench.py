@@ -0,0 +1,128 @@
+"""
+This script benchmarks the SAT solver on a folder of DIMACS files.
+The solver is run with the -bench option on each file, and the per-phase
+timings and counters it reports ("c bench <key> <value>" lines) are collected
+into a CSV table and a JSON file.
+If a baseline JSON file (produced by a previous run of this script) is given,
+the propagation rate of each instance is compared against the baseline and
+regressions are reported. The script then exits with a non-zero status.
+
+Example:
+  python3 scripts/bench.py --solver build/NapSAT --dir tests/cnf --out bench/result
+  python3 scripts/bench.py --solver build/NapSAT --baseline bench/result.json
+"""
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+import time
+
+parser = argparse.ArgumentParser(description="Benchmark the NapSAT solver.")
+parser.add_argument("--solver", default="build/NapSAT", help="path to the solver executable")
+parser.add_argument("--dir", default="tests/cnf", help="folder containing the benchmarks (.cnf and .cnf.xz)")
+parser.add_argument("--timeout", type=float, default=60, help="timeout per instance in seconds")
+parser.add_argument("--out", default="bench/result", help="prefix of the CSV and JSON output files")
+parser.add_argument("--baseline", default="", help="JSON file of a previous run to compare against")
+parser.add_argument("--threshold", type=float, default=0.1,
+                    help="relative slowdown of the propagation rate considered a regression")
+parser.add_argument("--min-time", type=float, default=0.1,
+                    help="instances solved faster than this (in seconds) are too noisy to be compared")
+parser.add_argument("options", nargs="*", help="additional options passed to the solver (after --)")
+args = parser.parse_args()
+
+columns = ["instance", "status", "wall_time"]
+
+
+def run_instance(path):
+  result = {"instance": os.path.basename(path), "status": "UNKNOWN"}
+  start = time.monotonic()
+  try:
+    output = subprocess.run([args.solver, path, "-bench"] + args.options,
+                            stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                            timeout=args.timeout, universal_newlines=True).stdout
+  except subprocess.TimeoutExpired:
+    result["status"] = "TIMEOUT"
+    result["wall_time"] = args.timeout
+    return result
+  result["wall_time"] = time.monotonic() - start
+  for line in output.splitlines():
+    if line.startswith("s "):
+      result["status"] = line[2:].strip()
+    elif line.startswith("c bench "):
+      tokens = line.split()
+      if len(tokens) != 4:
+        continue
+      key = tokens[2]
+      result[key] = float(tokens[3])
+      if key not in columns:
+        columns.append(key)
+  return result
+
+
+def compare(results, baseline):
+  regressions = []
+  reference = {r["instance"]: r for r in baseline["instances"]}
+  for r in results:
+    if r["instance"] not in reference:
+      continue
+    b = reference[r["instance"]]
+    if r["status"] != b["status"]:
+      print("c {}: status changed from {} to {}".format(r["instance"], b["status"], r["status"]))
+      if b["status"] != "TIMEOUT":
+        regressions.append(r["instance"])
+      continue
+    if b.get("solve_time", 0) < args.min_time or not b.get("propagations_per_sec") or "propagations_per_sec" not in r:
+      continue
+    ratio = r["propagations_per_sec"] / b["propagations_per_sec"]
+    flag = ""
+    if ratio < 1 - args.threshold:
+      flag = "  <- REGRESSION"
+      regressions.append(r["instance"])
+    print("c {}: {:.0f} -> {:.0f} propagations/sec ({:+.1f}%){}".format(
+      r["instance"], b["propagations_per_sec"], r["propagations_per_sec"], (ratio - 1) * 100, flag))
+  return regressions
+
+
+files = sorted(f for f in os.listdir(args.dir) if f.endswith(".cnf") or f.endswith(".cnf.xz"))
+if not files:
+  print("No benchmark found in " + args.dir)
+  sys.exit(1)
+
+results = []
+for f in files:
+  r = run_instance(os.path.join(args.dir, f))
+  print("c {:40} {:15} {:8.3f}s".format(r["instance"], r["status"], r["wall_time"]))
+  results.append(r)
+
+totals = {}
+for key in columns[2:]:
+  totals[key] = sum(r.get(key, 0) for r in results)
+if totals.get("solve_time", 0) > 0:
+  totals["propagations_per_sec"] = totals["propagations"] / totals["solve_time"]
+  totals["conflicts_per_sec"] = totals["conflicts"] / totals["solve_time"]
+
+out_dir = os.path.dirname(args.out)
+if out_dir:
+  os.makedirs(out_dir, exist_ok=True)
+with open(args.out + ".csv", "w", newline="") as f:
+  writer = csv.DictWriter(f, fieldnames=columns)
+  writer.writeheader()
+  for r in results:
+    writer.writerow(r)
+with open(args.out + ".json", "w") as f:
+  json.dump({"solver": args.solver, "options": args.options, "instances": results, "total": totals}, f, indent=2)
+print("c results written to {0}.csv and {0}.json".format(args.out))
+
+if args.baseline:
+  if not os.path.exists(args.baseline):
+    print("c baseline " + args.baseline + " does not exist, nothing to compare")
+    sys.exit(0)
+  with open(args.baseline, "r") as f:
+    baseline = json.load(f)
+  regressions = compare(results, baseline)
+  if regressions:
+    print("c {} regression(s): {}".format(len(regressions), " ".join(regressions)))
+    sys.exit(1)
+  print("c no regression")
@@ -101,6 +101,15 @@ with open(option_file, "r") as f:
                                                          .split(";")[0].strip()
       dataframe.loc[len(dataframe) - 1]["Category"] = current_category
       continue
+    if line.find("unsigned") != -1:
+      dataframe.loc[len(dataframe) - 1]["Type"] = "unsigned"
+      dataframe.loc[len(dataframe) - 1]["Option"] = "--" + line.split("unsigned")[1]\
+                                                               .split("=")[0]\
+                                                               .strip().replace("_", "-")
+      dataframe.loc[len(dataframe) - 1]["Default"] = line.split("=")[1]\
+                                                         .split(";")[0].strip()
+      dataframe.loc[len(dataframe) - 1]["Category"] = current_category
+      continue
     if line.find("std::string") != - 1:
       dataframe.loc[len(dataframe) - 1]["Type"] = "string"
       dataframe.loc[len(dataframe) - 1]["Option"] = "--" + line.split("std::string")[1]\
@@ -12,6 +12,7 @@
 #include "SAT-API.hpp"
 
 #include "solver/NapSAT.hpp"
+#include "utils/printer.hpp"
 
 #include <iostream>
 
@@ -56,6 +57,80 @@ napsat::status napsat::solve(NapSAT* solver)
   return solver->solve();
 }
 
+napsat::status napsat::solve(NapSAT* solver, const Tlit* assumptions, unsigned n)
+{
+  assert(solver != nullptr);
+  assert(assumptions != nullptr || n == 0);
+  return solver->solve(assumptions, n);
+}
+
+const std::vector<napsat::Tlit>& napsat::get_failed_assumptions(NapSAT* solver)
+{
+  assert(solver != nullptr);
+  return solver->failed_assumptions();
+}
+
+napsat::status napsat::cube(NapSAT* solver, unsigned n)
+{
+  assert(solver != nullptr);
+  assert(n > 0);
+  return solver->cube(n);
+}
+
+const std::vector<std::vector<napsat::Tlit>>& napsat::get_cubes(NapSAT* solver)
+{
+  assert(solver != nullptr);
+  return solver->cubes();
+}
+
+bool napsat::write_icnf(NapSAT* solver, const char* filename)
+{
+  assert(solver != nullptr);
+  return solver->write_icnf(filename);
+}
+
+bool napsat::save_state(NapSAT* solver, const char* filename)
+{
+  assert(solver != nullptr);
+  return solver->save_state(filename);
+}
+
+bool napsat::load_state(NapSAT* solver, const char* filename)
+{
+  assert(solver != nullptr);
+  return solver->load_state(filename);
+}
+
+void napsat::set_termination_flag(NapSAT* solver, const std::atomic<bool>* flag)
+{
+  assert(solver != nullptr);
+  solver->set_termination_flag(flag);
+}
+
+void napsat::set_conflict_budget(NapSAT* solver, unsigned long n)
+{
+  assert(solver != nullptr);
+  solver->set_conflict_budget(n);
+}
+
+void napsat::set_propagation_budget(NapSAT* solver, unsigned long n)
+{
+  assert(solver != nullptr);
+  solver->set_propagation_budget(n);
+}
+
+void napsat::set_time_budget(NapSAT* solver, double seconds)
+{
+  assert(solver != nullptr);
+  solver->set_time_budget(seconds);
+}
+
+void napsat::interrupt(NapSAT* solver)
+{
+  assert(solver != nullptr);
+  solver->interrupt();
+}
+
 napsat::status napsat::get_status(NapSAT* solver)
 {
   return solver->get_status();
@@ -85,10 +160,29 @@ napsat::Tclause napsat::add_clause(NapSAT* solver, const Tlit* lits, unsigned n_
   return solver->add_clause(lits, n_lits);
 }
 
+void napsat::add_clauses(NapSAT* solver, const Tlit* lits, const unsigned* offsets, unsigned n_clauses)
+{
+  assert(solver != nullptr);
+  assert(offsets != nullptr || n_clauses == 0);
+  solver->add_clauses(lits, offsets, n_clauses);
+}
+
+bool napsat::add_cardinality(NapSAT* solver, const Tlit* lits, unsigned n_lits, unsigned bound)
+{
+  assert(solver != nullptr);
+  return solver->add_cardinality(lits, n_lits, bound);
+}
+
+bool napsat::add_at_most_one(NapSAT* solver, const Tlit* lits, unsigned n_lits)
+{
+  assert(solver != nullptr);
+  return solver->add_cardinality(lits, n_lits, 1);
+}
+
 const std::vector<napsat::Tlit>& napsat::get_partial_assignment(NapSAT* solver)
 {
   assert(solver != nullptr);
-  return solver->trail();
+  return solver->partial_assignment();
 }
 
 bool napsat::is_decided(NapSAT* solver, Tlit lit)
@@ -100,17 +194,80 @@ bool napsat::is_decided(NapSAT* solver, Tlit lit)
 void napsat::print_statistics(NapSAT* solver)
 {
   assert(solver != nullptr);
-  assert(USE_OBSERVER);
+  const statistics& stats = solver->get_statistics();
+  std::cout << "Solver Statistics:\n";
+  std::cout << "  - Propagations: " << pretty_integer(stats.propagations) << "\n";
+  std::cout << "  - Conflicts: " << pretty_integer(stats.conflicts) << "\n";
+  std::cout << "  - Decisions: " << pretty_integer(stats.decisions) << "\n";
+  std::cout << "  - Restarts: " << pretty_integer(stats.restarts) << "\n";
+  if (stats.rephases > 0)
+    std::cout << "  - Rephases: " << pretty_integer(stats.rephases) << "\n";
+  std::cout << "  - Watch list visits: " << pretty_integer(stats.watch_visits) << "\n";
+  std::cout << "  - Blocker hits: " << pretty_integer(stats.blocker_hits) << "\n";
+  std::cout << "  - Replacement searches: " << pretty_integer(stats.replacement_searches) << "\n";
+  std::cout << "  - Learned clauses: " << pretty_integer(stats.learned_clauses) << "\n";
+  if (stats.learned_clauses > 0)
+    std::cout << "  - Average learned clause size: " << (double) stats.learned_literals / stats.learned_clauses << "\n";
+  std::cout << "  - Minimized literals: " << pretty_integer(stats.minimized_literals) << "\n";
+  if (stats.chronological_backtracks > 0)
+    std::cout << "  - Chronological backtracks: " << pretty_integer(stats.chronological_backtracks) << "\n";
+  if (stats.exported_clauses > 0 || stats.imported_clauses > 0) {
+    std::cout << "  - Exported clauses: " << pretty_integer(stats.exported_clauses) << "\n";
+    std::cout << "  - Imported clauses: " << pretty_integer(stats.imported_clauses) << "\n";
+  }
+  std::cout << "  - Eliminated variables: " << pretty_integer(stats.eliminated_variables) << "\n";
+  std::cout << "  - Subsumed clauses: " << pretty_integer(stats.subsumed_clauses) << "\n";
+  std::cout << "  - Strengthened clauses: " << pretty_integer(stats.strengthened_clauses) << "\n";
+  std::cout << "  - Vivified clauses: " << pretty_integer(stats.vivified_clauses) << "\n";
+  std::cout << "  - Vivified literals: " << pretty_integer(stats.vivified_literals) << "\n";
+  std::cout << "  - Vivification deletions: " << pretty_integer(stats.vivification_deletions) << "\n";
+  if (stats.theory_propagations > 0 || stats.theory_clauses > 0) {
+    std::cout << "  - Theory propagations: " << pretty_integer(stats.theory_propagations) << "\n";
+    std::cout << "  - Theory clauses: " << pretty_integer(stats.theory_clauses) << "\n";
+  }
+  if (stats.memory_reductions > 0)
+    std::cout << "  - Memory reductions: " << pretty_integer(stats.memory_reductions) << "\n";
+  const memory_usage memory = solver->get_memory_usage();
+  std::cout << "Memory Usage (bytes):\n";
+  std::cout << "  - Clauses: " << pretty_integer(memory.clauses) << "\n";
+  std::cout << "  - Watch lists: " << pretty_integer(memory.watches) << "\n";
+  std::cout << "  - Binary lists: " << pretty_integer(memory.binaries) << "\n";
+  std::cout << "  - Variables: " << pretty_integer(memory.variables) << "\n";
+  if (memory.propagators > 0)
+    std::cout << "  - Propagators: " << pretty_integer(memory.propagators) << "\n";
+  if (memory.proof > 0)
+    std::cout << "  - Proof: " << pretty_integer(memory.proof) << "\n";
+  if (memory.observer > 0)
+    std::cout << "  - Observer: " << pretty_integer(memory.observer) << "\n";
+  std::cout << "  - Total: " << pretty_integer(memory.total) << "\n";
 #if USE_OBSERVER
   napsat::gui::observer* obs = solver->get_observer();
   if (obs == nullptr) {
-    std::cout << "No statistic collected. Use -stat in the options to collect them." << std::endl;
+    std::cout << "No observer statistic collected. Use -stat in the options to collect them." << std::endl;
     return;
   }
   std::cout << obs->get_statistics();
 #endif
 }
 
+void napsat::print_benchmark(NapSAT* solver)
+{
+  assert(solver != nullptr);
+  solver->print_benchmark();
+}
+
+napsat::statistics napsat::get_statistics(NapSAT* solver)
+{
+  assert(solver != nullptr);
+  return solver->get_statistics();
+}
+
+napsat::memory_usage napsat::get_memory_usage(NapSAT* solver)
+{
+  assert(solver != nullptr);
+  return solver->get_memory_usage();
+}
+
 void napsat::print_proof(NapSAT* solver)
 {
   assert(solver != nullptr);
@@ -0,0 +1,155 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/SAT-portfolio.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the portfolio of the SAT solver, that
+ * is, several solvers with different configurations running in parallel on the same formula.
+ * @details The backtracking modes win on different instances, hence the configurations mainly differ by
+ * their mode. The solvers only share short learned clauses, through a lock-free exchange. The first one
+ * to conclude stops the others through their termination flag. The solvers building a resolution proof
+ * do not share clauses, since their proof could not justify the imported ones.
+ */
+#include "SAT-API.hpp"
+
+#include "solver/NapSAT.hpp"
+#include "utils/clause-exchange.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Number of clauses kept by each solver in the exchange.
+ */
+static const unsigned EXCHANGE_CAPACITY = 2048;
+
+/**
+ * @brief Variations of the search parameters, applied every four configurations of the portfolio.
+ */
+static const struct {
+  const char* decision_heuristic;
+  double var_activity_decay;
+  const char* restart_policy;
+  double agility_threshold;
+} variations[] = {
+  {"vsids", 0.90, "agility", 0.3},
+  {"vmtf", 0.99, "luby", 0.4},
+  {"vsids", 0.85, "glucose", 0.4},
+  {"vsids", 0.95, "geometric", 0.5}
+};
+
+/**
+ * @brief Backtracking modes, in the order of the portfolio.
+ */
+enum backtracking_mode { NCB, WCB, RSCB, LSCB };
+
+static backtracking_mode get_mode(const napsat::options& opt)
+{
+  if (opt.lazy_strong_chronological_backtracking)
+    return LSCB;
+  if (opt.restoring_strong_chronological_backtracking)
+    return RSCB;
+  if (opt.chronological_backtracking)
+    return WCB;
+  return NCB;
+}
+
+static void set_mode(napsat::options& opt, backtracking_mode mode)
+{
+  opt.weak_chronological_backtracking = mode == WCB;
+  opt.restoring_strong_chronological_backtracking = mode == RSCB;
+  opt.lazy_strong_chronological_backtracking = mode == LSCB;
+  opt.chronological_backtracking = mode != NCB;
+}
+
+vector<napsat::options> napsat::portfolio_configurations(const options& opt, unsigned n)
+{
+  vector<options> configurations;
+  backtracking_mode first_mode = get_mode(opt);
+  for (unsigned i = 0; i < n; i++) {
+    options configuration = opt;
+    configuration.portfolio = 0;
+    set_mode(configuration, (backtracking_mode) ((first_mode + i) % 4));
+    if (i >= 4) {
+      auto& variation = variations[(i / 4 - 1) % (sizeof(variations) / sizeof(variations[0]))];
+      configuration.decision_heuristic = variation.decision_heuristic;
+      configuration.var_activity_decay = variation.var_activity_decay;
+      configuration.restart_policy = variation.restart_policy;
+      configuration.agility_threshold = variation.agility_threshold;
+    }
+    if (i > 0)
+      configuration.seed = opt.seed + i;
+    if (opt.memory_limit)
+      configuration.memory_limit = max(1u, opt.memory_limit / n);
+    configurations.push_back(configuration);
+  }
+  return configurations;
+}
+
+string napsat::describe_configuration(const options& opt)
+{
+  static const char* modes[] = {"ncb", "wcb", "rscb", "lscb"};
+  stringstream ss;
+  ss << modes[get_mode(opt)];
+  if (opt.decision_heuristic == "vmtf")
+    ss << " vmtf";
+  else
+    ss << " decay " << opt.var_activity_decay;
+  ss << " restart " << opt.restart_policy;
+  if (opt.restart_policy == "agility")
+    ss << " " << opt.agility_threshold;
+  ss << " seed " << opt.seed;
+  return ss.str();
+}
+
+napsat::NapSAT* napsat::solve_portfolio(const char* filename, vector<options>& configurations, unsigned& winner)
+{
+  assert(!configurations.empty());
+  unsigned n = configurations.size();
+  vector<NapSAT*> solvers(n, nullptr);
+  atomic<bool> terminate(false);
+  atomic<unsigned> first(n);
+  utils::clause_exchange exchange(n, EXCHANGE_CAPACITY);
+
+  vector<thread> threads;
+  for (unsigned i = 0; i < n; i++) {
+    threads.emplace_back([&, i] {
+      NapSAT* solver = create_solver(0, 0, configurations[i]);
+      solvers[i] = solver;
+      solver->set_termination_flag(&terminate);
+      if (configurations[i].share_clauses && !configurations[i].build_proof)
+        solver->set_clause_exchange(&exchange, i);
+      if (!solver->parse_dimacs(filename)) {
+        // the other solvers cannot parse the file either
+        terminate = true;
+        return;
+      }
+      if (solver->solve() == UNDEF)
+        return;
+      unsigned expected = n;
+      if (first.compare_exchange_strong(expected, i))
+        terminate = true;
+    });
+  }
+  for (thread& t : threads)
+    t.join();
+
+  winner = first;
+  for (unsigned i = 0; i < n; i++) {
+    if (i == winner)
+      continue;
+    delete_solver(solvers[i]);
+  }
+  if (winner == n)
+    return nullptr;
+  solvers[winner]->set_termination_flag(nullptr);
+  solvers[winner]->set_clause_exchange(nullptr, 0);
+  return solvers[winner];
+}
@@ -97,6 +97,24 @@ void napsat::gui::display::notify_change(unsigned level)
         goto loop_start;
       }
     }
+    else if (command.rfind("goto", 0) == 0) {
+      if (command.size() < 6) {
+        std::cout << "Invalid notification number (positive integer expected)" << std::endl;
+        goto loop_start;
+      }
+      try {
+        _observer->seek(std::stoul(command.substr(5)));
+      }
+      catch (std::invalid_argument const&) {
+        std::cout << "Invalid notification number (positive integer expected)" << std::endl;
+        goto loop_start;
+      }
+      _updated = true;
+      if (_observer->is_real_time()) {
+        std::cout << "Back to real time" << std::endl;
+        return;
+      }
+    }
     else if (command.rfind("mark var", 0) == 0) {
       if (command.size() < 10) {
         std::cout << "Invalid variable (positive integer expected)" << std::endl;
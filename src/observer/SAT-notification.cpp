@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 
 using namespace napsat;
 using namespace napsat::gui;
@@ -87,6 +88,111 @@ std::string napsat::gui::notification_type_to_string(ENotifType type)
   }
 }
 
+std::string napsat::gui::event_to_string(const event& e)
+{
+  string s = notification_type_to_string(e.type);
+  switch (e.type) {
+  case ENotifType::DONE:
+  return s + (e.args[0] ? " SAT" : " UNSAT");
+  case ENotifType::NEW_VARIABLE:
+  case ENotifType::DELETE_VARIABLE:
+  case ENotifType::REMOVE_LOWER_IMPLICATION:
+  case ENotifType::CONFLICT:
+  case ENotifType::DELETE_CLAUSE:
+  case ENotifType::BACKTRACKING_STARTED:
+  return s + " " + to_string(e.args[0]);
+  case ENotifType::DECISION:
+  case ENotifType::PROPAGATION:
+  case ENotifType::REMOVE_PROPAGATION:
+  case ENotifType::UNASSIGNMENT:
+  return s + " " + to_string(lit_to_int(e.args[0]));
+  case ENotifType::IMPLICATION:
+  return s + " " + to_string(lit_to_int(e.args[0])) + " reason " + to_string(e.args[1]) + " level " + to_string(e.args[2]);
+  case ENotifType::NEW_CLAUSE:
+  return s + " " + to_string(e.args[0]) + " size " + to_string(e.args[1])
+    + (e.args[2] & 1 ? " learned" : "") + (e.args[2] & 2 ? " external" : "");
+  case ENotifType::WATCH:
+  case ENotifType::UNWATCH:
+  case ENotifType::BLOCKER:
+  case ENotifType::REMOVE_LITERAL:
+  return s + " " + to_string(e.args[0]) + " " + to_string(lit_to_int(e.args[1]));
+  case ENotifType::MISSED_LOWER_IMPLICATION:
+  return s + " " + to_string(e.args[0]) + " clause " + to_string(e.args[1]);
+  default:
+  return s;
+  }
+}
+
+/**
+ * @brief Number of slots allocated at once when the pool is empty.
+ */
+static const size_t POOL_CHUNK_SLOTS = 4096;
+
+namespace {
+  struct free_slot
+  {
+    free_slot* next;
+  };
+
+  /**
+   * @brief Chunks of memory backing the pool. They are only released at the end of the program,
+   * such that a notification can be freed by another thread than the one that allocated it.
+   */
+  struct pool_chunks
+  {
+    std::mutex mutex;
+    std::vector<void*> chunks;
+    ~pool_chunks()
+    {
+      for (void* chunk : chunks)
+        ::operator delete(chunk);
+    }
+  };
+
+  pool_chunks& get_pool_chunks()
+  {
+    static pool_chunks chunks;
+    return chunks;
+  }
+
+  thread_local free_slot* free_slots = nullptr;
+}
+
+void* napsat::gui::notification::operator new(size_t size)
+{
+  if (size > POOL_SLOT_SIZE)
+    return ::operator new(size);
+  if (!free_slots) {
+    char* chunk = static_cast<char*>(::operator new(POOL_SLOT_SIZE * POOL_CHUNK_SLOTS));
+    pool_chunks& chunks = get_pool_chunks();
+    {
+      std::lock_guard<std::mutex> lock(chunks.mutex);
+      chunks.chunks.push_back(chunk);
+    }
+    for (size_t i = 0; i < POOL_CHUNK_SLOTS; i++) {
+      free_slot* slot = reinterpret_cast<free_slot*>(chunk + i * POOL_SLOT_SIZE);
+      slot->next = free_slots;
+      free_slots = slot;
+    }
+  }
+  free_slot* slot = free_slots;
+  free_slots = slot->next;
+  return slot;
+}
+
+void napsat::gui::notification::operator delete(void* pointer, size_t size)
+{
+  if (!pointer)
+    return;
+  if (size > POOL_SLOT_SIZE) {
+    ::operator delete(pointer);
+    return;
+  }
+  free_slot* slot = static_cast<free_slot*>(pointer);
+  slot->next = free_slots;
+  free_slots = slot;
+}
+
 unsigned napsat::gui::new_variable::get_event_level(observer* obs)
 {
   ASSERT_OBS(this, obs);
@@ -156,6 +262,8 @@ bool napsat::gui::decision::apply(observer* obs)
   obs->_decision_level++;
   obs->_variables[var].level = obs->_decision_level;
   obs->_variables[var].reason = CLAUSE_UNDEF;
+  obs->touch_trail(obs->_assignment_stack.size());
+  obs->touch_variable(var);
   obs->_assignment_stack.push_back(lit);
   return true;
 }
@@ -195,6 +303,8 @@ bool napsat::gui::implication::apply(observer* obs)
   obs->_variables[var].value = lit_pol(lit);
   obs->_variables[var].reason = reason;
   obs->_variables[var].level = level;
+  obs->touch_trail(obs->_assignment_stack.size());
+  obs->touch_variable(var);
 
   if (!env::get_suppress_warning()) {
     Tlevel level_check = 0;
@@ -223,7 +333,7 @@ bool napsat::gui::implication::apply(observer* obs)
     if (!success) {
       event_level = 0;
       obs->_assignment_stack.push_back(lit);
-      cout << "Notification number " << obs->_notifications.size() << endl;
+      cout << "Notification number " << obs->_location << endl;
       return false;
     }
   }
@@ -261,6 +371,7 @@ bool napsat::gui::propagation::apply(observer* obs)
   ASSERT_OBS(this, obs->_assignment_stack[obs->_n_propagated] == lit);
   obs->_n_propagated++;
   obs->_variables[lit_to_var(lit)].propagated = true;
+  obs->touch_variable(lit_to_var(lit));
   return true;
 }
 
@@ -294,6 +405,7 @@ bool napsat::gui::remove_propagation::apply(observer* obs)
   ASSERT_OBS(this, obs->_assignment_stack[obs->_n_propagated] == lit);
   ASSERT_OBS(this, obs->_variables[lit_to_var(lit)].propagated);
   obs->_variables[lit_to_var(lit)].propagated = false;
+  obs->touch_variable(lit_to_var(lit));
   return true;
 }
 
@@ -348,6 +460,8 @@ bool napsat::gui::unassignment::apply(observer* obs)
     obs->_n_propagated--;
     propagated = true;
   }
+  obs->touch_trail(location);
+  obs->touch_variable(var);
 
   level = obs->_variables[var].level;
   reason = obs->_variables[var].reason;
@@ -402,10 +516,18 @@ bool napsat::gui::new_clause::apply(observer* obs)
       if (!env::get_suppress_warning() && obs->_clauses_dict[hash]->literals == lits) {
         if (!obs->_clauses_dict[hash]->active) {
           // The clause was deleted. This is not a big problem.
-          LOG_INFO("(at notification number " << obs->_notifications.size() << "): The clause " << cl << " is identical to the clause " << obs->_clauses_dict[hash]->cl << " that was deleted earlier");
+          LOG_INFO("(at notification number " << obs->_location << "): The clause " << cl << " is identical to the clause " << obs->_clauses_dict[hash]->cl << " that was deleted earlier");
+        }
+        else if (learnt && external) {
+          // A clause imported from another solver may have been learned by this solver as well.
+          LOG_INFO("(at notification number " << obs->_location << "): The imported clause " << cl << " is identical to the clause " << obs->_clauses_dict[hash]->cl);
+        }
+        else if (!learnt && !external) {
+          // A resolvent of the preprocessing may already be in the clause set. It is removed by subsumption.
+          LOG_INFO("(at notification number " << obs->_location << "): The derived clause " << cl << " is identical to the clause " << obs->_clauses_dict[hash]->cl);
         }
         else {
-          LOG_WARNING("(at notification number " << obs->_notifications.size() << "): The clause " << cl << " is identical to the clause " << obs->_clauses_dict[hash]->cl);
+          LOG_WARNING("(at notification number " << obs->_location << "): The clause " << cl << " is identical to the clause " << obs->_clauses_dict[hash]->cl);
           event_level = 0;
         }
       }
@@ -421,6 +543,8 @@ bool napsat::gui::new_clause::apply(observer* obs)
   ASSERT_OBS(this, obs->_active_clauses.size() > cl);
   obs->_active_clauses[cl] = obs->_clauses_dict[hash];
   obs->_active_clauses[cl]->active = true;
+  obs->add_occurrences(obs->_active_clauses[cl]);
+  obs->touch_clause(cl);
   // check that the sorted literals are the same
   ASSERT_OBS(this, obs->hash_clause(obs->_active_clauses[cl]->literals) == obs->hash_clause(lits));
   ASSERT_OBS(this, obs->hash_clause(obs->_clauses_dict[hash]->literals) == obs->hash_clause(lits));
@@ -450,6 +574,7 @@ bool napsat::gui::delete_clause::apply(observer* obs)
   obs->_active_clauses[cl]->active = false;
   vector<Tlit>& lits = obs->_active_clauses[cl]->literals;
   hash = obs->hash_clause(lits);
+  obs->touch_implied_variables(cl);
   return true;
 }
 
@@ -500,6 +625,7 @@ bool napsat::gui::watch::apply(observer* obs)
   // the watched literal must be in the clause
   ASSERT_OBS(this, !obs->is_watching(cl, lit));
   c->watched.insert(lit);
+  obs->touch_clause(cl);
   return true;
 }
 
@@ -530,6 +656,7 @@ bool napsat::gui::unwatch::apply(observer* obs)
   napsat::gui::observer::clause* c = obs->_active_clauses[cl];
   ASSERT_OBS(this, obs->is_watching(cl, lit));
   c->watched.erase(lit);
+  obs->touch_clause(cl);
   return true;
 }
 
@@ -564,6 +691,7 @@ bool napsat::gui::remove_literal::apply(observer* obs)
   c->literals[deleted_literal_location] = c->literals[last_literal_location];
   c->literals[last_literal_location] = lit;
   c->n_deleted_literals++;
+  obs->touch_implied_variables(cl);
   return true;
 }
 
@@ -584,9 +712,11 @@ bool napsat::gui::remove_literal::rollback(observer* obs)
 bool napsat::gui::check_invariants::apply(observer* obs)
 {
   ASSERT_OBS(this, obs);
-  if (!obs->check_invariants()) {
+  if (!obs->check_invariants_incremental()) {
     LOG_ERROR("Invariants are not satisfied");
     cerr << obs->get_error_message() << endl;
+    if (obs->is_checking_only())
+      obs->print_recent_events(cerr);
     event_level = 0;
   }
   return true;
@@ -619,6 +749,7 @@ bool napsat::gui::block::apply(observer* obs)
   ASSERT_OBS(this, find(c->literals.begin(), c->literals.end(), lit) != c->literals.end());
   previous_blocker = c->blocker;
   c->blocker = lit;
+  obs->touch_clause(cl);
   return true;
 }
 
@@ -642,6 +773,7 @@ bool napsat::gui::missed_lower_implication::apply(observer* obs)
   ASSERT_OBS(this, obs->_active_clauses[cl] != nullptr);
   last_cl = obs->_variables[var].lazy_reason;
   obs->_variables[var].lazy_reason = cl;
+  obs->touch_variable(var);
   return true;
 }
 
@@ -660,6 +792,7 @@ bool napsat::gui::remove_lower_implication::apply(observer* obs)
 {
   last_cl = obs->_variables[var].lazy_reason;
   obs->_variables[var].lazy_reason = CLAUSE_UNDEF;
+  obs->touch_variable(var);
   return true;
 }
 
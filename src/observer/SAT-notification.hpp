@@ -69,6 +69,23 @@ namespace napsat::gui
   };
   std::string notification_type_to_string(ENotifType type);
 
+  /**
+   * @brief Compact record of a notification.
+   * @details Unlike notifications, events have a fixed size and do not own any memory. They are
+   * used to keep the recent history of the solver and to stream it to a file. The meaning of the
+   * arguments depends on the type of the event (see event_to_string).
+   */
+  struct event
+  {
+    ENotifType type;
+    unsigned args[3];
+  };
+
+  /**
+   * @brief Returns a short string describing the event.
+   */
+  std::string event_to_string(const event& e);
+
   /**
    * @brief Virtual class that defines notifications that can be sent by the SAT solver to the observer.
    */
@@ -81,10 +98,27 @@ namespace napsat::gui
     unsigned event_level;
 
   public:
+    /**
+     * @brief Size of the slots of the notification pool. Larger notifications use the default allocator.
+     */
+    static const size_t POOL_SLOT_SIZE = 64;
+
+    /**
+     * @brief Notifications are allocated from a pool of fixed-size slots to avoid a call to the
+     * general purpose allocator for each notification sent by the solver.
+     */
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
+
     /**
      * @brief Returns a copy of the notification.
      */
     virtual notification* clone() const = 0;
+
+    /**
+     * @brief Returns a compact record of the notification.
+     */
+    virtual event get_event() const = 0;
     /**
      * @brief Get the level of the event.
      * - 0: reserved for checkpoints.
@@ -141,6 +175,7 @@ namespace napsat::gui
   public:
     checkpoint() {}
     checkpoint* clone() const override { return new checkpoint(); }
+    event get_event() const override { return { CHECKPOINT, 0, 0, 0 }; }
     unsigned get_event_level(observer* observer) override { return event_level; }
     const ENotifType get_type() override { return CHECKPOINT; }
     const std::string get_message() override { return "Checkpoint"; }
@@ -162,6 +197,7 @@ namespace napsat::gui
   public:
     done(bool sat) : sat(sat) {}
     done* clone() const override { return new done(sat); }
+    event get_event() const override { return { DONE, sat, 0, 0 }; }
     unsigned get_event_level(observer* observer) override { return event_level; }
     const ENotifType get_type() override { return DONE; }
     const std::string get_message() override { return "Done: " + std::to_string(sat); }
@@ -188,6 +224,7 @@ namespace napsat::gui
     marker() {}
     marker(std::string description) : description(description) {}
     marker* clone() const override { return new marker(); }
+    event get_event() const override { return { MARKER, 0, 0, 0 }; }
     unsigned get_event_level(observer* observer) override { return event_level; }
     const ENotifType get_type() override { return MARKER; }
     const std::string get_message() override { return "Marker : " + description; }
@@ -212,6 +249,7 @@ namespace napsat::gui
   public:
     new_variable(napsat::Tvar var) : var(var) {}
     new_variable* clone() const override { return new new_variable(var); }
+    event get_event() const override { return { NEW_VARIABLE, var, 0, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return NEW_VARIABLE; }
     const std::string get_message() override { return "New variable " + std::to_string(var) + " added"; }
@@ -237,6 +275,7 @@ namespace napsat::gui
   public:
     delete_variable(napsat::Tvar var) : var(var) {}
     delete_variable* clone() const override { return new delete_variable(var); }
+    event get_event() const override { return { DELETE_VARIABLE, var, 0, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return DELETE_VARIABLE; }
     const std::string get_message() override { return "Variable " + std::to_string(var) + " deleted"; }
@@ -262,6 +301,7 @@ namespace napsat::gui
   public:
     decision(napsat::Tlit lit) : lit(lit) {}
     decision* clone() const override { return new decision(lit); }
+    event get_event() const override { return { DECISION, lit, 0, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return DECISION; }
     const std::string get_message() override { return "Decision literal : " + std::to_string(napsat::lit_to_int(lit)); }
@@ -300,6 +340,7 @@ namespace napsat::gui
   public:
     implication(napsat::Tlit lit, napsat::Tclause cl, napsat::Tlevel level) : lit(lit), reason(cl), level(level) {}
     implication* clone() const override { return new implication(lit, reason, level); }
+    event get_event() const override { return { IMPLICATION, lit, reason, level }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return IMPLICATION; }
     const std::string get_message() override { return "Implication : " + std::to_string(napsat::lit_to_int(lit)) + " implied by clause " + std::to_string(reason); }
@@ -324,6 +365,7 @@ namespace napsat::gui
   public:
     propagation(napsat::Tlit lit) : lit(lit) {}
     propagation* clone() const override { return new propagation(lit); }
+    event get_event() const override { return { PROPAGATION, lit, 0, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return PROPAGATION; }
     const std::string get_message() override { return "Propagation : " + std::to_string(napsat::lit_to_int(lit)) + " propagated"; }
@@ -348,6 +390,7 @@ namespace napsat::gui
   public:
     remove_propagation(napsat::Tlit lit) : lit(lit) {}
     remove_propagation* clone() const override { return new remove_propagation(lit); }
+    event get_event() const override { return { REMOVE_PROPAGATION, lit, 0, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return PROPAGATION; }
     const std::string get_message() override { return "Propagation removed : " + std::to_string(napsat::lit_to_int(lit)); }
@@ -373,6 +416,7 @@ namespace napsat::gui
   public:
     conflict(napsat::Tclause cl) : cl(cl) {}
     conflict* clone() const override { return new conflict(cl); }
+    event get_event() const override { return { CONFLICT, cl, 0, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return CONFLICT; }
     const std::string get_message() override { return "Conflict : clause " + std::to_string(cl) + " detected"; }
@@ -395,6 +439,7 @@ namespace napsat::gui
   public:
     backtracking_started(napsat::Tlevel level) : level(level) {}
     backtracking_started* clone() const override { return new backtracking_started(level); }
+    event get_event() const override { return { BACKTRACKING_STARTED, level, 0, 0 }; }
     unsigned get_event_level(observer* observer) override { return event_level; }
     const ENotifType get_type() override { return BACKTRACKING_STARTED; }
     const std::string get_message() override { return "Backtracking started at level " + std::to_string(level); }
@@ -414,6 +459,7 @@ namespace napsat::gui
   public:
     backtracking_done() {}
     backtracking_done* clone() const override { return new backtracking_done(); }
+    event get_event() const override { return { BACKTRACKING_DONE, 0, 0, 0 }; }
     unsigned get_event_level(observer* observer) override { return event_level; }
     const ENotifType get_type() override { return BACKTRACKING_DONE; }
     const std::string get_message() override { return "Backtracking done"; }
@@ -461,6 +507,7 @@ namespace napsat::gui
   public:
     unassignment(napsat::Tlit lit) : lit(lit) {}
     unassignment* clone() const override { return new unassignment(lit); }
+    event get_event() const override { return { UNASSIGNMENT, lit, 0, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return UNASSIGNMENT; }
     const std::string get_message() override { return "Unassignment : " + std::to_string(napsat::lit_to_int(lit)) + " unassigned"; }
@@ -506,6 +553,7 @@ namespace napsat::gui
   public:
     new_clause(napsat::Tclause cl, std::vector<napsat::Tlit> lits, bool learnt, bool external) : cl(cl), lits(lits), learnt(learnt), external(external) {}
     new_clause* clone() const override { return new new_clause(cl, lits, learnt, external); }
+    event get_event() const override { return { NEW_CLAUSE, cl, (unsigned) lits.size(), (unsigned) (learnt | external << 1) }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return NEW_CLAUSE; }
     const std::string get_message() override
@@ -542,6 +590,7 @@ namespace napsat::gui
   public:
     delete_clause(napsat::Tclause cl) : cl(cl) {}
     delete_clause* clone() const override { return new delete_clause(cl); }
+    event get_event() const override { return { DELETE_CLAUSE, cl, 0, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return DELETE_CLAUSE; }
     const std::string get_message() override { return "Delete clause : " + std::to_string(cl); }
@@ -568,6 +617,7 @@ namespace napsat::gui
   public:
     watch(napsat::Tclause cl, napsat::Tlit lit) : cl(cl), lit(lit) {}
     watch* clone() const override { return new watch(cl, lit); }
+    event get_event() const override { return { WATCH, cl, lit, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return WATCH; }
     const std::string get_message() override { return "Watch literal : " + std::to_string(napsat::lit_to_int(lit)) + " in clause " + std::to_string(cl); }
@@ -593,6 +643,7 @@ namespace napsat::gui
   public:
     unwatch(napsat::Tclause cl, napsat::Tlit lit) : cl(cl), lit(lit) {}
     unwatch* clone() const override { return new unwatch(cl, lit); }
+    event get_event() const override { return { UNWATCH, cl, lit, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return UNWATCH; }
     const std::string get_message() override { return "Unwatch literal : " + std::to_string(napsat::lit_to_int(lit)) + " in clause " + std::to_string(cl); }
@@ -625,6 +676,7 @@ namespace napsat::gui
   public:
     block(napsat::Tclause cl, napsat::Tlit lit) : cl(cl), lit(lit) {}
     block* clone() const override { return new block(cl, lit); }
+    event get_event() const override { return { BLOCKER, cl, lit, 0 }; }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return BLOCKER; }
     const std::string get_message() override { return "Block literal : " + std::to_string(napsat::lit_to_int(lit)) + " in clause " + std::to_string(cl); }
@@ -654,6 +706,7 @@ namespace napsat::gui
   public:
     remove_literal(napsat::Tclause cl, napsat::Tlit lit) : cl(cl), lit(lit) {}
     remove_literal* clone() const override { return new remove_literal(cl, lit); }
+    event get_event() const override { return { REMOVE_LITERAL, cl, lit, 0 }; }
     const std::string get_message() override { return "Remove literal : " + std::to_string(napsat::lit_to_int(lit)) + " from clause " + std::to_string(cl); }
     unsigned get_event_level(observer* observer) override;
     const ENotifType get_type() override { return REMOVE_LITERAL; }
@@ -669,6 +722,7 @@ namespace napsat::gui
   public:
     check_invariants() {}
     check_invariants* clone() const override { return new check_invariants(); }
+    event get_event() const override { return { CHECK_INVARIANTS, 0, 0, 0 }; }
     const std::string get_message() override { return "Check invariants"; }
     unsigned get_event_level(observer* observer) override { return event_level; }
     const ENotifType get_type() override { return CHECK_INVARIANTS; }
@@ -688,6 +742,7 @@ namespace napsat::gui
   public:
     missed_lower_implication(Tvar var, Tclause cl) : var(var), cl(cl) {}
     missed_lower_implication* clone() const override { return new missed_lower_implication(var, cl); }
+    event get_event() const override { return { MISSED_LOWER_IMPLICATION, var, cl, 0 }; }
     const std::string get_message() override { return "Missed lower implication: " + std::to_string(var) + " in clause " + std::to_string(cl); }
     unsigned get_event_level(observer* observer) override { return event_level; }
     const ENotifType get_type() override { return MISSED_LOWER_IMPLICATION; }
@@ -706,6 +761,7 @@ namespace napsat::gui
   public:
     remove_lower_implication(Tvar var) : var(var) {}
     remove_lower_implication* clone() const override { return new remove_lower_implication(var); }
+    event get_event() const override { return { REMOVE_LOWER_IMPLICATION, var, 0, 0 }; }
     const std::string get_message() override { return "Remove lower implication: " + std::to_string(var) + " in clause " + std::to_string(last_cl); }
     unsigned get_event_level(observer* observer) override { return event_level; }
     const ENotifType get_type() override { return REMOVE_LOWER_IMPLICATION; }
@@ -730,6 +786,7 @@ namespace napsat::gui
   public:
     stat(std::string measured_variable) : measured_variable(measured_variable) {}
     stat* clone() const override { return new stat(measured_variable); }
+    event get_event() const override { return { STAT, 0, 0, 0 }; }
     const std::string get_message() override { return "Stat : " + measured_variable; }
     unsigned get_event_level(observer* observer) override { return event_level; }
     const ENotifType get_type() override { return STAT; }
@@ -27,6 +27,8 @@ void napsat::gui::observer::load_invariant_configuration()
     filename += "lazy-strong-chronological-backtracking";
   else if (_options.restoring_strong_chronological_backtracking)
     filename += "restoring-strong-chronological-backtracking";
+  else if (_options.adaptive_backtracking)
+    filename += "adaptive-chronological-backtracking";
   else if (_options.weak_chronological_backtracking)
     filename += "weak-chronological-backtracking";
   else
@@ -73,6 +75,7 @@ void napsat::gui::observer::load_invariant_configuration()
 bool napsat::gui::observer::check_invariants()
 {
   bool success = true;
+  update_trail_positions(0);
   success &= !_check_trail_sanity || check_trail_sanity();
   success &= !_check_level_ordering || check_level_ordering();
   success &= !_check_trail_monotonicity || check_trail_monotonicity();
@@ -82,6 +85,142 @@ bool napsat::gui::observer::check_invariants()
   success &= check_watched_literals();
 #endif
   success &= !_check_assignment_coherence || check_assignment_coherence();
+  clear_changes();
+  return success;
+}
+
+bool napsat::gui::observer::check_invariants_incremental()
+{
+  if (_full_check_pending || _options.full_invariant_check) {
+    _full_check_pending = false;
+    return check_invariants();
+  }
+  bool success = true;
+  update_trail_positions(_trail_dirty_from);
+
+  // the clauses containing a changed variable may have become unit, falsified or badly watched
+  for (Tvar var : _dirty_variables) {
+    if (var >= _occurrences.size())
+      continue;
+    vector<clause*>& occurrences = _occurrences[var];
+    unsigned j = 0;
+    for (clause* c : occurrences) {
+      if (!c->active)
+        continue;
+      occurrences[j++] = c;
+      touch_clause(c->cl);
+    }
+    occurrences.resize(j);
+  }
+
+  // literals of the trail whose reason must be checked again, below the changed part of the trail
+  vector<unsigned> trail_literals;
+  auto touch_trail_literal = [&](Tvar var) {
+    if (var_value(var) == VAR_UNDEF)
+      return;
+    unsigned i = _trail_position[var];
+    if (i < _trail_dirty_from && lit_to_var(_assignment_stack[i]) == var)
+      trail_literals.push_back(i);
+  };
+  for (Tvar var : _dirty_variables)
+    touch_trail_literal(var);
+
+  for (Tclause cl : _dirty_clauses) {
+    clause* c = _active_clauses[cl];
+    if (c == nullptr || !c->active)
+      continue;
+    success &= check_clause_invariants(cl);
+    // a literal of the clause may have been unassigned below the literal it implies
+    for (Tlit lit : c->literals)
+      if (var_reason(lit_to_var(lit)) == cl)
+        touch_trail_literal(lit_to_var(lit));
+  }
+
+  sort(trail_literals.begin(), trail_literals.end());
+  trail_literals.erase(unique(trail_literals.begin(), trail_literals.end()), trail_literals.end());
+  for (unsigned i : trail_literals)
+    success &= check_trail_literal_invariants(i);
+  for (unsigned i = _trail_dirty_from; i < _assignment_stack.size(); i++)
+    success &= check_trail_literal_invariants(i);
+  success &= !_check_trail_monotonicity || check_trail_monotonicity(_trail_dirty_from);
+
+  clear_changes();
+  return success;
+}
+
+void napsat::gui::observer::touch_variable(napsat::Tvar var)
+{
+  if (var >= _variable_dirty.size())
+    _variable_dirty.resize(var + 1, false);
+  if (_variable_dirty[var])
+    return;
+  _variable_dirty[var] = true;
+  _dirty_variables.push_back(var);
+}
+
+void napsat::gui::observer::touch_clause(napsat::Tclause cl)
+{
+  if (cl >= _clause_dirty.size())
+    _clause_dirty.resize(cl + 1, false);
+  if (_clause_dirty[cl])
+    return;
+  _clause_dirty[cl] = true;
+  _dirty_clauses.push_back(cl);
+}
+
+void napsat::gui::observer::touch_implied_variables(napsat::Tclause cl)
+{
+  touch_clause(cl);
+  for (Tlit lit : _active_clauses[cl]->literals)
+    if (var_reason(lit_to_var(lit)) == cl)
+      touch_variable(lit_to_var(lit));
+}
+
+void napsat::gui::observer::add_occurrences(clause* c)
+{
+  for (Tlit lit : c->literals) {
+    if (lit_to_var(lit) >= _occurrences.size())
+      _occurrences.resize(lit_to_var(lit) + 1);
+    _occurrences[lit_to_var(lit)].push_back(c);
+  }
+}
+
+void napsat::gui::observer::clear_changes()
+{
+  for (Tvar var : _dirty_variables)
+    _variable_dirty[var] = false;
+  _dirty_variables.clear();
+  for (Tclause cl : _dirty_clauses)
+    _clause_dirty[cl] = false;
+  _dirty_clauses.clear();
+  _trail_dirty_from = _assignment_stack.size();
+}
+
+void napsat::gui::observer::update_trail_positions(unsigned from)
+{
+  if (_trail_position.size() < _variables.size())
+    _trail_position.resize(_variables.size(), 0);
+  for (unsigned i = from; i < _assignment_stack.size(); i++)
+    _trail_position[lit_to_var(_assignment_stack[i])] = i;
+}
+
+bool napsat::gui::observer::check_clause_invariants(napsat::Tclause cl)
+{
+  bool success = true;
+  success &= !_check_trail_sanity || check_trail_sanity(cl);
+  success &= !_check_no_missed_implications || check_no_missed_implications(cl);
+#if NOTIFY_WATCH_CHANGES
+  success &= check_watched_literals(cl);
+#endif
+  return success;
+}
+
+bool napsat::gui::observer::check_trail_literal_invariants(unsigned i)
+{
+  bool success = true;
+  success &= !_check_level_ordering || check_level_ordering(i);
+  success &= !_check_topological_order || check_topological_order(i);
+  success &= !_check_assignment_coherence || check_assignment_coherence(i);
   return success;
 }
 
@@ -92,115 +231,132 @@ bool napsat::gui::observer::check_relevant_invariant(napsat::gui::notification *
 
 bool napsat::gui::observer::check_trail_sanity()
 {
-  const string error_header = ERROR_HEAD + "Invariant violation (trail sanity): ";
   bool success = true;
   for (Tclause cl = 0; cl < _active_clauses.size(); cl++) {
-    clause *c = _active_clauses[cl];
-    assert (c != nullptr);
-    if (!c->active)
-      continue;
-    unsigned i;
-    for (i = 0; i < c->literals.size(); i++)
-      if (lit_value(c->literals[i]) != VAR_FALSE || !lit_propagated(c->literals[i]))
-        break;
-    if (i == c->literals.size()) {
-      success = false;
-      _error_message += error_header + "clause " + clause_to_string(cl) + " is falsified by the trail.\n";
-    }
+    assert (_active_clauses[cl] != nullptr);
+    success &= check_trail_sanity(cl);
   }
   return success;
 }
 
+bool napsat::gui::observer::check_trail_sanity(napsat::Tclause cl)
+{
+  static const string error_header = ERROR_HEAD + "Invariant violation (trail sanity): ";
+  clause *c = _active_clauses[cl];
+  if (!c->active)
+    return true;
+  for (Tlit lit : c->literals)
+    if (lit_value(lit) != VAR_FALSE || !lit_propagated(lit))
+      return true;
+  _error_message += error_header + "clause " + clause_to_string(cl) + " is falsified by the trail.\n";
+  return false;
+}
+
 bool napsat::gui::observer::check_level_ordering()
 {
-  const string error_header = ERROR_HEAD + "Invariant violation (level ordering): ";
   bool success = true;
-  for (Tlit lit : _assignment_stack) {
-    if (lit_reason(lit) == CLAUSE_UNDEF || lit_reason(lit) == CLAUSE_LAZY)
-      continue;
-    clause *c = _active_clauses[lit_reason(lit)];
-    if (!c->active) {
+  for (unsigned i = 0; i < _assignment_stack.size(); i++)
+    success &= check_level_ordering(i);
+  return success;
+}
+
+bool napsat::gui::observer::check_level_ordering(unsigned i)
+{
+  static const string error_header = ERROR_HEAD + "Invariant violation (level ordering): ";
+  bool success = true;
+  Tlit lit = _assignment_stack[i];
+  if (lit_reason(lit) == CLAUSE_UNDEF || lit_reason(lit) == CLAUSE_LAZY)
+    return true;
+  clause *c = _active_clauses[lit_reason(lit)];
+  if (!c->active) {
+    _error_message += error_header + "clause " + clause_to_string(lit_reason(lit)) + " is not active.\n";
+    return false;
+  }
+  for (Tlit lit2 : c->literals) {
+    if (lit_level(lit2) > lit_level(lit)) {
       success = false;
-      _error_message += error_header + "clause " + clause_to_string(lit_reason(lit)) + " is not active.\n";
-      continue;
-    }
-    for (Tlit lit2 : c->literals) {
-      if (lit_level(lit2) > lit_level(lit)) {
-        success = false;
-        _error_message += error_header + "clause " + clause_to_string(lit_reason(lit)) + " has a literal " + lit_to_string(lit2) + " with a higher level than " + lit_to_string(lit) + ".\n";
-      }
+      _error_message += error_header + "clause " + clause_to_string(lit_reason(lit)) + " has a literal " + lit_to_string(lit2) + " with a higher level than " + lit_to_string(lit) + ".\n";
     }
   }
   return success;
 }
 
-bool napsat::gui::observer::check_trail_monotonicity()
+bool napsat::gui::observer::check_trail_monotonicity(unsigned from)
 {
-  const string error_header = ERROR_HEAD + "Invariant violation (trail monotonicity): ";
+  static const string error_header = ERROR_HEAD + "Invariant violation (trail monotonicity): ";
   bool success = true;
-  Tlevel last_level = 0;
-  for (Tlit lit : _assignment_stack) {
-    if (lit_level(lit) < last_level) {
+  for (unsigned i = max(from, 1u); i < _assignment_stack.size(); i++) {
+    Tlit lit = _assignment_stack[i];
+    if (lit_level(lit) < lit_level(_assignment_stack[i - 1])) {
       success = false;
-      _error_message += error_header + "literal " + lit_to_string(lit) + " has a lower level than the previous literal " + lit_to_string(_assignment_stack[_assignment_stack.size() - 1]) + ".\n";
+      _error_message += error_header + "literal " + lit_to_string(lit) + " has a lower level than the previous literal " + lit_to_string(_assignment_stack[i - 1]) + ".\n";
     }
-    last_level = lit_level(lit);
   }
   return success;
 }
 
 bool napsat::gui::observer::check_no_missed_implications()
 {
-  const string error_header = ERROR_HEAD + "Invariant violation (no missed implications): ";
   bool success = true;
-  for (Tclause cl = 0; cl < _active_clauses.size(); cl++) {
-    clause *c = _active_clauses[cl];
-    if (!c->active)
-      continue;
-    unsigned n_undef = 0;
-    Tlit last_undef = LIT_UNDEF;
-    for (Tlit watched : c->watched)
-      if (lit_value(watched) == VAR_TRUE || !lit_propagated(watched))
-        goto next_clause;
-    for (Tlit lit : c->literals) {
-      if (lit_value(lit) == VAR_TRUE || !lit_propagated(lit))
-        goto next_clause;
-      if (lit_value(lit) == VAR_UNDEF) {
-        n_undef++;
-        last_undef = lit;
-      }
-    }
-    if (n_undef == 1) {
-      success = false;
-      _error_message += error_header + "clause " + clause_to_string(cl) + " has only one undefined literal " + lit_to_string(last_undef) + ".\n";
+  for (Tclause cl = 0; cl < _active_clauses.size(); cl++)
+    success &= check_no_missed_implications(cl);
+  return success;
+}
+
+bool napsat::gui::observer::check_no_missed_implications(napsat::Tclause cl)
+{
+  static const string error_header = ERROR_HEAD + "Invariant violation (no missed implications): ";
+  clause *c = _active_clauses[cl];
+  if (!c->active)
+    return true;
+  unsigned n_undef = 0;
+  Tlit last_undef = LIT_UNDEF;
+  for (Tlit watched : c->watched)
+    if (lit_value(watched) == VAR_TRUE || !lit_propagated(watched))
+      return true;
+  for (Tlit lit : c->literals) {
+    if (lit_value(lit) == VAR_TRUE || !lit_propagated(lit))
+      return true;
+    if (lit_value(lit) == VAR_UNDEF) {
+      n_undef++;
+      last_undef = lit;
     }
-  next_clause:;
   }
-  return success;
+  if (n_undef == 1) {
+    _error_message += error_header + "clause " + clause_to_string(cl) + " has only one undefined literal " + lit_to_string(last_undef) + ".\n";
+    return false;
+  }
+  return true;
 }
 
 bool napsat::gui::observer::check_topological_order()
 {
-  const string error_header = ERROR_HEAD + "Invariant violation (topological order): ";
   bool success = true;
-  vector<bool> visited(_variables.size(), false);
-  for (Tlit lit : _assignment_stack) {
-    assert(lit_to_var(lit) < visited.size());
-    visited[lit_to_var(lit)] = true;
-    if (lit_reason(lit) == CLAUSE_UNDEF || lit_reason(lit) == CLAUSE_LAZY)
-      continue;
-    clause *c = _active_clauses[lit_reason(lit)];
-    if (!c->active) {
-      success = false;
-      _error_message += error_header + "clause " + clause_to_string(lit_reason(lit)) + " is not active.\n";
+  update_trail_positions(0);
+  for (unsigned i = 0; i < _assignment_stack.size(); i++)
+    success &= check_topological_order(i);
+  return success;
+}
+
+bool napsat::gui::observer::check_topological_order(unsigned i)
+{
+  static const string error_header = ERROR_HEAD + "Invariant violation (topological order): ";
+  bool success = true;
+  Tlit lit = _assignment_stack[i];
+  if (lit_reason(lit) == CLAUSE_UNDEF || lit_reason(lit) == CLAUSE_LAZY)
+    return true;
+  clause *c = _active_clauses[lit_reason(lit)];
+  if (!c->active) {
+    _error_message += error_header + "clause " + clause_to_string(lit_reason(lit)) + " is not active.\n";
+    return false;
+  }
+  for (Tlit lit2 : c->literals) {
+    Tvar var2 = lit_to_var(lit2);
+    // the literal itself is visited at position i
+    if (var_value(var2) != VAR_UNDEF && _trail_position[var2] <= i)
       continue;
-    }
-    for (Tlit lit2 : c->literals) {
-      if (!visited[lit_to_var(lit2)]) {
-        success = false;
-        _error_message += error_header + "the reason clause " + clause_to_string(lit_reason(lit)) + " for the implication of literal " + lit_to_string(lit) + " has a literal " + lit_to_string(lit2) + " that is not visited yet.\n";
-      }
-    }
+    success = false;
+    _error_message += error_header + "the reason clause " + clause_to_string(lit_reason(lit)) + " for the implication of literal " + lit_to_string(lit) + " has a literal " + lit_to_string(lit2) + " that is not visited yet.\n";
   }
   return success;
 }
@@ -210,85 +366,90 @@ bool napsat::gui::observer::check_watched_literals()
 {
   if (!_check_weak_watched_literals && !_check_strong_watched_literals && !_check_lazy_backtrack_compatible_watch_literals && !_check_backtrack_compatible_watched_literals)
     return true;
-  const string error_header = ERROR_HEAD + "Invariant violation (watch literals): ";
   bool success = true;
-  for (Tclause cl = 0; cl < _active_clauses.size(); cl++) {
-    clause *c = _active_clauses[cl];
-    // cout << "checking clause " << clause_to_string(cl) << endl;
-    if (!c->active || c->literals.size() - c->n_deleted_literals < 2)
-      continue;
-    if (c->literals.size() - c->n_deleted_literals == 2) {
-      c->watched.insert(c->literals[0]);
-      c->watched.insert(c->literals[1]);
-    }
-    if (c->watched.size() != 2) {
-      _error_message += error_header + "clause " + clause_to_string(cl) + " has " + to_string(c->watched.size()) + " watched literals.\n";
-      _error_message += error_header + "watched literals: ";
-      for (Tlit lit : c->watched)
-        _error_message += lit_to_string(lit) + " ";
-      _error_message += "\n";
-      success = false;
-      continue;
-    }
+  for (Tclause cl = 0; cl < _active_clauses.size(); cl++)
+    success &= check_watched_literals(cl);
+  return success;
+}
 
+bool napsat::gui::observer::check_watched_literals(napsat::Tclause cl)
+{
+  if (!_check_weak_watched_literals && !_check_strong_watched_literals && !_check_lazy_backtrack_compatible_watch_literals && !_check_backtrack_compatible_watched_literals)
+    return true;
+  static const string error_header = ERROR_HEAD + "Invariant violation (watch literals): ";
+  bool success = true;
+  clause *c = _active_clauses[cl];
+  if (!c->active || c->literals.size() - c->n_deleted_literals < 2)
+    return true;
+  if (c->literals.size() - c->n_deleted_literals == 2) {
+    c->watched.insert(c->literals[0]);
+    c->watched.insert(c->literals[1]);
+  }
+  if (c->watched.size() != 2) {
+    _error_message += error_header + "clause " + clause_to_string(cl) + " has " + to_string(c->watched.size()) + " watched literals.\n";
+    _error_message += error_header + "watched literals: ";
+    for (Tlit lit : c->watched)
+      _error_message += lit_to_string(lit) + " ";
+    _error_message += "\n";
+    return false;
+  }
 
-    for (Tlit lit : c->watched) {
-      Tlit other = LIT_UNDEF;
-      for (Tlit l : c->watched) {
-        if (l != lit) {
-          other = l;
-          break;
-        }
+  for (Tlit lit : c->watched) {
+    Tlit other = LIT_UNDEF;
+    for (Tlit l : c->watched) {
+      if (l != lit) {
+        other = l;
+        break;
       }
+    }
 
-      // weak blocker level
-      // c₁ ∈ π ∨ c₂ ∈ π ∨ [b ∈ π ∧ [δ(b) ≤ δ(c₁) ∨ δ(b) ≤ δ(c₂)]]
-      if (_check_weak_blocker_level && !check_weak_blocker_level(lit, other, c->blocker)) {
-        success = false;
-        _error_message += ERROR_HEAD + "c₁ ∈ π ∨ c₂ ∈ π ∨ [b ∈ π ∧ [δ(b) ≤ δ(c₁) ∨ δ(b) ≤ δ(c₂)]]  --  Weak blocker level invariant violation: \n";
-        _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
-      }
+    // weak blocker level
+    // c₁ ∈ π ∨ c₂ ∈ π ∨ [b ∈ π ∧ [δ(b) ≤ δ(c₁) ∨ δ(b) ≤ δ(c₂)]]
+    if (_check_weak_blocker_level && !check_weak_blocker_level(lit, other, c->blocker)) {
+      success = false;
+      _error_message += ERROR_HEAD + "c₁ ∈ π ∨ c₂ ∈ π ∨ [b ∈ π ∧ [δ(b) ≤ δ(c₁) ∨ δ(b) ≤ δ(c₂)]]  --  Weak blocker level invariant violation: \n";
+      _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
+    }
 
-      // strong blocker level
-      // δ(b) ≤ δ(c₁) ∧ δ(b) ≤ δ(c₂)
-      if (_check_strong_blocker_level && !check_strong_blocker_level(lit, other, c->blocker)) {
-        success = false;
-        _error_message += ERROR_HEAD + "δ(b) ≤ δ(c₁) ∧ δ(b) ≤ δ(c₂)  --  Strong blocker level invariant violation: \n";
-        _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
-      }
+    // strong blocker level
+    // δ(b) ≤ δ(c₁) ∧ δ(b) ≤ δ(c₂)
+    if (_check_strong_blocker_level && !check_strong_blocker_level(lit, other, c->blocker)) {
+      success = false;
+      _error_message += ERROR_HEAD + "δ(b) ≤ δ(c₁) ∧ δ(b) ≤ δ(c₂)  --  Strong blocker level invariant violation: \n";
+      _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
+    }
 
-      // weak watched literals
-      // ¬c₁ ∈ τ ⇒ c₂ ∉ τ ∨ [b ∈ π ∧ δ(b) ≤ δ(c₂)]
-      if (_check_weak_watched_literals && !weak_watched_literals(lit, other, c->blocker))  {
-        success = false;
-        _error_message += ERROR_HEAD + "¬c₁ ∈ τ ⇒ [c₂ ∉ τ ∨ b ∈ π]  --  Weak watched literals invariant violation: \n";
-        _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
-      }
+    // weak watched literals
+    // ¬c₁ ∈ τ ⇒ c₂ ∉ τ ∨ [b ∈ π ∧ δ(b) ≤ δ(c₂)]
+    if (_check_weak_watched_literals && !weak_watched_literals(lit, other, c->blocker))  {
+      success = false;
+      _error_message += ERROR_HEAD + "¬c₁ ∈ τ ⇒ [c₂ ∉ τ ∨ b ∈ π]  --  Weak watched literals invariant violation: \n";
+      _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
+    }
 
-      // strong watched literals
-      // ¬c₁ ∈ τ ⇒ c₂ ∈ π ∨ [b ∈ π ∧ δ(b) ≤ δ(c₂)]
-      if (_check_strong_watched_literals && !strong_watched_literals(lit, other, c->blocker)) {
-        success = false;
-        _error_message += ERROR_HEAD + "¬c₁ ∈ τ ⇒ [c₂ ∈ π ∨ b ∈ π]  --  Strong watched literals invariant violation: \n";
-        _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
-      }
+    // strong watched literals
+    // ¬c₁ ∈ τ ⇒ c₂ ∈ π ∨ [b ∈ π ∧ δ(b) ≤ δ(c₂)]
+    if (_check_strong_watched_literals && !strong_watched_literals(lit, other, c->blocker)) {
+      success = false;
+      _error_message += ERROR_HEAD + "¬c₁ ∈ τ ⇒ [c₂ ∈ π ∨ b ∈ π]  --  Strong watched literals invariant violation: \n";
+      _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
+    }
 
-      // lazy backtrack compatible watched literals
-      // ¬c₁ ∈ τ ⇒ [c₂ ∈ π ∧ [δ(c₂) ≤ δ(c₁) ∨ δ(λ(c₂) \ {c₂}) ≤ δ(c₁)]
-      //          ∨ [b ∈ π ∧ δ(b) ≤ δ(c₁)]
-      if (_check_lazy_backtrack_compatible_watch_literals && !lazy_backtrack_compatible_watched_literals(lit, other, c->blocker)) {
-        success = false;
-        _error_message += ERROR_HEAD + "¬c₁ ∈ τ ⇒ [c₂ ∈ π ∧ [δ(c₂) ≤ δ(c₁) ∨ δ(λ(c₂) \\ {c₂}) ≤ δ(c₁)] ∨ [b ∈ π ∧ δ(b) ≤ δ(c₁)]  --  Lazy backtrack compatible watched literals invariant violation: \n";
-        _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
-      }
+    // lazy backtrack compatible watched literals
+    // ¬c₁ ∈ τ ⇒ [c₂ ∈ π ∧ [δ(c₂) ≤ δ(c₁) ∨ δ(λ(c₂) \ {c₂}) ≤ δ(c₁)]
+    //          ∨ [b ∈ π ∧ δ(b) ≤ δ(c₁)]
+    if (_check_lazy_backtrack_compatible_watch_literals && !lazy_backtrack_compatible_watched_literals(lit, other, c->blocker)) {
+      success = false;
+      _error_message += ERROR_HEAD + "¬c₁ ∈ τ ⇒ [c₂ ∈ π ∧ [δ(c₂) ≤ δ(c₁) ∨ δ(λ(c₂) \\ {c₂}) ≤ δ(c₁)] ∨ [b ∈ π ∧ δ(b) ≤ δ(c₁)]  --  Lazy backtrack compatible watched literals invariant violation: \n";
+      _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
+    }
 
-      // backward compatible watched literals
-      // ¬c₁ ∈ τ ⇒ [c₂ ∈ π ∧ δ(c₂) ≤ δ(c₁)] ∨ [b ∈ π ∧ δ(b) ≤ δ(c₂)]
-      if (_check_backtrack_compatible_watched_literals && !backward_compatible_watched_literals(lit, other, c->blocker)) {
-        success = false;
-        _error_message += ERROR_HEAD + "¬c₁ ∈ τ ⇒ [c₂ ∈ π ∧ δ(c₂) ≤ δ(c₁)] ∨ [b ∈ π ∧ δ(b) ≤ δ(c₂)]  --  Backward compatible watched literals invariant violation: \n";
-        _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
-      }
+    // backward compatible watched literals
+    // ¬c₁ ∈ τ ⇒ [c₂ ∈ π ∧ δ(c₂) ≤ δ(c₁)] ∨ [b ∈ π ∧ δ(b) ≤ δ(c₂)]
+    if (_check_backtrack_compatible_watched_literals && !backward_compatible_watched_literals(lit, other, c->blocker)) {
+      success = false;
+      _error_message += ERROR_HEAD + "¬c₁ ∈ τ ⇒ [c₂ ∈ π ∧ δ(c₂) ≤ δ(c₁)] ∨ [b ∈ π ∧ δ(b) ≤ δ(c₂)]  --  Backward compatible watched literals invariant violation: \n";
+      _error_message += ERROR_HEAD + "clause " + clause_to_string(cl) + " does not satisfy the invariant if c₁ is " + lit_to_string(lit) + " and c₂ is " + lit_to_string(other) + ".\n";
     }
   }
   return success;
@@ -362,41 +523,47 @@ bool napsat::gui::observer::check_strong_blocker_level(napsat::Tlit c1, napsat::
 
 bool napsat::gui::observer::check_assignment_coherence()
 {
-  const string error_header = ERROR_HEAD + "Invariant violation (assignment coherence): ";
   bool success = true;
-  vector<bool> visited(_active_clauses.size(), false);
-  for (Tlit lit : _assignment_stack) {
-    if (visited[lit_to_var(lit)]) {
-      success = false;
-      _error_message += error_header + "variable " + to_string(lit_to_var(lit)) + " is visited more than once.\n";
-    }
-    if (lit_value(lit) == VAR_UNDEF) {
-      success = false;
-      _error_message += error_header + "variable " + to_string(lit_to_var(lit)) + " is undefined.\n";
-    }
-    if (lit_value(lit) == VAR_FALSE) {
-      success = false;
-      _error_message += error_header + "variable " + to_string(lit_to_var(lit)) + " is false in the assignment.\n";
-    }
-    visited[lit_to_var(lit)] = true;
+  update_trail_positions(0);
+  for (unsigned i = 0; i < _assignment_stack.size(); i++)
+    success &= check_assignment_coherence(i);
+  return success;
+}
+
+bool napsat::gui::observer::check_assignment_coherence(unsigned i)
+{
+  static const string error_header = ERROR_HEAD + "Invariant violation (assignment coherence): ";
+  bool success = true;
+  Tlit lit = _assignment_stack[i];
+  // the position of a variable is the one of its last occurrence in the trail
+  if (_trail_position[lit_to_var(lit)] != i) {
+    success = false;
+    _error_message += error_header + "variable " + to_string(lit_to_var(lit)) + " is visited more than once.\n";
+  }
+  if (lit_value(lit) == VAR_UNDEF) {
+    success = false;
+    _error_message += error_header + "variable " + to_string(lit_to_var(lit)) + " is undefined.\n";
+  }
+  if (lit_value(lit) == VAR_FALSE) {
+    success = false;
+    _error_message += error_header + "variable " + to_string(lit_to_var(lit)) + " is false in the assignment.\n";
+  }
 
-    Tclause reason = lit_reason(lit);
-    if (reason == CLAUSE_UNDEF || reason == CLAUSE_LAZY)
+  Tclause reason = lit_reason(lit);
+  if (reason == CLAUSE_UNDEF || reason == CLAUSE_LAZY)
+    return success;
+  clause *c = _active_clauses[reason];
+  if (!c->active) {
+    _error_message += error_header + "clause " + clause_to_string(reason) + " is not active.\n";
+    return false;
+  }
+  // check that the reason is only satisfied by one literal, that is "lit"
+  for (Tlit l : c->literals) {
+    if (l == lit)
       continue;
-    clause *c = _active_clauses[reason];
-    if (!c->active) {
+    if (lit_value(l) != VAR_FALSE) {
       success = false;
-      _error_message += error_header + "clause " + clause_to_string(reason) + " is not active.\n";
-      continue;
-    }
-    // check that the reason is only satisfied by one literal, that is "lit"
-    for (Tlit l : c->literals) {
-      if (l == lit)
-        continue;
-      if (lit_value(l) != VAR_FALSE) {
-        success = false;
-        _error_message += error_header + "clause " + clause_to_string(reason) + " is satisfied by literal " + lit_to_string(l) + " but not by " + lit_to_string(lit) + ".\n";
-      }
+      _error_message += error_header + "clause " + clause_to_string(reason) + " is satisfied by literal " + lit_to_string(l) + " but not by " + lit_to_string(lit) + ".\n";
     }
   }
   return success;
@@ -72,6 +72,16 @@ napsat::gui::observer::observer(napsat::options& options) : _options(options)
       toggle_stats_only(true);
     }
   }
+  // the notifications are not navigated in these modes, only a compact record of the last ones is kept
+  if ((_check_invariants_only || _stats_only) && options.history_size > 0) {
+    _keep_notifications = false;
+    _recent_events.resize(options.history_size);
+  }
+  if (options.trace_file != "") {
+    _trace.open(options.trace_file);
+    if (!_trace.is_open())
+      LOG_ERROR("The trace file \"" + options.trace_file + "\" could not be opened.");
+  }
   load_invariant_configuration();
   if (options.commands_file != "") {
     load_commands(options.commands_file);
@@ -98,6 +108,136 @@ napsat::gui::observer::observer(const observer& other) : _options(other._options
 {
   for (auto notification : other._notifications)
     _notifications.push_back(notification->clone());
+  _n_discarded = other._n_discarded;
+}
+
+void observer::record_event(const notification* notification)
+{
+  if (_recent_events.empty() && !_trace.is_open())
+    return;
+  event e = notification->get_event();
+  if (!_recent_events.empty()) {
+    _recent_events[_next_event] = e;
+    _next_event = (_next_event + 1) % _recent_events.size();
+  }
+  if (_trace.is_open())
+    _trace << _n_notifications << " " << event_to_string(e) << "\n";
+}
+
+void observer::store_notification(notification* notification)
+{
+  _notifications.push_back(notification);
+  if (_options.history_size == 0 || _notifications.size() <= _options.history_size)
+    return;
+  delete _notifications.front();
+  _notifications.pop_front();
+  _n_discarded++;
+  while (!_snapshots.empty() && _snapshots.begin()->first < _n_discarded)
+    _snapshots.erase(_snapshots.begin());
+}
+
+void observer::take_snapshot()
+{
+  snapshot& s = _snapshots[_location];
+  s.variables = _variables;
+  s.assignment_stack = _assignment_stack;
+  s.n_propagated = _n_propagated;
+  s.decision_level = _decision_level;
+  s.active_clauses = _active_clauses;
+  s.clauses.clear();
+  s.clauses.resize(_active_clauses.size());
+  _snapshot_size = _variables.size() + _assignment_stack.size() + _active_clauses.size();
+  for (unsigned i = 0; i < _active_clauses.size(); i++) {
+    clause* c = _active_clauses[i];
+    if (c == nullptr)
+      continue;
+    s.clauses[i] = { c->literals, c->n_deleted_literals, c->watched, c->blocker, c->active };
+    _snapshot_size += c->literals.size();
+  }
+  _n_since_snapshot = 0;
+}
+
+void observer::restore_snapshot(unsigned location, const snapshot& s)
+{
+  // the clauses created after the snapshot are inactive, and are reset to their initial state in
+  // case their creation is replayed
+  for (auto& entry : _clauses_dict) {
+    clause* c = entry.second;
+    c->active = false;
+    c->watched.clear();
+    c->blocker = LIT_UNDEF;
+    c->n_deleted_literals = 0;
+  }
+  // the slots allocated after the snapshot are kept, with their inactive clause, since the clause
+  // ids are never reallocated by the observer
+  assert(_active_clauses.size() >= s.active_clauses.size());
+  for (unsigned i = 0; i < s.active_clauses.size(); i++) {
+    clause* c = s.active_clauses[i];
+    _active_clauses[i] = c;
+    if (c == nullptr)
+      continue;
+    const clause_state& state = s.clauses[i];
+    c->literals = state.literals;
+    c->n_deleted_literals = state.n_deleted_literals;
+    c->watched = state.watched;
+    c->blocker = state.blocker;
+    c->active = state.active;
+  }
+  _variables = s.variables;
+  _assignment_stack = s.assignment_stack;
+  _n_propagated = s.n_propagated;
+  _decision_level = s.decision_level;
+  _location = location;
+
+  // the occurrence lists may have lost clauses that were deleted after the snapshot
+  _occurrences.clear();
+  for (clause* c : _active_clauses)
+    if (c != nullptr && c->active)
+      add_occurrences(c);
+  _full_check_pending = true;
+}
+
+void observer::seek(unsigned location)
+{
+  assert(_keep_notifications);
+  unsigned end = _n_discarded + _notifications.size();
+  location = max(_n_discarded, min(location, end));
+  unsigned distance = location > _location ? location - _location : _location - location;
+  auto it = _snapshots.upper_bound(location);
+  if (it != _snapshots.begin()) {
+    it--;
+    if (location - it->first < distance)
+      restore_snapshot(it->first, it->second);
+  }
+  while (_location < location) {
+    notification* notification = _notifications[_location - _n_discarded];
+    _location++;
+    notification->apply(this);
+  }
+  while (_location > location) {
+    _location--;
+    notification* notification = _notifications[_location - _n_discarded];
+    if (!notification->rollback(this)) {
+      LOG_ERROR("Rollback failed of notification " + to_string(_location + 1) << " with message " << notification->get_message());
+      exit(1);
+    }
+    // the rollbacks do not record their changes
+    _full_check_pending = true;
+  }
+}
+
+void observer::print_recent_events(std::ostream& os)
+{
+  unsigned size = _recent_events.size();
+  unsigned n_events = _n_notifications < size ? _n_notifications : size;
+  if (n_events == 0)
+    return;
+  os << "Last " << n_events << " notifications:\n";
+  unsigned first = (_next_event + size - n_events) % size;
+  for (unsigned i = 0; i < n_events; i++) {
+    long long number = _n_notifications - n_events + i + 1;
+    os << "  " << number << ": " << event_to_string(_recent_events[(first + i) % size]) << "\n";
+  }
 }
 
 bool observer::notify(notification* notification)
@@ -112,10 +252,11 @@ bool observer::notify(notification* notification)
   else {
     notification_count[notification->get_type()]++;
     _n_notifications++;
+    record_event(notification);
     if (_stats_only)
       delete notification;
-    else
-      _notifications.push_back(notification);
+    else if (_keep_notifications)
+      store_notification(notification);
   }
 
   // print the statistics
@@ -159,12 +300,22 @@ bool observer::notify(notification* notification)
     return true;
 
   _location++;
-  assert(_location == _notifications.size());
+  assert(!_keep_notifications || _location == _n_discarded + _notifications.size());
   // cout << "notification " << _location << "/" << _notifications.size() << endl;
   // cout << "notification: " << notification->get_message() << endl;
   bool apply_success = notification->apply(this);
 
-  if (!_check_invariants_only) {
+  if (_keep_notifications && _options.snapshot_interval > 0
+   && ++_n_since_snapshot >= max<size_t>(_options.snapshot_interval, _snapshot_size))
+    take_snapshot();
+
+  if (!_keep_notifications) {
+    // the notification cannot be navigated, it is not needed anymore
+    delete notification;
+    if (!apply_success)
+      print_recent_events(cerr);
+  }
+  else if (!_check_invariants_only) {
     if (_breakpoints.find(_location) != _breakpoints.end()) {
       cout << "Breakpoint reached" << endl;
       _display->notify_change(1);
@@ -202,24 +353,49 @@ std::string observer::get_statistics()
   return s;
 }
 
+size_t observer::memory_size() const
+{
+  size_t size = _notifications.size() * (sizeof(notification*) + notification::POOL_SLOT_SIZE);
+  size += _recent_events.capacity() * sizeof(event);
+  size += _variables.capacity() * sizeof(variable);
+  size += _assignment_stack.capacity() * sizeof(Tlit);
+  size += _active_clauses.capacity() * sizeof(clause*);
+  for (const auto& pair : _clauses_dict)
+    size += sizeof(clause) + pair.second->literals.capacity() * sizeof(Tlit);
+  for (const auto& pair : _snapshots) {
+    const snapshot& s = pair.second;
+    size += s.variables.capacity() * sizeof(variable);
+    size += s.assignment_stack.capacity() * sizeof(Tlit);
+    size += s.active_clauses.capacity() * sizeof(clause*);
+    size += s.clauses.capacity() * sizeof(clause_state);
+    for (const clause_state& state : s.clauses)
+      size += state.literals.capacity() * sizeof(Tlit);
+  }
+  return size;
+}
+
 unsigned observer::next()
 {
   if (_stats_only)
     LOG_WARNING("trying to navigate in statistics only mode");
-  assert(_location < _notifications.size());
-  _notifications[_location++]->apply(this);
+  assert(_location - _n_discarded < _notifications.size());
+  notification* notification = _notifications[_location - _n_discarded];
+  _location++;
+  notification->apply(this);
   if (_breakpoints.find(_location) != _breakpoints.end()) {
     cout << "Breakpoint reached" << endl;
     return 1;
   }
-  return _notifications[_location - 1]->get_event_level(this);
+  return notification->get_event_level(this);
 }
 
 unsigned observer::back()
 {
-  assert(_location > 0);
+  assert(_location > _n_discarded);
   _location--;
-  notification* notification = _notifications[_location];
+  // the rollbacks do not record their changes
+  _full_check_pending = true;
+  notification* notification = _notifications[_location - _n_discarded];
   bool rollback_success = notification->rollback(this);
   if (_breakpoints.find(_location) != _breakpoints.end()) {
     cout << "Breakpoint reached" << endl;
@@ -236,7 +412,9 @@ std::string napsat::gui::observer::last_message()
 {
   if (_location == 0)
     return "Initial state";
-  return _notifications[_location - 1]->get_message();
+  if (_location == _n_discarded)
+    return "Oldest notification in the history";
+  return _notifications[_location - _n_discarded - 1]->get_message();
 }
 
 void napsat::gui::observer::mark_variable(napsat::Tvar var)
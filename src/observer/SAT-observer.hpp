@@ -20,9 +20,12 @@
 #include "SAT-notification.hpp"
 #include "../display/SAT-display.hpp"
 
+#include <algorithm>
 #include <vector>
+#include <deque>
 #include <functional>
 #include <string>
+#include <fstream>
 #include <map>
 #include <set>
 #include <unordered_map>
@@ -72,7 +75,7 @@ namespace napsat::gui
     {
       variable() = default;
       variable(napsat::Tval value, napsat::Tlevel level, napsat::Tclause reason, bool active) : value(value), level(level), reason(reason), active(active) {}
-      variable(const variable& other) : value(other.value), level(other.level), reason(other.reason), active(other.active) {}
+      variable(const variable& other) : value(other.value), level(other.level), reason(other.reason), lazy_reason(other.lazy_reason), active(other.active), propagated(other.propagated) {}
 
       /**
        * @brief The truth value of the variable. It can be either true, false, or undefined.
@@ -105,14 +108,113 @@ namespace napsat::gui
 
     napsat::options _options;
 
-    std::vector<notification*> _notifications;
+    /**
+     * @brief Notifications that can be navigated. If the history size is limited, only the last
+     * notifications are kept.
+     */
+    std::deque<notification*> _notifications;
+
+    /**
+     * @brief Number of notifications discarded from the front of _notifications.
+     */
+    unsigned _n_discarded = 0;
 
     long long _n_notifications = 0;
 
+    /**
+     * @brief False if the notifications are deleted as soon as they are applied.
+     * @details When only checking invariants or collecting statistics with a limited history, the
+     * notifications are never navigated and only their compact records are kept.
+     */
+    bool _keep_notifications = true;
+
+    /**
+     * @brief Ring buffer of the compact records of the last notifications.
+     * @details Only used when the notifications are not kept, such that the history preceding an
+     * error can still be printed.
+     */
+    std::vector<event> _recent_events;
+
+    /**
+     * @brief Position of the next event in the ring buffer.
+     */
+    unsigned _next_event = 0;
+
+    /**
+     * @brief File in which the events are streamed if tracing is enabled.
+     */
+    std::ofstream _trace;
+
+    /**
+     * @brief Records the compact version of the notification in the ring buffer and the trace.
+     */
+    void record_event(const notification* notification);
+
+    /**
+     * @brief Stores the notification, discarding the oldest one if the history is full.
+     */
+    void store_notification(notification* notification);
+
     unsigned _location = 0;
 
     bool _stopped = true;
 
+    /**
+     * @brief State of a clause at the time of a snapshot.
+     */
+    struct clause_state
+    {
+      std::vector<napsat::Tlit> literals;
+      unsigned n_deleted_literals;
+      std::set<napsat::Tlit> watched;
+      napsat::Tlit blocker;
+      bool active;
+    };
+
+    /**
+     * @brief Copy of the state of the observer after a given notification.
+     */
+    struct snapshot
+    {
+      std::vector<variable> variables;
+      std::vector<napsat::Tlit> assignment_stack;
+      unsigned n_propagated;
+      napsat::Tlevel decision_level;
+      std::vector<clause*> active_clauses;
+      /**
+       * @brief State of the clauses in active_clauses, at the same index. The clause objects are
+       * owned by _clauses_dict and are modified after the snapshot.
+       */
+      std::vector<clause_state> clauses;
+    };
+
+    /**
+     * @brief Snapshots of the state of the observer, indexed by the location they were taken at.
+     */
+    std::map<unsigned, snapshot> _snapshots;
+
+    /**
+     * @brief Number of notifications applied since the last snapshot.
+     */
+    unsigned _n_since_snapshot = 0;
+
+    /**
+     * @brief Size of the last snapshot, in variables, literals and clauses. Snapshots are never
+     * taken more often than their size, such that they do not use more memory than the
+     * notifications themselves.
+     */
+    size_t _snapshot_size = 0;
+
+    /**
+     * @brief Stores a snapshot of the current state at the current location.
+     */
+    void take_snapshot();
+
+    /**
+     * @brief Restores the state of the observer as it was when the snapshot was taken.
+     */
+    void restore_snapshot(unsigned location, const snapshot& snapshot);
+
     /**
      * Set of clauses that were added to the solver from the beginning.
      */
@@ -229,6 +331,17 @@ namespace napsat::gui
      */
     std::string get_statistics();
 
+    /**
+     * @brief Returns an estimate of the number of bytes held by the notifications, the clauses, the
+     * variables and the snapshots of the observer.
+     */
+    size_t memory_size() const;
+
+    /**
+     * @brief Prints the last events recorded in the ring buffer, from the oldest to the most recent.
+     */
+    void print_recent_events(std::ostream& os);
+
     /**  OBSERVING EXECUTION  **/
 
     /**
@@ -243,6 +356,15 @@ namespace napsat::gui
      */
     unsigned back();
 
+    /**
+     * @brief Moves to the state right after the notification number location, by restoring the
+     * closest snapshot and replaying the notifications from there when it is shorter than moving
+     * notification by notification from the current location.
+     * @details The location is clamped to the navigable history. Breakpoints are ignored.
+     * @pre The notifications must be kept.
+     */
+    void seek(unsigned location);
+
     /**
      * @brief Returns the message of the last notification that was applied.
      */
@@ -253,12 +375,12 @@ namespace napsat::gui
     /**
      * @brief Returns true if the state of the observer corresponds to the last notification it received. In other words, returns true if the observer is in real time.
      */
-    bool is_real_time() { return _location == _notifications.size(); }
+    bool is_real_time() { return _location == _n_discarded + _notifications.size(); }
 
     /**
      * @brief Returns true if the state of the observer corresponds to before the first notification it received. In other words, returns true if the observer is at the beginning of the execution.
      */
-    bool is_back_to_origin() { return _location == 0; }
+    bool is_back_to_origin() { return _location == _n_discarded; }
 
     /**
      * @brief Marks a variable. When this variable is involved in a notification, level of that notification becomes 0.
@@ -531,6 +653,91 @@ namespace napsat::gui
     bool _check_strong_blocker_level = false;
     bool _check_assignment_coherence = false;
 
+    /**  INCREMENTAL CHECKING  **/
+    /**
+     * @brief True if the next check must sweep over all clauses and the whole trail, because the
+     * changes since the last check were not recorded (e.g. after navigating back in the history).
+     */
+    bool _full_check_pending = false;
+
+    /**
+     * @brief Variables whose value, level, propagation status or lazy reason changed since the last
+     * check. The clauses containing them and their reason clause are checked again.
+     */
+    std::vector<napsat::Tvar> _dirty_variables;
+    std::vector<bool> _variable_dirty;
+
+    /**
+     * @brief Clauses whose literals, watched literals or blocker changed since the last check.
+     */
+    std::vector<napsat::Tclause> _dirty_clauses;
+    std::vector<bool> _clause_dirty;
+
+    /**
+     * @brief Lowest position of the trail that changed since the last check. All the literals from
+     * this position are checked again.
+     */
+    unsigned _trail_dirty_from = 0;
+
+    /**
+     * @brief Position of each assigned variable in the trail, valid up to the last checked literal.
+     */
+    std::vector<unsigned> _trail_position;
+
+    /**
+     * @brief Clauses in which each variable occurs. Clauses are removed lazily once inactive.
+     */
+    std::vector<std::vector<clause*>> _occurrences;
+
+    /**
+     * @brief Records that the state of a variable changed since the last check.
+     */
+    void touch_variable(napsat::Tvar var);
+
+    /**
+     * @brief Records that a clause changed since the last check.
+     */
+    void touch_clause(napsat::Tclause cl);
+
+    /**
+     * @brief Records that the trail changed from the given position since the last check.
+     */
+    void touch_trail(unsigned location) { _trail_dirty_from = std::min(_trail_dirty_from, location); }
+
+    /**
+     * @brief Records that the variables implied by a clause must be checked again, e.g. because the
+     * clause was deleted or shortened.
+     */
+    void touch_implied_variables(napsat::Tclause cl);
+
+    /**
+     * @brief Adds the clause to the occurrence lists of its variables.
+     */
+    void add_occurrences(clause* c);
+
+    /**
+     * @brief Forgets the recorded changes. The next check only considers the changes made afterwards.
+     */
+    void clear_changes();
+
+    /**
+     * @brief Updates the positions of the variables assigned from the given position of the trail.
+     */
+    void update_trail_positions(unsigned from);
+
+    /**
+     * @brief Checks the enabled clause invariants (trail sanity, no missed implications and watched
+     * literals) on a single clause.
+     */
+    bool check_clause_invariants(napsat::Tclause cl);
+
+    /**
+     * @brief Checks the enabled invariants of the literal at position i of the trail that only
+     * depend on its reason (level ordering, topological order and assignment coherence).
+     * @pre _trail_position is up to date for all the literals up to position i.
+     */
+    bool check_trail_literal_invariants(unsigned i);
+
   public:
     /**
      * @brief Returns the concatenation of all error messages since the last call to this function.
@@ -548,10 +755,18 @@ namespace napsat::gui
     void load_invariant_configuration();
 
     /**
-     * @brief Checks all the enabled invariants of the observer.
+     * @brief Checks all the enabled invariants of the observer on all clauses and the whole trail.
      */
     bool check_invariants();
 
+    /**
+     * @brief Checks the enabled invariants of the observer on the clauses, variables and trail
+     * literals that changed since the last check.
+     * @details Falls back to check_invariants if the changes were not recorded, or if the full
+     * invariant check option is set.
+     */
+    bool check_invariants_incremental();
+
     /**
      * @brief If this feature is on, the observer will only check the invariants without displaying the execution.
      */
@@ -578,17 +793,32 @@ namespace napsat::gui
      */
     bool check_trail_sanity();
 
+    /**
+     * @brief Checks that the propagated literals do not falsify the clause cl.
+     */
+    bool check_trail_sanity(napsat::Tclause cl);
+
     /**
      * @brief Checks that literals in the partial assignment are implied at the correct level.
      * @details Let T be the set of propagated literals, and W be the set of literals in the propagation queue. check_propagated_literals returns true if and only if for all literal l in T union W, level(l) = max_{l' in C} level(l) where C is the reason of l.
      */
     bool check_level_ordering();
 
+    /**
+     * @brief Checks that the literal at position i of the trail is implied at the level of its reason.
+     */
+    bool check_level_ordering(unsigned i);
+
     /**
      * @brief Checks that the level of literals in the trail trail is monotonically increasing.
      * @details Let T be the set of propagated literals. check_trail_monotonicity returns true if and only if for all i in [0, |T| - 2], level(T[i]) <= level(T[i+1]).
      */
-    bool check_trail_monotonicity();
+    bool check_trail_monotonicity() { return check_trail_monotonicity(0); }
+
+    /**
+     * @brief Checks that the levels of the literals in the trail do not decrease from position from.
+     */
+    bool check_trail_monotonicity(unsigned from);
 
     /**
      * @brief Checks that no literal can be implied by a clause and propagated literals. In other words, checks that no clause is unit under the partial assignment of propagated literals unless it is satisfied by the entire assignment.
@@ -596,11 +826,23 @@ namespace napsat::gui
      */
     bool check_no_missed_implications();
 
+    /**
+     * @brief Checks that the clause cl is not unit under the propagated literals unless it is satisfied.
+     */
+    bool check_no_missed_implications(napsat::Tclause cl);
+
     /**
      * @brief Checks that the trail is a topological order of the implication graph.
      * @details Let P be the partial assignment. check_topological_order returns true if and only if for all literal i in {0, ..., |P| - 1}, for all literal l in the reason of P[i], there exists j such that P[j] = l and j < i.
      */
     bool check_topological_order();
+
+    /**
+     * @brief Checks that the literals of the reason of the literal at position i of the trail are
+     * assigned before it.
+     * @pre _trail_position is up to date.
+     */
+    bool check_topological_order(unsigned i);
 #if NOTIFY_WATCH_CHANGES
     /**
      * @brief Checks the invariants on the watched literals depending on the configuration.
@@ -608,6 +850,11 @@ namespace napsat::gui
      */
     bool check_watched_literals();
 
+    /**
+     * @brief Checks the invariants on the watched literals of the clause cl.
+     */
+    bool check_watched_literals(napsat::Tclause cl);
+
     /**
      * @brief Checks that the watched literals c₁ and c₂ satisfy the weak watched literals invariant with blocker b
      * @details ¬c₁ ∈ τ ⇒ ¬c₂ ∉ τ ∨ [b ∈ π ∧ δ(b) ≤ δ(c₂)]
@@ -644,5 +891,12 @@ namespace napsat::gui
      * Also checks that all the reasons for propagations are unisat
      */
     bool check_assignment_coherence();
+
+    /**
+     * @brief Checks that the literal at position i of the trail is assigned once, is true, and is the
+     * only literal of its reason that is not false.
+     * @pre _trail_position is up to date.
+     */
+    bool check_assignment_coherence(unsigned i);
   };
 }
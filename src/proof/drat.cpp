@@ -0,0 +1,104 @@
+/**
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/proof/drat.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the writer of DRAT proofs.
+ */
+#include "drat.hpp"
+
+#include "../utils/printer.hpp"
+
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+using namespace std;
+
+napsat::proof::drat_writer::drat_writer(const string& filename, bool binary)
+  : binary(binary)
+{
+  fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    LOG_ERROR("The proof file " << filename << " could not be opened.");
+  buffer.reserve(BUFFER_SIZE + 64);
+}
+
+void napsat::proof::drat_writer::write_lit(Tlit lit)
+{
+  if (binary) {
+    // 2|l| + (l < 0), the polarity bit of the literal is 1 for positive literals
+    unsigned value = lit ^ 1;
+    while (value > 0x7F) {
+      buffer.push_back((char) ((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    buffer.push_back((char) value);
+    return;
+  }
+  if (!lit_pol(lit))
+    buffer.push_back('-');
+  string var = to_string(lit_to_var(lit));
+  buffer.insert(buffer.end(), var.begin(), var.end());
+  buffer.push_back(' ');
+}
+
+void napsat::proof::drat_writer::write_clause(char tag, const Tlit* lits, unsigned size)
+{
+  if (binary)
+    buffer.push_back(tag);
+  else if (tag == 'd')
+    buffer.insert(buffer.end(), {'d', ' '});
+  for (unsigned i = 0; i < size; i++)
+    write_lit(lits[i]);
+  if (binary)
+    buffer.push_back(0);
+  else
+    buffer.insert(buffer.end(), {'0', '\n'});
+  if (buffer.size() >= BUFFER_SIZE)
+    flush();
+}
+
+void napsat::proof::drat_writer::add_clause(const Tlit* lits, unsigned size)
+{
+  write_clause('a', lits, size);
+}
+
+void napsat::proof::drat_writer::delete_clause(const Tlit* lits, unsigned size)
+{
+  write_clause('d', lits, size);
+}
+
+void napsat::proof::drat_writer::flush()
+{
+  if (fd < 0) {
+    buffer.clear();
+    return;
+  }
+  size_t written = 0;
+  while (written < buffer.size()) {
+    ssize_t n = write(fd, buffer.data() + written, buffer.size() - written);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0) {
+      LOG_ERROR("The proof could not be written.");
+      close(fd);
+      fd = -1;
+      break;
+    }
+    written += n;
+  }
+  buffer.clear();
+}
+
+napsat::proof::drat_writer::~drat_writer()
+{
+  flush();
+  if (fd >= 0)
+    close(fd);
+}
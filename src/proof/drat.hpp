@@ -0,0 +1,105 @@
+/**
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/proof/drat.hpp
+ * @author Robin Coutelier
+ *
+ * @brief This file is part of the NapSAT solver. It defines a writer of DRAT
+ * proofs, streamed to a file or a pipe while the solver runs.
+ *
+ * @details Unlike the resolution proof, the DRAT proof does not keep the
+ * clauses in memory. Each derived clause is written as an addition, and each
+ * deleted clause as a deletion. The derived clauses are checked by an external
+ * checker (e.g. drat-trim) with reverse unit propagation, so the resolution
+ * chains are not needed.
+ *
+ * The binary format encodes an addition as the byte 'a' and a deletion as the
+ * byte 'd', followed by the literals and a 0. A literal of DIMACS value l is
+ * written as the unsigned number 2|l| + (l < 0), in little endian base 128
+ * where the high bit of each byte is set if more bytes follow. The text format
+ * is the usual DIMACS-like format, with deletions prefixed by "d".
+ */
+#pragma once
+
+#include "SAT-types.hpp"
+
+#include <string>
+#include <vector>
+
+namespace napsat::proof
+{
+  class drat_writer
+  {
+    /**
+     * @brief File descriptor of the proof, or -1 if it could not be opened.
+     */
+    int fd = -1;
+
+    /**
+     * @brief Whether the proof is written in the binary format.
+     */
+    bool binary;
+
+    /**
+     * @brief Bytes not yet written to the file. The buffer is written when it
+     * exceeds BUFFER_SIZE bytes.
+     */
+    std::vector<char> buffer;
+
+    /**
+     * @brief Appends a literal to the buffer.
+     */
+    void write_lit(napsat::Tlit lit);
+
+    /**
+     * @brief Appends a clause to the buffer.
+     * @param tag 'a' for an addition, 'd' for a deletion.
+     */
+    void write_clause(char tag, const napsat::Tlit* lits, unsigned size);
+
+  public:
+    /**
+     * @brief Size of the blocks written to the file.
+     */
+    static const unsigned BUFFER_SIZE = 1 << 20;
+
+    /**
+     * @brief Opens the proof file. The file is truncated if it exists. Named
+     * pipes are supported.
+     * @param filename path of the proof file.
+     * @param binary whether the proof is written in the binary format.
+     */
+    drat_writer(const std::string& filename, bool binary);
+
+    /**
+     * @brief Returns true if the proof file could be opened.
+     */
+    bool is_open() const { return fd >= 0; }
+
+    /**
+     * @brief Writes the addition of a derived clause.
+     * @details The checker may use the first literal as the pivot of a RAT
+     * step.
+     */
+    void add_clause(const napsat::Tlit* lits, unsigned size);
+
+    /**
+     * @brief Writes the deletion of a clause.
+     */
+    void delete_clause(const napsat::Tlit* lits, unsigned size);
+
+    /**
+     * @brief Writes the buffered bytes to the file.
+     */
+    void flush();
+
+    /**
+     * @brief Flushes and closes the proof file.
+     */
+    ~drat_writer();
+  };
+}
@@ -23,6 +23,8 @@
 #include <cassert>
 #include <string.h>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 
@@ -71,9 +73,11 @@ void napsat::proof::resolution_proof::input_clause(napsat::Tclause id, const nap
   }
 
   c.lits = new Tlit[size];
+  clause_bytes += size * sizeof(Tlit);
   memcpy(c.lits, lits, size * sizeof(Tlit));
   // sort the literals for convenience and faster search
   sort(c.lits, c.lits + size);
+  max_lit = max(max_lit, c.lits[size - 1]);
   // remove duplicates
   unsigned j = 1;
   for (unsigned i = 1; i < size; i++)
@@ -102,122 +106,84 @@ void napsat::proof::resolution_proof::finalize_resolution(napsat::Tclause id, co
   clause &c = clauses.back();
 
   c.resolution_chain = vector<pair<Tlit, unsigned>>(current_resolution_chain);
+  clause_bytes += c.resolution_chain.capacity() * sizeof(pair<Tlit, unsigned>);
   current_resolution_chain.clear();
 
-  assert(check_resolution_chain(clauses.size() - 1));
+  assert(!check_chains || check_resolution_chain(clauses.size() - 1, tmp_lits, tmp_present));
 }
 
-static unsigned binary_search(napsat::Tlit* lits, unsigned size, napsat::Tlit lit)
+bool napsat::proof::resolution_proof::check_resolution_chain(TclauseID index, vector<Tlit>& lits, vector<char>& present) const
 {
-  unsigned left = 0;
-  unsigned right = size;
-  while (left < right) {
-    unsigned mid = left + (right - left) / 2;
-    if (lits[mid] == lit)
-      return mid;
-    if (lits[mid] < lit)
-      left = mid + 1;
-    else
-      right = mid;
-  }
-  return size;
-}
-
-static void binary_insert(vector<napsat::Tlit>& lits, napsat::Tlit lit)
-{
-  unsigned left = 0;
-  unsigned right = lits.size();
-  while (left < right) {
-    unsigned mid = left + (right - left) / 2;
-    if (lits[mid] == lit)
-      return;
-    if (lits[mid] < lit)
-      left = mid + 1;
-    else
-      right = mid;
-  }
-  lits.insert(lits.begin() + left, lit);
-}
-
-bool napsat::proof::resolution_proof::check_resolution_chain(unsigned index)
-{
-  clause &c = clauses[index];
+  const clause &c = clauses[index];
   if (c.resolution_chain.size() == 0) {
     // input clause
     return true;
   }
-  tmp_lits.clear();
+  // the negation of a pivot may be larger than any literal of the proof
+  if (present.size() <= (max_lit | 1))
+    present.resize((max_lit | 1) + 1, false);
+  lits.clear();
+  bool pivots_valid = true;
   for (pair<Tlit, unsigned> link : c.resolution_chain) {
     Tlit pivot = link.first;
     assert(link.second < clauses.size());
-    clause &cl = clauses[link.second];
-    for (unsigned i = 0; i < cl.size; i++)
-      binary_insert(tmp_lits, cl.lits[i]);
-
-    // remove duplicates
-    unsigned j = 1;
-    for (unsigned i = 1; i < tmp_lits.size(); i++)
-      if (tmp_lits[i] != tmp_lits[i-1])
-        tmp_lits[j++] = tmp_lits[i];
-
+    const clause &cl = clauses[link.second];
+    // lits may contain literals that are no longer present, they are filtered out below
+    for (unsigned i = 0; i < cl.size; i++) {
+      if (present[cl.lits[i]])
+        continue;
+      present[cl.lits[i]] = true;
+      lits.push_back(cl.lits[i]);
+    }
     if (pivot == LIT_UNDEF)
       continue;
 
-    unsigned pivot_index = binary_search(tmp_lits.data(), tmp_lits.size(), pivot);
-    assert (pivot_index != tmp_lits.size());
-    tmp_lits.erase(pivot_index + tmp_lits.begin());
-    unsigned neg_pivot_index = binary_search(tmp_lits.data(), tmp_lits.size(), lit_neg(pivot));
-    assert (neg_pivot_index != tmp_lits.size());
-    tmp_lits.erase(neg_pivot_index + tmp_lits.begin());
+    if (!present[pivot] || !present[lit_neg(pivot)]) {
+      pivots_valid = false;
+      break;
+    }
+    present[pivot] = false;
+    present[lit_neg(pivot)] = false;
   }
 
-  if(tmp_lits.size() != c.size) {
-    string error_msg = "The resolution chain does not match the clause\n";
-    error_msg += "Resolution chain:\n";
-    for (pair<Tlit, unsigned> link : c.resolution_chain) {
-      error_msg += to_string(lit_to_int(link.first)) + " -> ";
-      for (unsigned i = 0; i < clauses[link.second].size; i++)
-        error_msg += to_string(lit_to_int(clauses[link.second].lits[i])) + " ";
-      error_msg += "\n";
-    }
-    error_msg += "Actual clause (in DB): ";
-    for (unsigned i = 0; i < c.size; i++) {
-      error_msg += to_string(lit_to_int(c.lits[i])) + " ";
-    }
-    error_msg += "\n";
-    error_msg += "Expected clause (calculated): ";
-    for (Tlit lit : tmp_lits)
-      error_msg += to_string(lit_to_int(lit)) + " ";
-    error_msg += "\n";
-    LOG_ERROR(error_msg);
-    return false;
+  unsigned j = 0;
+  for (Tlit lit : lits) {
+    if (present[lit])
+      lits[j++] = lit;
+    present[lit] = false;
   }
+  lits.resize(j);
+  sort(lits.begin(), lits.end());
 
-  for (unsigned i = 0; i < c.size; i++) {
-    if (c.lits[i] != tmp_lits[i]) {
-      string error_msg = "Error: resolution chain does not match the clause\n";
-      error_msg += "Resolution chain:\n";
-      for (pair<Tlit, unsigned> link : c.resolution_chain) {
-        error_msg += to_string(lit_to_int(link.first)) + " -> ";
-        for (unsigned i = 0; i < clauses[link.second].size; i++)
-          error_msg += to_string(lit_to_int(clauses[link.second].lits[i])) + " ";
-        error_msg += "\n";
-      }
-      error_msg += "Expected clause: ";
-      for (unsigned i = 0; i < c.size; i++)
-        error_msg += to_string(lit_to_int(c.lits[i])) + " ";
-      error_msg += "\n";
-      error_msg += "Actual clause: ";
-      for (Tlit lit : tmp_lits)
-        error_msg += to_string(lit_to_int(lit)) + " ";
-      error_msg += "\n";
-      LOG_ERROR(error_msg);
-      return false;
-    }
+  if (!pivots_valid || lits.size() != c.size || !equal(lits.begin(), lits.end(), c.lits)) {
+    print_chain_error(index, lits);
+    return false;
   }
   return true;
 }
 
+void napsat::proof::resolution_proof::print_chain_error(TclauseID index, const vector<Tlit>& lits) const
+{
+  const clause &c = clauses[index];
+  string error_msg = "The resolution chain does not match the clause\n";
+  error_msg += "Resolution chain:\n";
+  for (pair<Tlit, unsigned> link : c.resolution_chain) {
+    error_msg += to_string(lit_to_int(link.first)) + " -> ";
+    for (unsigned i = 0; i < clauses[link.second].size; i++)
+      error_msg += to_string(lit_to_int(clauses[link.second].lits[i])) + " ";
+    error_msg += "\n";
+  }
+  error_msg += "Actual clause (in DB): ";
+  for (unsigned i = 0; i < c.size; i++)
+    error_msg += to_string(lit_to_int(c.lits[i])) + " ";
+  error_msg += "\n";
+  error_msg += "Expected clause (calculated): ";
+  for (Tlit lit : lits)
+    error_msg += to_string(lit_to_int(lit)) + " ";
+  error_msg += "\n";
+  LOG_ERROR(error_msg);
+}
+
 void napsat::proof::resolution_proof::root_assign(napsat::Tlit lit, napsat::Tclause reason)
 {
   root_lit.push_back(lit);
@@ -238,7 +204,8 @@ void napsat::proof::resolution_proof::remove_root_literals(napsat::Tclause id)
 
   unsigned i = root_lit.size();
   while (i > 0) {
-    while (i > 0 && find(c.lits, end, lit_neg(root_lit[i-1])) == end) // TODO can use binary search if too slow
+    // the reasons of the root literals may introduce other literals falsified at level 0
+    while (i > 0 && find(simplified_clause.begin(), simplified_clause.end(), lit_neg(root_lit[i-1])) == simplified_clause.end())
       i--;
     if (i == 0)
       break;
@@ -260,25 +227,75 @@ void napsat::proof::resolution_proof::deactivate_clause(napsat::Tclause id)
   clause_matches[id] = CLAUSE_UNDEF;
 }
 
-bool napsat::proof::resolution_proof::check_proof(void)
+napsat::proof::TclauseID napsat::proof::resolution_proof::clause_index(napsat::Tclause id) const
+{
+  assert(id < clause_matches.size());
+  assert(clause_matches[id] != CLAUSE_UNDEF);
+  return clause_matches[id];
+}
+
+void napsat::proof::resolution_proof::reactivate_clause(napsat::Tclause id, TclauseID index)
+{
+  assert(index < clauses.size());
+  if (id >= clause_matches.size()) {
+    clause_matches.reserve(2 * id + 1);
+    clause_matches.resize(id + 1, CLAUSE_UNDEF);
+  }
+  assert(clause_matches[id] == CLAUSE_UNDEF);
+  clause_matches[id] = index;
+}
+
+bool napsat::proof::resolution_proof::check_proof(unsigned n_threads)
 {
   assert(empty_clause_id != CLAUSE_UNDEF);
-  vector<unsigned> clauses_to_check;
+  // collect the clauses used to derive the empty clause. Most learned clauses are not
+  vector<TclauseID> clauses_to_check;
   clauses_to_check.push_back(empty_clause_id);
-  while(!clauses_to_check.empty()) {
-    unsigned index = clauses_to_check.back();
-    clauses[index].marked = true;
-    clauses_to_check.pop_back();
-    if (!check_resolution_chain(index))
-      return false;
-    clause &c = clauses[index];
-    for (pair<Tlit, unsigned> link : c.resolution_chain)
-      if (!clauses[link.second].marked)
-        clauses_to_check.push_back(link.second);
+  clauses[empty_clause_id].marked = true;
+  for (unsigned i = 0; i < clauses_to_check.size(); i++) {
+    for (pair<Tlit, unsigned> link : clauses[clauses_to_check[i]].resolution_chain) {
+      if (clauses[link.second].marked)
+        continue;
+      clauses[link.second].marked = true;
+      clauses_to_check.push_back(link.second);
+    }
   }
-  for (unsigned i = 0; i < clauses.size(); i++)
-    clauses[i].marked = false;
-  return true;
+  for (TclauseID index : clauses_to_check)
+    clauses[index].marked = false;
+
+  if (n_threads == 0)
+    n_threads = max(thread::hardware_concurrency(), 1u);
+  // the threads take the chains by blocks, to limit the contention on the counter
+  const unsigned BLOCK_SIZE = 256;
+  n_threads = min<size_t>(n_threads, clauses_to_check.size() / BLOCK_SIZE + 1);
+  atomic<unsigned> next(0);
+  atomic<bool> valid(true);
+  auto check_blocks = [&](vector<Tlit>& lits, vector<char>& present) {
+    while (valid) {
+      unsigned begin = next.fetch_add(BLOCK_SIZE);
+      if (begin >= clauses_to_check.size())
+        return;
+      unsigned end = min<size_t>(begin + BLOCK_SIZE, clauses_to_check.size());
+      for (unsigned i = begin; i < end; i++) {
+        if (!check_resolution_chain(clauses_to_check[i], lits, present)) {
+          valid = false;
+          return;
+        }
+      }
+    }
+  };
+  vector<thread> threads;
+  for (unsigned i = 1; i < n_threads; i++) {
+    threads.emplace_back([&] {
+      vector<Tlit> lits;
+      vector<char> present;
+      check_blocks(lits, present);
+    });
+  }
+  check_blocks(tmp_lits, tmp_present);
+  for (thread& t : threads)
+    t.join();
+  return valid;
 }
 
 void napsat::proof::resolution_proof::print_clause(unsigned index)
@@ -373,6 +390,14 @@ void napsat::proof::resolution_proof::print_clause_set(void)
   }
 }
 
+size_t napsat::proof::resolution_proof::memory_size(void) const
+{
+  return clause_bytes
+    + clauses.capacity() * sizeof(clause)
+    + clause_matches.capacity() * sizeof(TclauseID)
+    + (root_lit.capacity() + root_reason.capacity()) * sizeof(Tlit);
+}
+
 napsat::proof::resolution_proof::~resolution_proof()
 {
   for (clause c : clauses)
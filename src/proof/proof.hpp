@@ -107,11 +107,34 @@ namespace napsat::proof
      * reason at position i in the root_reason vector. */
     std::vector<napsat::Tclause> root_reason;
 
+    /**
+     * @brief Largest literal appearing in the proof. It bounds the size of
+     * the literal markers used in check_resolution_chain.
+     */
+    napsat::Tlit max_lit = 0;
+
+    /**
+     * @brief If true, each resolution chain is checked when it is finalized,
+     * in debug builds.
+     */
+    bool check_chains;
+
     /**
      * @brief Temporary vector used in check_resolution_chain
      */
     std::vector<Tlit> tmp_lits;
 
+    /**
+     * @brief Temporary literal markers used in check_resolution_chain
+     */
+    std::vector<char> tmp_present;
+
+    /**
+     * @brief Number of bytes allocated for the literals and the resolution
+     * chains of the clauses.
+     */
+    size_t clause_bytes = 0;
+
     /**
      * @brief Applies the resolution rule in place on the base clause with the
      * resolvent clause over the literal pivot.
@@ -131,10 +154,22 @@ namespace napsat::proof
     /**
      * @brief Check the resolution chain of the clause id.
      * @param id The clause ID to check.
+     * @param lits Scratch vector receiving the literals of the resolvent.
+     * @param present Scratch markers, indexed by literals. They must be all
+     * cleared, and are cleared again on return.
      * @return True if the resolution chain is correct, false if applying the
      * resolution chain yields different literals than the clause.
+     * @details The function only reads the clauses, such that several chains
+     * can be checked concurrently with different scratch vectors.
      */
-    bool check_resolution_chain(TclauseID id);
+    bool check_resolution_chain(TclauseID id, std::vector<Tlit>& lits, std::vector<char>& present) const;
+
+    /**
+     * @brief Prints an error message for the resolution chain of the clause
+     * id, which resolves to the literals lits instead of the literals of the
+     * clause.
+     */
+    void print_chain_error(TclauseID id, const std::vector<Tlit>& lits) const;
 
     /**
      * @brief Print the clause with the given index.
@@ -156,7 +191,12 @@ namespace napsat::proof
     public:
     /**
      * @brief Construct a new resolution_proof object */
-    resolution_proof(void) = default;
+    /**
+     * @param check_chains if true, each resolution chain is checked when it
+     * is finalized, in debug builds. It is false only to test the checker on
+     * invalid proofs, which would otherwise fail an assertion.
+     */
+    explicit resolution_proof(bool check_chains = true) : check_chains(check_chains) {}
 
     /**
      * @brief Add an input clause to the proof.
@@ -232,12 +272,37 @@ namespace napsat::proof
      */
     void deactivate_clause(napsat::Tclause id);
 
+    /**
+     * @brief Returns the internal ID of a clause, such that the clause can be
+     * reactivated after being deactivated.
+     * @param id The clause ID provided by the solver.
+     * @pre The clause must not be deactivated.
+     */
+    TclauseID clause_index(napsat::Tclause id) const;
+
+    /**
+     * @brief Makes a deactivated clause accessible again, under a new clause
+     * ID.
+     * @details This is used to restore a clause removed from the clause set,
+     * without having to justify it again.
+     * @param id The new clause ID provided by the solver.
+     * @param index The internal ID of the clause, given by clause_index.
+     * @pre The clause id must not be currently in use.
+     */
+    void reactivate_clause(napsat::Tclause id, TclauseID index);
+
     /**
      * @brief Check the proof if the empty clause is present.
      * If the proof is incorrect, an error message is printed.
+     * @details The proof is checked backward: only the clauses reachable from
+     * the empty clause through the resolution chains are checked. Since each
+     * chain is checked against the clauses as stored, the chains are
+     * independent and are distributed among n_threads threads.
+     * @param n_threads The number of threads. If 0, one thread per hardware
+     * thread is used.
      * @return True if the proof is correct, false otherwise.
      */
-    bool check_proof(void);
+    bool check_proof(unsigned n_threads = 1);
 
     /**
      * Prints a resolution chain leading to the clause with the given index.
@@ -252,6 +317,12 @@ namespace napsat::proof
      */
     void print_proof(void);
 
+    /**
+     * @brief Returns the number of bytes held by the proof. The clauses of
+     * the proof are never freed, so the memory only grows.
+     */
+    size_t memory_size(void) const;
+
     /**
      * @brief Destroy the resolution_proof object
      */
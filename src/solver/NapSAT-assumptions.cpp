@@ -0,0 +1,95 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-assumptions.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the incremental interface of the NapSAT
+ * solver, that is, solving under assumptions and computing the failed assumptions.
+ * @details The assumptions are decided before any other decision, each at its own decision level. An
+ * assumption that is already satisfied does not open a level, since in chronological backtracking, levels
+ * are not required to follow the order of the trail. The clauses learned under assumptions do not depend
+ * on the assumptions, so they are kept for the next calls.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+
+using namespace std;
+
+bool napsat::NapSAT::decide_assumption()
+{
+  if (assumptions_satisfied())
+    return false;
+  Tlit lit = _assumptions[_assumption_index];
+  if (lit_false(lit)) {
+    analyze_final(lit);
+    _status = UNSAT;
+    return true;
+  }
+  ASSERT(lit_undef(lit));
+  _assumption_index++;
+  decide(lit);
+  return true;
+}
+
+void napsat::NapSAT::analyze_final(Tlit lit)
+{
+  ASSERT(lit_false(lit));
+  _failed_assumptions.clear();
+  _failed_assumptions.push_back(lit);
+  if (lit_level(lit) == LEVEL_ROOT)
+    return;
+  vector<Tlit> stack;
+  vector<Tvar> marked;
+  stack.push_back(lit_neg(lit));
+  lit_mark_seen(lit);
+  marked.push_back(lit_to_var(lit));
+  while (!stack.empty()) {
+    Tlit implied = stack.back();
+    stack.pop_back();
+    ASSERT(lit_true(implied));
+    Tclause reason = lit_reason(implied);
+    if (reason == CLAUSE_LAZY && _theory_reasons[lit_to_var(implied)].propagator != PROPAGATOR_UNDEF)
+      reason = theory_reason(implied);
+    if (reason == CLAUSE_UNDEF || reason == CLAUSE_LAZY) {
+      // only the assumptions are decided before all assumptions are satisfied
+      _failed_assumptions.push_back(implied);
+      continue;
+    }
+    TSclause& clause = _clauses[reason];
+    for (unsigned i = 0; i < clause.size; i++) {
+      Tlit other = clause.lits()[i];
+      if (lit_to_var(other) == lit_to_var(implied) || lit_seen(other) || lit_level(other) == LEVEL_ROOT)
+        continue;
+      ASSERT(lit_false(other));
+      lit_mark_seen(other);
+      marked.push_back(lit_to_var(other));
+      stack.push_back(lit_neg(other));
+    }
+  }
+  for (Tvar var : marked)
+    _vars[var].seen = false;
+}
+
+void napsat::NapSAT::reset_search()
+{
+  if (_assumptions.empty() && _status != SAT)
+    return;
+  _assumptions.clear();
+  _assumption_index = 0;
+  // the clause set is unsatisfiable, whatever the assumptions
+  if (_status == ERROR || (_status == UNSAT && _failed_assumptions.empty()))
+    return;
+  _failed_assumptions.clear();
+  backtrack(LEVEL_ROOT);
+  _status = UNDEF;
+}
+
+const std::vector<napsat::Tlit>& napsat::NapSAT::failed_assumptions() const
+{
+  return _failed_assumptions;
+}
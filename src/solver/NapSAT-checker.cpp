@@ -60,19 +60,20 @@ bool napsat::NapSAT::is_watched(Tlit lit, Tclause cl)
         return true;
     return false;
   }
-  vector<Tclause>& watch_list = _watch_lists[lit];
-  return find(watch_list.begin(), watch_list.end(), cl) != watch_list.end();
+  vector<TSwatch>& watch_list = _watch_lists[lit];
+  return find_if(watch_list.begin(), watch_list.end(),
+    [cl](const TSwatch& watch) { return watch.cl == cl; }) != watch_list.end();
 }
 
 bool napsat::NapSAT::watch_lists_complete()
 {
   bool success = true;
   for (Tclause cl = 0; cl < _clauses.size(); cl++) {
-    TSclause clause = _clauses[cl];
+    const TSclause& clause = _clauses[cl];
     if (clause.size < 2 || !clause.watched || clause.deleted)
       continue;
     for (unsigned i = 0; i < 2; i++) {
-      Tlit lit = clause.lits[i];
+      Tlit lit = clause.lits()[i];
       if (!is_watched(lit, cl)) {
         success = false;
         LOG_ERROR("Invariant violation: " << clause_to_string(cl) << " is not in the watch list of its watched literal " << lit_to_string(lit));
@@ -86,8 +87,9 @@ bool napsat::NapSAT::watch_lists_minimal()
 {
   bool success = true;
   for (Tlit lit = 0; lit < _watch_lists.size(); lit++) {
-    for (Tclause cl : _watch_lists[lit]) {
-      TSclause clause = _clauses[cl];
+    for (TSwatch watch : _watch_lists[lit]) {
+      Tclause cl = watch.cl;
+      const TSclause& clause = _clauses[cl];
       if (clause.size < 2) {
         success = false;
         LOG_ERROR("Invariant violation: " << clause_to_string(cl) << " is in the watch list of literal " << lit_to_string(lit) << " but it is too small");
@@ -102,7 +104,7 @@ bool napsat::NapSAT::watch_lists_minimal()
         LOG_ERROR("Invariant violation: " << clause_to_string(cl) << " is in the watch list of literal " << lit_to_string(lit) << " but it is not a watched clause");
       }
 
-      if (lit != clause.lits[0] && lit != clause.lits[1]) {
+      if (lit != clause.lits()[0] && lit != clause.lits()[1]) {
         success = false;
         LOG_ERROR("Invariant violation: " << clause_to_string(cl) << " is in the watch list of literal " << lit_to_string(lit) << " but it is not a watched literal");
       }
@@ -113,7 +115,8 @@ bool napsat::NapSAT::watch_lists_minimal()
   std::unordered_set<Tclause> seen_clauses;
   for (Tlit lit = 0; lit < _watch_lists.size(); lit++) {
     seen_clauses.clear();
-    for (Tclause cl : _watch_lists[lit]) {
+    for (TSwatch watch : _watch_lists[lit]) {
+      Tclause cl = watch.cl;
       if (seen_clauses.find(cl) != seen_clauses.end()) {
         success = false;
         LOG_ERROR("Invariant violation: " << clause_to_string(cl) << " is in the watch list of literal " << lit << " multiple times");
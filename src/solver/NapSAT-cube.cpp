@@ -0,0 +1,218 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-cube.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the cube phase of cube-and-conquer, that
+ * is, the split of the clause set into cubes by a lookahead, and the output of the cubes in the iCNF
+ * format.
+ * @details The split reuses the decisions, the propagation and the backtracking of the search. At each
+ * node, the candidate variables are decided in both polarities and propagated without repairing the
+ * conflicts, and the number of literals assigned measures the gain of each branch. The variable with the
+ * highest product of the gains of its two branches is branched on, such that both branches are
+ * simplified. The conquer phase solves the clause set under one cube, with the cube as assumptions.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+#include "../utils/printer.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+
+bool napsat::NapSAT::lookahead(Tlit lit, unsigned& gain)
+{
+  ASSERT(lit_undef(lit));
+  ASSERT(_propagated_literals == _trail.size());
+  Tlevel level = solver_level();
+  unsigned size = _trail.size();
+  unsigned long propagations = 0;
+  imply_literal(lit, CLAUSE_UNDEF);
+  bool conflict = vivification_propagate(propagations) != CLAUSE_UNDEF;
+  gain = _trail.size() - size;
+  backtrack(level);
+  return !conflict;
+}
+
+void napsat::NapSAT::split_cube(unsigned depth)
+{
+  Tlevel level = solver_level();
+  unsigned cube_size = _cube_literals.size();
+  unsigned long propagations = 0;
+  while (true) {
+    if (depth == 0 || _trail.size() + _eliminated_vars.size() == _vars.size() - 1 || termination_requested()) {
+      _cubes.push_back(_cube_literals);
+      break;
+    }
+    Tvar best = 0;
+    unsigned long best_score = 0;
+    Tlit forced = LIT_UNDEF;
+    bool refuted = false;
+    unsigned candidates = 0;
+    for (Tvar var : _lookahead_order) {
+      if (candidates == _options.lookahead_candidates)
+        break;
+      if (!var_undef(var))
+        continue;
+      candidates++;
+      unsigned positive_gain;
+      unsigned negative_gain;
+      bool positive = lookahead(literal(var, true), positive_gain);
+      // in chronological backtracking, the missed lower implications found by the lookahead stay assigned
+      refuted = vivification_propagate(propagations) != CLAUSE_UNDEF;
+      if (refuted || !positive) {
+        forced = literal(var, false);
+        break;
+      }
+      if (!var_undef(var))
+        continue;
+      bool negative = lookahead(literal(var, false), negative_gain);
+      refuted = vivification_propagate(propagations) != CLAUSE_UNDEF;
+      if (refuted || !negative) {
+        forced = literal(var, true);
+        break;
+      }
+      // the product favors the variables simplifying both branches
+      unsigned long score = (unsigned long) positive_gain * negative_gain + positive_gain + negative_gain;
+      if (best == 0 || score > best_score) {
+        best = var;
+        best_score = score;
+      }
+    }
+    if (refuted || (forced != LIT_UNDEF && lit_false(forced)))
+      break;
+    if (forced != LIT_UNDEF) {
+      // the other polarity is refuted by propagation, such that the models of the node satisfy forced
+      if (lit_undef(forced)) {
+        imply_literal(forced, CLAUSE_UNDEF);
+        _cube_literals.push_back(forced);
+        if (vivification_propagate(propagations) != CLAUSE_UNDEF)
+          break;
+      }
+      continue;
+    }
+    if (best == 0) {
+      // the remaining variables are eliminated
+      _cubes.push_back(_cube_literals);
+      break;
+    }
+    for (Tlit lit : {literal(best, true), literal(best, false)}) {
+      // a missed lower implication found in the first branch may already decide the second one
+      if (lit_false(lit))
+        continue;
+      bool decided = lit_undef(lit);
+      if (decided)
+        imply_literal(lit, CLAUSE_UNDEF);
+      if (vivification_propagate(propagations) == CLAUSE_UNDEF) {
+        if (decided)
+          _cube_literals.push_back(lit);
+        split_cube(depth - 1);
+        if (decided)
+          _cube_literals.pop_back();
+      }
+      backtrack(level);
+      if (vivification_propagate(propagations) != CLAUSE_UNDEF)
+        break;
+    }
+    break;
+  }
+  _cube_literals.resize(cube_size);
+  backtrack(level);
+}
+
+napsat::status napsat::NapSAT::cube(unsigned n)
+{
+  ASSERT(n > 0);
+  reset_search();
+  _cubes.clear();
+  if (_status != UNDEF)
+    return _status;
+  // the decisions taken through the interface would be mistaken for cube literals
+  backtrack(LEVEL_ROOT);
+  // the conflicts at level 0 are repaired as in the search, which may conclude
+  if (!propagate())
+    return _status;
+  utils::profiler::scope timer(_profiler, utils::PHASE_CUBE);
+
+  vector<unsigned> occurrences(_vars.size(), 0);
+  for (Tclause cl = 0; cl < _clauses.size(); cl++) {
+    TSclause& clause = _clauses[cl];
+    if (clause.deleted)
+      continue;
+    for (unsigned i = 0; i < clause.size; i++)
+      occurrences[lit_to_var(clause.lits()[i])]++;
+  }
+  _lookahead_order.clear();
+  for (Tvar var = 1; var < _vars.size(); var++)
+    if (!_vars[var].eliminated && occurrences[var] > 0)
+      _lookahead_order.push_back(var);
+  stable_sort(_lookahead_order.begin(), _lookahead_order.end(), [&occurrences](Tvar a, Tvar b) {
+    return occurrences[a] > occurrences[b];
+  });
+
+  // the lookahead decisions are not assignments found by the search
+  vector<bool> phases(_vars.size());
+  for (Tvar var = 1; var < _vars.size(); var++)
+    phases[var] = _vars[var].phase_cache;
+  double agility = _agility;
+  _phase_saving_suspended = true;
+
+  unsigned depth = 0;
+  while ((1ul << depth) < n)
+    depth++;
+  _cube_literals.clear();
+  split_cube(depth);
+  ASSERT(solver_level() == LEVEL_ROOT);
+
+  for (Tvar var = 1; var < _vars.size(); var++)
+    _vars[var].phase_cache = phases[var];
+  _phase_saving_suspended = false;
+  _agility = agility;
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Cubes built"));
+  if (!_cubes.empty())
+    return UNDEF;
+  // the refutation by the lookahead is not in the proof, the search has to build it
+  if (!_proof && !_drat)
+    _status = UNSAT;
+  return UNSAT;
+}
+
+const vector<vector<napsat::Tlit>>& napsat::NapSAT::cubes() const
+{
+  return _cubes;
+}
+
+bool napsat::NapSAT::write_icnf(const char* filename)
+{
+  ofstream file(filename);
+  if (!file.is_open()) {
+    LOG_ERROR("The file " << filename << " could not be opened.");
+    return false;
+  }
+  file << "p inccnf\n";
+  for (Tlit lit : _trail)
+    if (lit_level(lit) == LEVEL_ROOT)
+      file << lit_to_int(lit) << " 0\n";
+  for (Tclause cl = 0; cl < _clauses.size(); cl++) {
+    TSclause& clause = _clauses[cl];
+    if (clause.deleted || clause.learned || clause.size < 2)
+      continue;
+    for (unsigned i = 0; i < clause.size; i++)
+      file << lit_to_int(clause.lits()[i]) << " ";
+    file << "0\n";
+  }
+  for (vector<Tlit>& cube : _cubes) {
+    file << "a ";
+    for (Tlit lit : cube)
+      file << lit_to_int(lit) << " ";
+    file << "0\n";
+  }
+  file.close();
+  return !file.fail();
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-memory.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the estimation of the memory held by the
+ * solver, and the reductions of the clause set when the memory usage gets close to the memory limit.
+ * @details The estimation counts the capacities of the main containers of each data structure. It is
+ * linear in the number of literals and clauses, hence it only runs every MEMORY_CHECK_INTERVAL conflicts.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+
+using namespace std;
+
+napsat::memory_usage napsat::NapSAT::get_memory_usage() const
+{
+  memory_usage usage;
+  usage.clauses = _clauses.memory_bytes();
+  usage.clauses += _activities.capacity() * sizeof(double);
+  usage.clauses += _vivified.capacity() / 8;
+  usage.clauses += _deleted_clauses.capacity() * sizeof(Tclause);
+
+  usage.watches = _watch_lists.capacity() * sizeof(vector<TSwatch>);
+  for (const vector<TSwatch>& watch_list : _watch_lists)
+    usage.watches += watch_list.capacity() * sizeof(TSwatch);
+  usage.watches += _watch_list_dirty.capacity() / 8;
+  usage.watches += _dirty_watch_lists.capacity() * sizeof(Tlit);
+
+  usage.binaries = _binary_clauses.capacity() * sizeof(vector<pair<Tlit, Tclause>>);
+  for (const vector<pair<Tlit, Tclause>>& binary_list : _binary_clauses)
+    usage.binaries += binary_list.capacity() * sizeof(pair<Tlit, Tclause>);
+
+  usage.variables = _vars.capacity() * sizeof(TSvar);
+  usage.variables += _lit_values.capacity() * sizeof(uint8_t);
+  usage.variables += _levels.capacity() * sizeof(Tlevel);
+  usage.variables += _trail.capacity() * sizeof(Tlit);
+  usage.variables += (_target_phase.capacity() + _best_phase.capacity()) * sizeof(uint8_t);
+  usage.variables += _original_phase.capacity() * sizeof(uint8_t);
+  usage.variables += _theory_reasons.capacity() * sizeof(TStheory_reason);
+  usage.variables += _literal_buffer_size * sizeof(Tlit);
+
+  usage.propagators = 0;
+  for (const propagator* p : _propagators)
+    usage.propagators += p->memory_size();
+
+  usage.proof = _proof ? _proof->memory_size() : 0;
+
+  usage.observer = 0;
+#if USE_OBSERVER
+  if (_observer)
+    usage.observer = _observer->memory_size();
+#endif
+
+  usage.total = usage.clauses + usage.watches + usage.binaries + usage.variables
+              + usage.propagators + usage.proof + usage.observer;
+  return usage;
+}
+
+void napsat::NapSAT::check_memory_budget()
+{
+  ASSERT(_options.memory_limit > 0);
+  _next_memory_check = _stats.conflicts + MEMORY_CHECK_INTERVAL;
+  size_t limit = (size_t) _options.memory_limit << 10;
+  _memory_pressure = get_memory_usage().total >= limit / 10 * 9;
+  if (!_memory_pressure)
+    return;
+  _stats.memory_reductions++;
+  // the tier 2 shrinks first, such that the core clauses are demoted last
+  if (_options.tier2_lbd > _options.core_lbd)
+    _options.tier2_lbd--;
+  else if (_options.core_lbd > 1) {
+    _options.core_lbd--;
+    _options.tier2_lbd--;
+  }
+  simplify_clause_set();
+  for (vector<pair<Tlit, Tclause>>& binary_list : _binary_clauses)
+    binary_list.shrink_to_fit();
+  for (vector<TSwatch>& watch_list : _watch_lists)
+    watch_list.shrink_to_fit();
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Memory budget reached"));
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-phases.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the target and best phases, and the
+ * rephasing schedule.
+ * @details The polarity of a decision is the target phase of the variable, that is, its value in the
+ * longest conflict-free trail since the last rephasing. Variables that were not on that trail are decided
+ * with their last value. The rephasing periodically overwrites both with one of the original, inverted,
+ * best or random phases, such that the search can leave a region of the search space where it does not
+ * make progress.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+
+using namespace std;
+
+/**
+ * @brief Phases used by the successive rephasings, in a cycle.
+ */
+enum rephase_kind
+{
+  REPHASE_BEST,
+  REPHASE_ORIGINAL,
+  REPHASE_INVERTED,
+  REPHASE_RANDOM
+};
+
+static const rephase_kind REPHASE_SCHEDULE[] = {
+  REPHASE_BEST, REPHASE_ORIGINAL, REPHASE_BEST, REPHASE_INVERTED, REPHASE_BEST, REPHASE_RANDOM
+};
+
+static const unsigned REPHASE_SCHEDULE_SIZE = sizeof(REPHASE_SCHEDULE) / sizeof(REPHASE_SCHEDULE[0]);
+
+void napsat::NapSAT::save_phases()
+{
+  unsigned size = _trail.size();
+  if (size > _target_trail_size) {
+    _target_trail_size = size;
+    for (Tlit lit : _trail)
+      _target_phase[lit_to_var(lit)] = lit_pol(lit);
+  }
+  if (size > _best_trail_size) {
+    _best_trail_size = size;
+    for (Tlit lit : _trail)
+      _best_phase[lit_to_var(lit)] = lit_pol(lit);
+  }
+}
+
+void napsat::NapSAT::rephase()
+{
+  rephase_kind kind = REPHASE_SCHEDULE[_stats.rephases % REPHASE_SCHEDULE_SIZE];
+  _stats.rephases++;
+  _next_rephase = _stats.conflicts + (_stats.rephases + 1) * _options.rephase_interval;
+  for (Tvar var = 1; var < _vars.size(); var++) {
+    TSvar& svar = _vars[var];
+    switch (kind) {
+    case REPHASE_BEST:
+      if (_best_phase[var] != VAR_UNDEF)
+        svar.phase_cache = _best_phase[var];
+      break;
+    case REPHASE_ORIGINAL:
+      svar.phase_cache = _original_phase[var];
+      break;
+    case REPHASE_INVERTED:
+      svar.phase_cache = !_original_phase[var];
+      break;
+    default:
+      ASSERT(kind == REPHASE_RANDOM);
+      svar.phase_cache = _random() & 1;
+    }
+    // the target phases start again from the new phases
+    _target_phase[var] = VAR_UNDEF;
+  }
+  _target_trail_size = 0;
+  if (kind == REPHASE_BEST)
+    _best_trail_size = 0;
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Rephase"));
+}
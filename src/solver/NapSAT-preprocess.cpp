@@ -0,0 +1,418 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-preprocess.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the preprocessing of the clause set, run at
+ * the beginning of the first search.
+ * @details The preprocessing works on occurrence lists of the irredundant clauses. Backward subsumption
+ * removes the clauses subsumed by another clause, and self-subsuming resolution removes a literal ℓ from a
+ * clause D when a clause C contains ¬ℓ and the other literals of C are in D. Bounded variable elimination
+ * replaces the clauses of a variable by their resolvents on that variable, as long as it does not increase
+ * the number of clauses. The clauses of the eliminated variables are kept to reconstruct the model, and to
+ * restore the variables if they are used again by the incremental interface.
+ * @details The clauses are never modified in place. A strengthened clause or a resolvent is added as a new
+ * clause, justified in the proof by a resolution between its two parents, and the clauses it replaces are
+ * deleted.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Clauses whose literals all occur in more than this number of clauses are not used to subsume
+ * other clauses.
+ */
+static const unsigned SUBSUMPTION_MAX_OCCURRENCES = 1000;
+
+/**
+ * @brief Returns the bit of the variable in the signature of a clause.
+ */
+static inline uint64_t var_signature(napsat::Tvar var)
+{
+  return 1ull << (var & 63);
+}
+
+void napsat::NapSAT::attach_occurrences(Tclause cl)
+{
+  const TSclause& clause = _clauses[cl];
+  uint64_t signature = 0;
+  for (unsigned i = 0; i < clause.size; i++) {
+    _occurrences[clause.lits()[i]].push_back(cl);
+    signature |= var_signature(lit_to_var(clause.lits()[i]));
+  }
+  if (_signatures.size() <= cl)
+    _signatures.resize(cl + 1, 0);
+  _signatures[cl] = signature;
+  _subsumption_queue.push_back(cl);
+}
+
+void napsat::NapSAT::clean_occurrences(Tlit lit)
+{
+  vector<Tclause>& occurrences = _occurrences[lit];
+  unsigned j = 0;
+  for (Tclause cl : occurrences)
+    if (!_clauses[cl].deleted)
+      occurrences[j++] = cl;
+  occurrences.resize(j);
+}
+
+bool napsat::NapSAT::resolve(Tclause first, Tlit pivot, Tclause second)
+{
+  _resolvent.clear();
+  const TSclause& clause1 = _clauses[first];
+  const TSclause& clause2 = _clauses[second];
+  for (unsigned i = 0; i < clause1.size; i++) {
+    Tlit lit = clause1.lits()[i];
+    if (lit == pivot)
+      continue;
+    _lit_marks[lit] = true;
+    _resolvent.push_back(lit);
+  }
+  bool tautology = false;
+  for (unsigned i = 0; i < clause2.size; i++) {
+    Tlit lit = clause2.lits()[i];
+    if (lit == lit_neg(pivot) || _lit_marks[lit])
+      continue;
+    if (_lit_marks[lit_neg(lit)]) {
+      tautology = true;
+      break;
+    }
+    _resolvent.push_back(lit);
+  }
+  for (unsigned i = 0; i < clause1.size; i++)
+    _lit_marks[clause1.lits()[i]] = false;
+  return !tautology;
+}
+
+void napsat::NapSAT::add_resolvent(Tclause first, Tlit pivot, Tclause second)
+{
+  ASSERT(solver_level() == LEVEL_ROOT);
+  // literals may have been implied at level 0 by the previous resolvents
+  for (Tlit lit : _resolvent)
+    if (lit_true(lit))
+      return;
+  unsigned size = _resolvent.size();
+  for (unsigned i = 0; i < size;) {
+    if (lit_false(_resolvent[i]))
+      swap(_resolvent[i], _resolvent[--size]);
+    else
+      i++;
+  }
+  if (_proof) {
+    _proof->start_resolution_chain();
+    _proof->link_resolution(LIT_UNDEF, first);
+    _proof->link_resolution(pivot, second);
+    if (size < _resolvent.size())
+      prove_root_literal_removal(_resolvent.data() + size, _resolvent.size() - size);
+  }
+  Tclause cl = internal_add_clause(_resolvent.data(), size, false, false);
+  ASSERT(cl != CLAUSE_UNDEF);
+  if (_proof)
+    _proof->finalize_resolution(cl, _resolvent.data(), size);
+  if (size >= 2)
+    attach_occurrences(cl);
+}
+
+void napsat::NapSAT::subsume_clauses()
+{
+  for (unsigned q = 0; q < _subsumption_queue.size() && _status != UNSAT; q++) {
+    Tclause cl = _subsumption_queue[q];
+    if (_clauses[cl].deleted)
+      continue;
+    // the candidates are the clauses containing the literal of cl with the fewest occurrences, or its negation
+    unsigned size = _clauses[cl].size;
+    Tlit best = LIT_UNDEF;
+    size_t best_occurrences = SUBSUMPTION_MAX_OCCURRENCES + 1;
+    for (unsigned i = 0; i < size; i++) {
+      Tlit lit = _clauses[cl].lits()[i];
+      size_t occurrences = _occurrences[lit].size() + _occurrences[lit_neg(lit)].size();
+      if (occurrences < best_occurrences) {
+        best = lit;
+        best_occurrences = occurrences;
+      }
+    }
+    if (best == LIT_UNDEF)
+      continue;
+    for (unsigned i = 0; i < size; i++)
+      _lit_marks[_clauses[cl].lits()[i]] = true;
+
+    for (Tlit lit : {best, lit_neg(best)}) {
+      // adding a strengthened clause may extend the list, so it is accessed by index
+      for (unsigned i = 0; i < _occurrences[lit].size(); i++) {
+        Tclause other = _occurrences[lit][i];
+        if (other == cl || _clauses[other].deleted || _clauses[other].size < size)
+          continue;
+        if (_signatures[cl] & ~_signatures[other])
+          continue;
+        unsigned found = 0;
+        Tlit negated = LIT_UNDEF;
+        const TSclause& clause = _clauses[other];
+        for (unsigned j = 0; j < clause.size; j++) {
+          Tlit lit_other = clause.lits()[j];
+          if (_lit_marks[lit_other])
+            found++;
+          else if (_lit_marks[lit_neg(lit_other)] && negated == LIT_UNDEF) {
+            negated = lit_other;
+            found++;
+          }
+        }
+        if (found < size || is_protected(other))
+          continue;
+        if (negated == LIT_UNDEF) {
+          delete_clause(other);
+          _stats.subsumed_clauses++;
+          continue;
+        }
+        // other \ {negated} is the resolvent of other and cl
+        _resolvent.clear();
+        for (unsigned j = 0; j < clause.size; j++)
+          if (clause.lits()[j] != negated)
+            _resolvent.push_back(clause.lits()[j]);
+        add_resolvent(other, negated, cl);
+        delete_clause(other);
+        _stats.strengthened_clauses++;
+        if (_status == UNSAT)
+          break;
+      }
+    }
+    for (unsigned i = 0; i < size; i++)
+      _lit_marks[_clauses[cl].lits()[i]] = false;
+  }
+  _subsumption_queue.clear();
+}
+
+bool napsat::NapSAT::eliminate_variable(Tvar var)
+{
+  ASSERT(var_undef(var));
+  Tlit pos = literal(var, 1);
+  Tlit neg = literal(var, 0);
+  clean_occurrences(pos);
+  clean_occurrences(neg);
+  // the resolvents do not contain var, so the lists are not modified until the clauses are deleted
+  const vector<Tclause>& positive = _occurrences[pos];
+  const vector<Tclause>& negative = _occurrences[neg];
+  if (positive.empty() && negative.empty())
+    return false;
+  if (positive.size() > _options.elim_max_occurrences || negative.size() > _options.elim_max_occurrences)
+    return false;
+
+  unsigned n_resolvents = 0;
+  for (Tclause cl1 : positive)
+    for (Tclause cl2 : negative) {
+      if (!resolve(cl1, pos, cl2))
+        continue;
+      if (_resolvent.size() > _options.elim_max_resolvent_size)
+        return false;
+      if (++n_resolvents > positive.size() + negative.size())
+        return false;
+    }
+
+  for (Tclause cl1 : positive)
+    for (Tclause cl2 : negative) {
+      if (_status == UNSAT)
+        return true;
+      if (resolve(cl1, pos, cl2))
+        add_resolvent(cl1, pos, cl2);
+    }
+
+  // keep the clauses for the reconstruction, with the literal of var first
+  for (Tlit lit : {pos, neg}) {
+    for (Tclause cl : _occurrences[lit]) {
+      ASSERT(!is_protected(cl));
+      TSreconstruction reconstruction;
+      reconstruction.begin = _reconstruction_literals.size();
+      reconstruction.size = _clauses[cl].size;
+      reconstruction.proof_id = _proof ? _proof->clause_index(cl) : 0;
+      _reconstruction_clauses.push_back(reconstruction);
+      _reconstruction_literals.push_back(lit);
+      for (unsigned i = 0; i < _clauses[cl].size; i++)
+        if (_clauses[cl].lits()[i] != lit)
+          _reconstruction_literals.push_back(_clauses[cl].lits()[i]);
+      delete_clause(cl);
+    }
+    _occurrences[lit].clear();
+  }
+  _vars[var].eliminated = true;
+  _eliminated_vars.push_back(var);
+  dequeue_var(var);
+  _stats.eliminated_variables++;
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Variable eliminated"));
+  return true;
+}
+
+void napsat::NapSAT::preprocess()
+{
+  ASSERT(!_preprocessed);
+  _preprocessed = true;
+  // the decisions taken through the interface would be lost
+  if (solver_level() != LEVEL_ROOT)
+    return;
+  propagate();
+  if (_status != UNDEF || _propagated_literals != _trail.size())
+    return;
+  utils::profiler::scope timer(_profiler, utils::PHASE_PREPROCESS);
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Preprocessing"));
+  // remove the clauses satisfied at level 0 and the falsified literals first
+  if (!_trail.empty())
+    purge_clauses();
+
+  _preprocessing = true;
+  _occurrences.assign(2 * _vars.size(), vector<Tclause>());
+  _lit_marks.assign(2 * _vars.size(), false);
+  _signatures.assign(_clauses.size(), 0);
+  vector<bool> frozen(_vars.size(), false);
+  for (Tlit lit : _assumptions)
+    frozen[lit_to_var(lit)] = true;
+  for (const propagator* p : _propagators)
+    p->freeze(frozen);
+  for (Tclause cl = 0; cl < _clauses.size(); cl++) {
+    const TSclause& clause = _clauses[cl];
+    if (clause.deleted || clause.learned || clause.size < 2)
+      continue;
+    // binary clauses satisfied at level 0 are not purged
+    bool assigned = false;
+    for (unsigned i = 0; !assigned && i < clause.size; i++)
+      assigned = !lit_undef(clause.lits()[i]);
+    if (assigned)
+      continue;
+    // the input clauses may repeat a variable, which the occurrence lists do not support
+    bool repeated = false;
+    for (unsigned i = 0; i < clause.size; i++) {
+      Tlit lit = clause.lits()[i];
+      repeated |= _lit_marks[lit] || _lit_marks[lit_neg(lit)];
+      _lit_marks[lit] = true;
+    }
+    for (unsigned i = 0; i < clause.size; i++)
+      _lit_marks[clause.lits()[i]] = false;
+    if (!repeated) {
+      attach_occurrences(cl);
+      continue;
+    }
+    // the clause is left out of the preprocessing, so its variables cannot be eliminated
+    for (unsigned i = 0; i < clause.size; i++)
+      frozen[lit_to_var(clause.lits()[i])] = true;
+  }
+  // small clauses are more likely to subsume other clauses
+  sort(_subsumption_queue.begin(), _subsumption_queue.end(), [this](Tclause a, Tclause b) {
+    return _clauses[a].size < _clauses[b].size;
+  });
+  subsume_clauses();
+
+  vector<Tvar> candidates;
+  // the clauses of an eliminated variable are deleted in the DRAT proof, and restoring them later would
+  // add clauses that are not implied by the remaining ones
+  for (Tvar var = 1; !_drat && var < _vars.size(); var++)
+    if (var_undef(var) && !frozen[var])
+      candidates.push_back(var);
+  // the variables with few occurrences first, since they are the cheapest to eliminate
+  sort(candidates.begin(), candidates.end(), [this](Tvar a, Tvar b) {
+    return _occurrences[literal(a, 1)].size() * _occurrences[literal(a, 0)].size()
+         < _occurrences[literal(b, 1)].size() * _occurrences[literal(b, 0)].size();
+  });
+  for (Tvar var : candidates) {
+    if (_status == UNSAT)
+      break;
+    if (var_undef(var))
+      eliminate_variable(var);
+  }
+  // the resolvents may subsume other clauses
+  subsume_clauses();
+
+  // the learned clauses and the clauses satisfied at level 0 may still contain eliminated variables
+  for (Tclause cl = 0; !_eliminated_vars.empty() && cl < _clauses.size(); cl++) {
+    const TSclause& clause = _clauses[cl];
+    if (clause.deleted)
+      continue;
+    for (unsigned i = 0; i < clause.size; i++) {
+      if (_vars[lit_to_var(clause.lits()[i])].eliminated) {
+        ASSERT(!is_protected(cl));
+        delete_clause(cl);
+        break;
+      }
+    }
+  }
+  _preprocessing = false;
+  repair_watch_lists();
+  compact_clauses();
+  vector<vector<Tclause>>().swap(_occurrences);
+  vector<uint64_t>().swap(_signatures);
+  vector<bool>().swap(_lit_marks);
+  NOTIFY_OBSERVER(_observer, new napsat::gui::check_invariants());
+}
+
+void napsat::NapSAT::restore_eliminated_variables()
+{
+  ASSERT(!_preprocessing);
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Eliminated variables restored"));
+  if (solver_level() != LEVEL_ROOT)
+    backtrack(LEVEL_ROOT);
+  for (Tvar var : _eliminated_vars) {
+    _vars[var].eliminated = false;
+    enqueue_var(var);
+  }
+  _eliminated_vars.clear();
+  for (const TSreconstruction& reconstruction : _reconstruction_clauses) {
+    if (_status == UNSAT)
+      break;
+    const Tlit* lits = _reconstruction_literals.data() + reconstruction.begin;
+    _resolvent.assign(lits, lits + reconstruction.size);
+    // at level 0, all the assigned literals are assigned at level 0
+    bool satisfied = false;
+    for (Tlit lit : _resolvent)
+      satisfied = satisfied || lit_true(lit);
+    if (satisfied)
+      continue;
+    unsigned size = _resolvent.size();
+    for (unsigned i = 0; i < size;) {
+      if (lit_false(_resolvent[i]))
+        swap(_resolvent[i], _resolvent[--size]);
+      else
+        i++;
+    }
+    Tclause cl = internal_add_clause(_resolvent.data(), size, false, false);
+    ASSERT(cl != CLAUSE_UNDEF);
+    if (_proof) {
+      _proof->reactivate_clause(cl, reconstruction.proof_id);
+      if (size < _resolvent.size())
+        _proof->remove_root_literals(cl);
+    }
+  }
+  _reconstruction_clauses.clear();
+  _reconstruction_literals.clear();
+}
+
+const std::vector<napsat::Tlit>& napsat::NapSAT::partial_assignment()
+{
+  if (_status != SAT || _eliminated_vars.empty())
+    return _trail;
+  vector<bool> value(_vars.size(), false);
+  for (Tlit lit : _trail)
+    value[lit_to_var(lit)] = lit_pol(lit);
+  // The eliminated variables are processed in the reverse order of elimination, such that the
+  // variables in their clauses already have a value. An eliminated variable is false, unless one of
+  // its clauses is falsified by the other literals, in which case it satisfies it. Since the
+  // resolvents are satisfied, the clauses with the opposite literal are then satisfied by another
+  // literal.
+  for (size_t i = _reconstruction_clauses.size(); i-- > 0;) {
+    const TSreconstruction& reconstruction = _reconstruction_clauses[i];
+    const Tlit* lits = _reconstruction_literals.data() + reconstruction.begin;
+    bool satisfied = false;
+    for (unsigned j = 0; !satisfied && j < reconstruction.size; j++)
+      satisfied = value[lit_to_var(lits[j])] == (bool) lit_pol(lits[j]);
+    if (!satisfied)
+      value[lit_to_var(lits[0])] = lit_pol(lits[0]);
+  }
+  _model = _trail;
+  for (Tvar var : _eliminated_vars)
+    _model.push_back(literal(var, value[var]));
+  return _model;
+}
@@ -24,43 +24,54 @@ using namespace std;
 
 void napsat::NapSAT::repair_watch_lists()
 {
-  /** REPAIR BINARY WATCH LIST **/
-  for (Tlit lit = 2; lit < _watch_lists.size(); lit++) {
-    for (unsigned j = 0; j < _binary_clauses[lit].size(); j++) {
-      Tclause cl = _binary_clauses[lit][j].second;
+  for (Tlit lit : _dirty_watch_lists) {
+    ASSERT(_watch_list_dirty[lit]);
+    _watch_list_dirty[lit] = false;
+
+    /** REPAIR BINARY WATCH LIST **/
+    vector<pair<Tlit, Tclause>>& binary_list = _binary_clauses[lit];
+    unsigned k = 0;
+    for (unsigned j = 0; j < binary_list.size(); j++) {
+      Tclause cl = binary_list[j].second;
       ASSERT_MSG(cl != CLAUSE_UNDEF,
-        "Error: binary clause " << lit_to_string(lit) << " <- " << lit_to_string(_binary_clauses[lit][j].first) << " is undefined");
-      if (_clauses[cl].deleted) {
-        _binary_clauses[lit].erase(_binary_clauses[lit].begin() + j);
-        j--;
-      }
+        "Error: binary clause " << lit_to_string(lit) << " <- " << lit_to_string(binary_list[j].first) << " is undefined");
+      if (!_clauses[cl].deleted)
+        binary_list[k++] = binary_list[j];
     }
-  }
-  /** REPAIR WATCH LISTS **/
-  for (Tlit lit = 2; lit < _watch_lists.size(); lit++) {
-    vector<Tclause>& watch_list = _watch_lists[lit];
-    Tclause* i = watch_list.data();
-    Tclause* end = i + watch_list.size();
+    binary_list.resize(k);
 
-    while (i < end) {
-      TSclause &clause = _clauses[*i];
+    /** REPAIR WATCH LIST **/
+    vector<TSwatch>& watch_list = _watch_lists[lit];
+    k = 0;
+    for (unsigned j = 0; j < watch_list.size(); j++) {
+      TSclause &clause = _clauses[watch_list[j].cl];
       if (clause.deleted || !clause.watched
-       || (clause.lits[0] != lit && clause.lits[1] != lit)
+       || (clause.lits()[0] != lit && clause.lits()[1] != lit)
        || clause.size <= 2) {
 #if NOTIFY_WATCH_CHANGES
         if(!clause.deleted && clause.size != 2)
-          NOTIFY_OBSERVER(_observer, new napsat::gui::unwatch(*i, lit));
+          NOTIFY_OBSERVER(_observer, new napsat::gui::unwatch(watch_list[j].cl, lit));
 #endif
-        *i = *(--end);
         continue;
       }
-      i++;
+      watch_list[k++] = watch_list[j];
     }
-    watch_list.resize(end - watch_list.data());
+    watch_list.resize(k);
   }
+  _dirty_watch_lists.clear();
 }
 
 
+void napsat::NapSAT::compact_clauses()
+{
+  // Compacting is linear in the size of the clause store, so it is only worth
+  // it when a significant part of the store is unused, or when memory is short
+  if (_clauses.wasted() * 2 < _clauses.memory_size() && !(_memory_pressure && _clauses.wasted() > 0))
+    return;
+  _clauses.compact();
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Clause store compacted"));
+}
+
 void napsat::NapSAT::purge_root_watch_lists()
 {
   ASSERT(_options.weak_chronological_backtracking || _options.restoring_strong_chronological_backtracking);
@@ -72,22 +83,22 @@ void napsat::NapSAT::purge_root_watch_lists()
       continue;
 
     lit = lit_neg(lit);
-    vector<Tclause>& watch_list = _watch_lists[lit];
-    Tclause* j = watch_list.data();
-    Tclause* k = j;
+    vector<TSwatch>& watch_list = _watch_lists[lit];
+    TSwatch* j = watch_list.data();
+    TSwatch* k = j;
     // start one before so that we just need to increment at the start of the loop
     j--;
-    Tclause* end = j + watch_list.size();
+    TSwatch* end = j + watch_list.size();
     while (j++ < end) {
-      Tclause cl = *j;
+      Tclause cl = j->cl;
       TSclause& clause = _clauses[cl];
       if (clause.deleted) {
         // remove the clause from the watch list
         continue;
       }
-      if (lit_reason(clause.lits[0]) == cl) {
+      if (lit_reason(clause.lits()[0]) == cl) {
         // keep the clause
-        *(k++) = cl;
+        *(k++) = *j;
         continue;
       }
 #if NOTIFY_WATCH_CHANGES
@@ -104,7 +115,7 @@ void napsat::NapSAT::purge_root_watch_lists()
         delete_clause(cl);
         continue;
       }
-      Tlit* lits = clause.lits;
+      Tlit* lits = clause.lits();
       Tlit lit2 = lits[0] ^ lits[1] ^ lit;
       ASSERT(lit2 == lits[0] || lit2 == lits[1]);
       lits[0] = lit2;
@@ -133,12 +144,15 @@ void napsat::NapSAT::purge_root_watch_lists()
 
 void napsat::NapSAT::purge_clauses()
 {
+  utils::profiler::scope timer(_profiler, utils::PHASE_PURGE);
   ASSERT(watch_lists_complete());
   ASSERT(watch_lists_minimal());
   NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Purging clauses"));
   _purge_threshold = _n_root_lvl_lits + _purge_inc;
   // We assume that all the literals are propagated
   ASSERT(_propagated_literals == _trail.size());
+  if (_exchange)
+    export_root_literals();
 
   if (_options.weak_chronological_backtracking || _options.restoring_strong_chronological_backtracking)
     purge_root_watch_lists();
@@ -146,13 +160,13 @@ void napsat::NapSAT::purge_clauses()
   for (Tclause cl = 0; cl < _clauses.size(); cl++) {
     // Do not remove clauses that are used as reasons
     TSclause& clause = _clauses[cl];
-    if (is_protected(cl))
-      continue;
     if (clause.deleted || !clause.watched || clause.size <= 2)
       continue;
+    if (is_protected(cl))
+      continue;
     // Since all literals are propagated, if a clause has a watched literal falsified at level 0, then the other must be satisfied.
     // In strong chronological backtracking, the other watched literal must be satisfied at level 0 too.
-    Tlit* lits = clause.lits;
+    Tlit* lits = clause.lits();
     if ((lit_true(lits[0]) && lit_level(lits[0]) == LEVEL_ROOT)
       || (lit_true(lits[1]) && lit_level(lits[1]) == LEVEL_ROOT)) {
       delete_clause(cl);
@@ -206,15 +220,25 @@ void napsat::NapSAT::purge_clauses()
 
     ASSERT_MSG(!clause.deleted,
                "Clause: " + clause_to_string(cl) + " was deleted.");
+    if (_drat && previous_size != clause.size) {
+      // the removed literals are still stored after the end of the clause
+      _drat->add_clause(lits, clause.size);
+      _drat->delete_clause(lits, previous_size);
+    }
     if (_proof && previous_size != clause.size) {
       _proof->start_resolution_chain();
       _proof->link_resolution(LIT_UNDEF, cl);
-      prove_root_literal_removal(clause.lits + clause.size, previous_size - clause.size);
+      prove_root_literal_removal(clause.lits() + clause.size, previous_size - clause.size);
       // we need to deactivate the clause to be able to replace it
       _proof->deactivate_clause(cl);
       _proof->finalize_resolution(cl, lits, clause.size);
     }
 
+    // the clause is not in the watch lists anymore, but in the binary lists
+    if (clause.size <= 2) {
+      mark_watch_list_dirty(lits[0]);
+      mark_watch_list_dirty(lits[1]);
+    }
     if (clause.size == 2) {
       _binary_clauses[lits[0]].push_back(make_pair(lits[1], cl));
       _binary_clauses[lits[1]].push_back(make_pair(lits[0], cl));
@@ -237,6 +261,7 @@ void napsat::NapSAT::purge_clauses()
   }
   // remove the deleted clauses
   repair_watch_lists();
+  compact_clauses();
   NOTIFY_OBSERVER(_observer, new napsat::gui::check_invariants());
   ASSERT(watch_lists_complete());
   ASSERT(watch_lists_minimal());
@@ -244,24 +269,58 @@ void napsat::NapSAT::purge_clauses()
 
 void napsat::NapSAT::simplify_clause_set()
 {
-  _next_clause_elimination *= _options.clause_elimination_multiplier;
-  _clause_activity_threshold *= _options.clause_activity_threshold_decay;
-  double threshold = _max_clause_activity * _clause_activity_threshold;
+  utils::profiler::scope timer(_profiler, utils::PHASE_SIMPLIFY);
+  // under memory pressure, the reductions are not spaced out
+  if (!_memory_pressure)
+    _next_clause_elimination *= _options.clause_elimination_multiplier;
+  _vivification_pending = _options.vivification;
+  _reduction_candidates.clear();
   for (Tclause cl = 0; cl < _clauses.size(); cl++) {
     ASSERT(_activities[cl] <= _max_clause_activity);
     ASSERT(_clauses[cl].size > 0);
-    if (_clauses[cl].deleted || !_clauses[cl].watched || !_clauses[cl].learned)
+    TSclause& clause = _clauses[cl];
+    if (clause.deleted || !clause.watched || !clause.learned)
       continue;
-    if (_clauses[cl].size <= 2)
+    if (_memory_pressure) {
+      // the LBD thresholds were lowered since the clause was learned
+      if (clause.tier == TIER_CORE && clause.lbd > _options.core_lbd)
+        clause.tier = TIER_2;
+      if (clause.tier == TIER_2 && clause.lbd > _options.tier2_lbd)
+        clause.tier = TIER_LOCAL;
+      clause.used = false;
+    }
+    if (clause.size <= 2 || clause.tier == TIER_CORE)
       continue;
-    if (is_protected(cl))
+    if (clause.used) {
+      clause.used = false;
       continue;
-    if (_activities[cl] < threshold) {
-      delete_clause(cl);
-      NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Clause deleted"));
     }
+    if (clause.tier == TIER_2) {
+      clause.tier = TIER_LOCAL;
+      NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Clause demoted"));
+      continue;
+    }
+    if (is_protected(cl))
+      continue;
+    _reduction_candidates.push_back(cl);
+  }
+  // the least useful clauses first: high LBD, then low activity
+  sort(_reduction_candidates.begin(), _reduction_candidates.end(), [this](Tclause a, Tclause b) {
+    if (_clauses[a].lbd != _clauses[b].lbd)
+      return _clauses[a].lbd > _clauses[b].lbd;
+    return _activities[a] < _activities[b];
+  });
+  double fraction = _options.local_reduction_fraction;
+  if (_memory_pressure)
+    fraction = (1 + fraction) / 2;
+  unsigned n_deleted = _reduction_candidates.size() * fraction;
+  for (unsigned i = 0; i < n_deleted; i++) {
+    delete_clause(_reduction_candidates[i]);
+    NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Clause deleted"));
   }
+  _reduction_candidates.clear();
   repair_watch_lists();
+  compact_clauses();
   ASSERT(watch_lists_complete());
   ASSERT(watch_lists_minimal());
   NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Clause set simplified"));
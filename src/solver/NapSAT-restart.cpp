@@ -0,0 +1,92 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-restart.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the restart policies of the NapSAT solver.
+ * @details The policy is selected with the restart_policy option. The agility policy restarts when the
+ * polarity of the implied literals stops changing. The Luby and geometric policies restart after a number
+ * of conflicts following a fixed sequence. The glucose policy restarts when the recently learned clauses
+ * have a higher LBD than on average. With partial restarts, the decisions that would be taken again after
+ * the restart are kept on the trail.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+
+using namespace std;
+
+/**
+ * @brief Returns the i-th element of the Luby sequence (1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...), starting
+ * from 0.
+ */
+static unsigned luby(unsigned i)
+{
+  // find the finite subsequence that contains index i, and the size of that subsequence
+  unsigned size = 1;
+  unsigned seq = 0;
+  while (size < i + 1) {
+    seq++;
+    size = 2 * size + 1;
+  }
+  while (size - 1 != i) {
+    size = (size - 1) >> 1;
+    seq--;
+    i = i % size;
+  }
+  return 1u << seq;
+}
+
+bool napsat::NapSAT::restart_needed()
+{
+  unsigned long conflicts = _stats.conflicts - _conflicts_at_restart;
+  switch (_restart_policy) {
+  case RESTART_LUBY:
+  case RESTART_GEOMETRIC:
+    return conflicts >= _restart_limit;
+  case RESTART_GLUCOSE:
+    return conflicts >= _options.restart_interval
+      && _lbd_ema_fast.value() > _options.restart_margin * _lbd_ema_slow.value();
+  default:
+    ASSERT(_restart_policy == RESTART_AGILITY);
+    return _agility < _options.agility_threshold;
+  }
+}
+
+napsat::Tlevel napsat::NapSAT::partial_restart_level()
+{
+  Tvar next = next_decision_var();
+  if (next == 0)
+    return solver_level();
+  for (Tlevel level = 1; level <= solver_level(); level++) {
+    Tvar decision = lit_to_var(_trail[_decision_index[level - 1]]);
+    ASSERT(lit_reason(_trail[_decision_index[level - 1]]) == CLAUSE_UNDEF);
+    if (_decision_heuristic == DECISION_VMTF) {
+      if (_variable_queue.stamp(decision) < _variable_queue.stamp(next))
+        return level - 1;
+    }
+    else if (_vars[decision].activity < _vars[next].activity)
+      return level - 1;
+  }
+  return solver_level();
+}
+
+void napsat::NapSAT::restart()
+{
+  _agility = 1;
+  _options.agility_threshold *= _options.agility_threshold_decay;
+  _stats.restarts++;
+  _conflicts_at_restart = _stats.conflicts;
+  if (_restart_policy == RESTART_LUBY)
+    _restart_limit = (double) _options.restart_interval * luby(++_luby_index);
+  else if (_restart_policy == RESTART_GEOMETRIC)
+    _restart_limit *= _options.restart_geometric_factor;
+  backtrack(_options.partial_restarts ? partial_restart_level() : LEVEL_ROOT);
+  if (_options.rephase && _stats.conflicts >= _next_rephase)
+    rephase();
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Restart"));
+}
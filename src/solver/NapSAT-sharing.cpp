@@ -0,0 +1,71 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-sharing.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the exchange of clauses between the
+ * solvers of a portfolio.
+ * @details Short and low LBD learned clauses are exported when they are learned, and the literals
+ * implied at level 0 are exported as units before purging the clauses. The clauses of the other solvers
+ * are imported at level 0 only, where they can be added as any external clause without being in
+ * conflict with the decisions, whatever the backtracking mode. The clauses containing a variable
+ * eliminated by the preprocessing of the importing solver are ignored. The imports are bounded, and
+ * happen at most once between two conflicts, such that the solver always gets back to its search.
+ * The imported clauses are not recorded in the proofs. Hence, a solver building a resolution proof is
+ * not connected to the exchange, and a DRAT proof cannot be written by a portfolio.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+
+using namespace std;
+
+void napsat::NapSAT::export_root_literals()
+{
+  ASSERT(_exchange);
+  unsigned count = 0;
+  for (Tlit lit : _trail) {
+    if (lit_level(lit) != LEVEL_ROOT)
+      continue;
+    if (count++ < _exported_root_literals)
+      continue;
+    _exchange->export_clause(_exchange_id, &lit, 1, 1);
+    _stats.exported_clauses++;
+  }
+  _exported_root_literals = count;
+}
+
+bool napsat::NapSAT::import_clauses()
+{
+  ASSERT(_exchange);
+  ASSERT(solver_level() == LEVEL_ROOT);
+  ASSERT(_propagated_literals == _trail.size());
+  _conflicts_at_import = _stats.conflicts;
+  unsigned long imported = _stats.imported_clauses;
+  _exchange->import_clauses(_exchange_id, IMPORT_LIMIT, [this](const Tlit* lits, unsigned size, unsigned lbd) {
+    if (_status == UNSAT)
+      return;
+    for (unsigned i = 0; i < size; i++)
+      if (lit_to_var(lits[i]) >= _vars.size() || _vars[lit_to_var(lits[i])].eliminated)
+        return;
+    if (size == 2)
+      for (pair<Tlit, Tclause>& bin : _binary_clauses[lits[0]])
+        if (bin.first == lits[1] && !_clauses[bin.second].deleted)
+          return;
+    Tclause cl = internal_add_clause(lits, size, true, true);
+    // the clause is satisfied at level 0
+    if (cl == CLAUSE_UNDEF)
+      return;
+    _stats.imported_clauses++;
+    if (_clauses[cl].deleted || _clauses[cl].size < 2)
+      return;
+    set_clause_lbd(cl, lbd);
+    // protects the clause from the next clause deletion
+    _clauses[cl].used = true;
+  });
+  return _stats.imported_clauses > imported;
+}
@@ -0,0 +1,379 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-state.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the serialization of the state of the
+ * solver, such that an interrupted search can be resumed in another process.
+ * @details The state is written in a compact binary file. It holds the clause set with the learned
+ * clauses and their metadata, the literals implied at level 0, the phases and the activities of the
+ * variables, the eliminated variables and their reconstruction clauses, and the schedulers of the
+ * restarts, of the clause deletion, of the rephasing and of the vivification. The decisions above level 0
+ * are not saved, the search resumes from a restart. The clauses are loaded in bulk, as in add_clauses, such
+ * that the watch lists, the binary lists and the decision heap are built once.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+#include "../utils/printer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+/**
+ * @brief Identifies the state files. The last byte is the version of the format, to be increased whenever
+ * the layout changes.
+ */
+static const char STATE_MAGIC[8] = {'N', 'a', 'p', 'S', 'A', 'T', 'S', 2};
+
+template <typename T>
+static void write_value(ofstream& file, const T& value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static void write_vector(ofstream& file, const vector<T>& values)
+{
+  write_value(file, (unsigned) values.size());
+  file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+template <typename T>
+static bool read_value(ifstream& file, T& value)
+{
+  return (bool) file.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool read_vector(ifstream& file, vector<T>& values)
+{
+  unsigned size;
+  if (!read_value(file, size))
+    return false;
+  values.resize(size);
+  return (bool) file.read(reinterpret_cast<char*>(values.data()), size * sizeof(T));
+}
+
+/**
+ * @brief Metadata of a clause in the state file. The literals of the clauses are stored separately.
+ */
+typedef struct TSsaved_clause
+{
+  unsigned size;
+  uint8_t learned;
+  uint8_t external;
+  uint8_t used;
+  uint8_t tier;
+  unsigned lbd;
+  double activity;
+} TSsaved_clause;
+
+/**
+ * @brief Metadata of a variable in the state file.
+ */
+typedef struct TSsaved_var
+{
+  double activity;
+  /**
+   * @brief Position of the variable in the VMTF queue, from the least recent, or 0 if it is not in the queue.
+   */
+  unsigned long rank;
+  uint8_t phase;
+  uint8_t target_phase;
+  uint8_t best_phase;
+  uint8_t original_phase;
+  uint8_t eliminated;
+} TSsaved_var;
+
+bool napsat::NapSAT::save_state(const char* filename)
+{
+  if (!_propagators.empty()) {
+    LOG_ERROR("The state of the propagators cannot be saved.");
+    return false;
+  }
+  ofstream file(filename, ios::binary);
+  if (!file.is_open()) {
+    LOG_ERROR("The file " << filename << " could not be opened.");
+    return false;
+  }
+  file.write(STATE_MAGIC, sizeof(STATE_MAGIC));
+  write_value(file, (unsigned) sizeof(statistics));
+  write_value(file, (uint8_t) (_status == UNSAT && _failed_assumptions.empty()));
+
+  // the padding is cleared, such that identical states give identical files
+  vector<TSsaved_var> vars(_vars.size());
+  memset(vars.data(), 0, vars.size() * sizeof(TSsaved_var));
+  for (Tvar var = 1; var < _vars.size(); var++) {
+    vars[var].activity = _vars[var].activity;
+    vars[var].phase = _vars[var].phase_cache;
+    vars[var].target_phase = _target_phase[var];
+    vars[var].best_phase = _best_phase[var];
+    vars[var].original_phase = _original_phase[var];
+    vars[var].eliminated = _vars[var].eliminated;
+  }
+  // the timestamps of the queue are replaced by ranks, which do not depend on the history of the queue
+  vector<Tvar> order;
+  for (Tvar var = 1; var < _vars.size(); var++)
+    if (_variable_queue.contains(var))
+      order.push_back(var);
+  sort(order.begin(), order.end(), [this](Tvar a, Tvar b) {
+    return _variable_queue.stamp(a) < _variable_queue.stamp(b);
+  });
+  for (unsigned i = 0; i < order.size(); i++)
+    vars[order[i]].rank = i + 1;
+  write_vector(file, vars);
+
+  vector<Tlit> root_literals;
+  for (Tlit lit : _trail)
+    if (lit_level(lit) == LEVEL_ROOT)
+      root_literals.push_back(lit);
+  write_vector(file, root_literals);
+
+  // the units are saved with the literals at level 0, and the clauses satisfied at level 0 are not watched
+  vector<TSsaved_clause> clauses;
+  vector<Tlit> literals;
+  for (Tclause cl = 0; cl < _clauses.size(); cl++) {
+    TSclause& clause = _clauses[cl];
+    if (clause.deleted || !clause.watched || clause.size < 2)
+      continue;
+    TSsaved_clause saved;
+    memset(&saved, 0, sizeof(saved));
+    saved.size = clause.size;
+    saved.learned = clause.learned;
+    saved.external = clause.external;
+    saved.used = clause.used;
+    saved.tier = clause.tier;
+    saved.lbd = clause.lbd;
+    saved.activity = _activities[cl];
+    clauses.push_back(saved);
+    literals.insert(literals.end(), clause.lits(), clause.lits() + clause.size);
+  }
+  write_vector(file, clauses);
+  write_vector(file, literals);
+
+  write_value(file, (uint8_t) _preprocessed);
+  write_vector(file, _eliminated_vars);
+  write_vector(file, _reconstruction_clauses);
+  write_vector(file, _reconstruction_literals);
+
+  write_value(file, _var_activity_increment);
+  write_value(file, _clause_activity_increment);
+  write_value(file, _max_clause_activity);
+  write_value(file, _next_clause_elimination);
+  write_value(file, _agility);
+  write_value(file, _options.agility_threshold);
+  write_value(file, _jump_ema);
+  write_value(file, _conflicts_at_restart);
+  write_value(file, _restart_limit);
+  write_value(file, _luby_index);
+  write_value(file, _lbd_ema_fast);
+  write_value(file, _lbd_ema_slow);
+  write_value(file, _target_trail_size);
+  write_value(file, _best_trail_size);
+  write_value(file, _next_rephase);
+  write_value(file, _propagations_at_vivification);
+  write_value(file, _purge_threshold);
+  write_value(file, _purge_inc);
+  write_value(file, _stats);
+  file.close();
+  return !file.fail();
+}
+
+bool napsat::NapSAT::load_state(const char* filename)
+{
+  if (_vars.size() > 1 || _clauses.size() > 0) {
+    LOG_ERROR("A state can only be loaded in a solver without variables.");
+    return false;
+  }
+  if (_proof || _drat) {
+    LOG_ERROR("A state cannot be loaded when a proof is built, the learned clauses would not be justified.");
+    return false;
+  }
+#if USE_OBSERVER
+  if (_observer) {
+    LOG_ERROR("A state cannot be loaded when the observer is enabled.");
+    return false;
+  }
+#endif
+  ifstream file(filename, ios::binary);
+  if (!file.is_open()) {
+    LOG_ERROR("The file " << filename << " could not be opened.");
+    return false;
+  }
+
+  // everything is read and checked before the solver is modified
+  char magic[sizeof(STATE_MAGIC)];
+  unsigned stats_size;
+  uint8_t refuted;
+  file.read(magic, sizeof(magic));
+  if (!file || !equal(magic, magic + sizeof(magic), STATE_MAGIC)
+      || !read_value(file, stats_size) || stats_size != sizeof(statistics)) {
+    LOG_ERROR("The file " << filename << " is not a state of this version of NapSAT.");
+    return false;
+  }
+  vector<TSsaved_var> vars;
+  vector<Tlit> root_literals;
+  vector<TSsaved_clause> clauses;
+  vector<Tlit> literals;
+  uint8_t preprocessed;
+  vector<Tvar> eliminated_vars;
+  vector<TSreconstruction> reconstruction_clauses;
+  vector<Tlit> reconstruction_literals;
+  bool valid = read_value(file, refuted)
+    && read_vector(file, vars) && read_vector(file, root_literals)
+    && read_vector(file, clauses) && read_vector(file, literals)
+    && read_value(file, preprocessed) && read_vector(file, eliminated_vars)
+    && read_vector(file, reconstruction_clauses) && read_vector(file, reconstruction_literals);
+
+  double var_activity_increment, clause_activity_increment, max_clause_activity, agility, agility_threshold;
+  double restart_limit;
+  unsigned next_clause_elimination, luby_index, target_trail_size, best_trail_size, purge_threshold, purge_inc;
+  unsigned long conflicts_at_restart, next_rephase, propagations_at_vivification;
+  utils::ema jump_ema, lbd_ema_fast, lbd_ema_slow;
+  statistics stats;
+  valid = valid
+    && read_value(file, var_activity_increment) && read_value(file, clause_activity_increment)
+    && read_value(file, max_clause_activity) && read_value(file, next_clause_elimination)
+    && read_value(file, agility) && read_value(file, agility_threshold) && read_value(file, jump_ema)
+    && read_value(file, conflicts_at_restart) && read_value(file, restart_limit)
+    && read_value(file, luby_index) && read_value(file, lbd_ema_fast) && read_value(file, lbd_ema_slow)
+    && read_value(file, target_trail_size) && read_value(file, best_trail_size)
+    && read_value(file, next_rephase) && read_value(file, propagations_at_vivification)
+    && read_value(file, purge_threshold) && read_value(file, purge_inc) && read_value(file, stats);
+
+  // the literals must belong to the saved variables
+  size_t n_lits = 0;
+  for (unsigned i = 0; valid && i < clauses.size(); i++) {
+    valid = clauses[i].size >= 2 && clauses[i].tier <= TIER_LOCAL;
+    n_lits += clauses[i].size;
+  }
+  valid = valid && !vars.empty() && n_lits == literals.size();
+  Tlit max_lit = vars.empty() ? 0 : literal(vars.size() - 1, 1);
+  for (vector<Tlit>* lits : {&root_literals, &literals, &reconstruction_literals})
+    for (unsigned i = 0; valid && i < lits->size(); i++)
+      valid = (*lits)[i] >= literal(1, 0) && (*lits)[i] <= max_lit;
+  for (unsigned i = 0; valid && i < eliminated_vars.size(); i++)
+    valid = eliminated_vars[i] > 0 && eliminated_vars[i] < vars.size();
+  for (unsigned i = 0; valid && i < reconstruction_clauses.size(); i++)
+    valid = (size_t) reconstruction_clauses[i].begin + reconstruction_clauses[i].size <= reconstruction_literals.size();
+  if (!valid) {
+    LOG_ERROR("The state file " << filename << " is truncated or corrupted.");
+    return false;
+  }
+
+  Tvar n_vars = vars.size() - 1;
+  var_allocate(n_vars);
+  for (Tvar var : eliminated_vars) {
+    _vars[var].eliminated = true;
+    dequeue_var(var);
+  }
+  _eliminated_vars = std::move(eliminated_vars);
+  _reconstruction_clauses = std::move(reconstruction_clauses);
+  _reconstruction_literals = std::move(reconstruction_literals);
+  _preprocessed = preprocessed;
+
+  // first pass: count the entries in the binary and watch lists
+  vector<unsigned> binary_entries(_watch_lists.size(), 0);
+  vector<unsigned> watch_entries(_watch_lists.size(), 0);
+  for (unsigned i = 0, offset = 0; i < clauses.size(); offset += clauses[i++].size) {
+    vector<unsigned>& entries = clauses[i].size == 2 ? binary_entries : watch_entries;
+    entries[literals[offset]]++;
+    entries[literals[offset + 1]]++;
+  }
+  _clauses.reserve_more(clauses.size(), literals.size());
+  _activities.reserve(clauses.size());
+  _vivified.reserve(clauses.size());
+  for (Tlit lit = 0; lit < _watch_lists.size(); lit++) {
+    if (binary_entries[lit] > 0)
+      _binary_clauses[lit].reserve(binary_entries[lit]);
+    if (watch_entries[lit] > 0)
+      _watch_lists[lit].reserve(watch_entries[lit]);
+  }
+
+  // second pass: copy the clauses and watch their first two literals, all variables are still unassigned
+  unsigned n_learned = 0;
+  for (unsigned i = 0, offset = 0; i < clauses.size(); offset += clauses[i++].size) {
+    TSsaved_clause& saved = clauses[i];
+    const Tlit* lits = literals.data() + offset;
+    Tclause cl = _clauses.allocate(saved.size, saved.learned, saved.external);
+    TSclause& clause = _clauses[cl];
+    memcpy(clause.lits(), lits, saved.size * sizeof(Tlit));
+    clause.used = saved.used;
+    clause.tier = saved.tier;
+    clause.lbd = min(saved.lbd, (unsigned) CLAUSE_MAX_LBD);
+    _activities.push_back(saved.activity);
+    _vivified.push_back(false);
+    n_learned += saved.learned;
+    if (saved.size == 2) {
+      _binary_clauses[lits[0]].push_back(make_pair(lits[1], cl));
+      _binary_clauses[lits[1]].push_back(make_pair(lits[0], cl));
+      continue;
+    }
+    watch_lit(lits[0], cl);
+    watch_lit(lits[1], cl);
+  }
+
+  // the literals at level 0 are added as units, their propagation is left to the next search
+  for (Tlit lit : root_literals) {
+    if (_status == UNSAT)
+      break;
+    if (!lit_true(lit))
+      internal_add_clause(&lit, 1, false, true);
+  }
+  if (refuted)
+    _status = UNSAT;
+
+  // the activities are restored last, since adding the units bumps their variables
+  for (Tvar var = 1; var <= n_vars; var++) {
+    _vars[var].activity = vars[var].activity;
+    _vars[var].phase_cache = vars[var].phase;
+    _target_phase[var] = vars[var].target_phase;
+    _best_phase[var] = vars[var].best_phase;
+    _original_phase[var] = vars[var].original_phase;
+  }
+  if (_decision_heuristic == DECISION_VSIDS)
+    _variable_heap.rebuild([this](unsigned var) { return _vars[var].activity; });
+  else {
+    // moving the variables to the front by increasing ranks restores the order of the queue
+    vector<Tvar> order;
+    for (Tvar var = 1; var <= n_vars; var++)
+      if (_variable_queue.contains(var))
+        order.push_back(var);
+    stable_sort(order.begin(), order.end(), [&vars](Tvar a, Tvar b) { return vars[a].rank < vars[b].rank; });
+    for (Tvar var : order) {
+      _variable_queue.move_to_front(var);
+      if (var_undef(var))
+        _variable_queue.update_search(var);
+    }
+  }
+
+  _n_learned_clauses = n_learned;
+  _var_activity_increment = var_activity_increment;
+  _clause_activity_increment = clause_activity_increment;
+  _max_clause_activity = max_clause_activity;
+  _next_clause_elimination = next_clause_elimination;
+  _agility = agility;
+  _options.agility_threshold = agility_threshold;
+  _jump_ema = jump_ema;
+  _conflicts_at_restart = conflicts_at_restart;
+  _restart_limit = restart_limit;
+  _luby_index = luby_index;
+  _lbd_ema_fast = lbd_ema_fast;
+  _lbd_ema_slow = lbd_ema_slow;
+  _target_trail_size = target_trail_size;
+  _best_trail_size = best_trail_size;
+  _next_rephase = next_rephase;
+  _propagations_at_vivification = propagations_at_vivification;
+  _purge_threshold = purge_threshold;
+  _purge_inc = purge_inc;
+  _stats = stats;
+  return true;
+}
@@ -0,0 +1,155 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-theory.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the propagation of the constraints that
+ * are not clauses, through the propagators defined in propagator.hpp.
+ * @details The literals implied by a propagator have the reason CLAUSE_LAZY. Their reason clause is only
+ * built when the conflict analysis resolves them, and is then kept as a learned clause, which the clause
+ * deletion may remove once it is not a reason anymore. The recursive minimization does not build the
+ * reasons, it considers the implied literals as decisions instead.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+
+#include <algorithm>
+
+using namespace std;
+using namespace napsat;
+
+Tclause NapSAT::propagate_theory(Tlit lit)
+{
+  for (propagator* p : _propagators) {
+    Tclause conflict = p->propagate(lit);
+    if (conflict != CLAUSE_UNDEF)
+      return conflict;
+  }
+  return CLAUSE_UNDEF;
+}
+
+void NapSAT::theory_imply(Tlit lit, Tlevel level, unsigned propagator, unsigned constraint)
+{
+  ASSERT(level <= solver_level());
+  imply_literal(lit, CLAUSE_LAZY);
+  Tvar var = lit_to_var(lit);
+  // imply_literal counted the literals at level 0 with the solver level
+  if (level == LEVEL_ROOT && solver_level() != LEVEL_ROOT)
+    _n_root_lvl_lits++;
+  _levels[var] = level;
+  _theory_reasons[var].propagator = propagator;
+  _theory_reasons[var].constraint = constraint;
+  _stats.theory_propagations++;
+}
+
+Tclause NapSAT::theory_reason(Tlit lit)
+{
+  ASSERT(lit_true(lit));
+  ASSERT(lit_reason(lit) == CLAUSE_LAZY);
+  Tvar var = lit_to_var(lit);
+  ASSERT(_theory_reasons[var].propagator < _propagators.size());
+  _theory_literals.clear();
+  _propagators[_theory_reasons[var].propagator]->explain(lit, _theory_reasons[var].constraint, _theory_literals);
+  ASSERT(_theory_literals[0] == lit);
+  Tclause cl = add_theory_clause(_theory_literals);
+  _vars[var].reason = cl;
+  return cl;
+}
+
+Tclause NapSAT::add_theory_clause(const vector<Tlit>& lits)
+{
+  ASSERT(lits.size() >= 2);
+#ifndef NDEBUG
+  for (unsigned i = 1; i < lits.size(); i++) {
+    ASSERT(lit_false(lits[i]));
+    ASSERT(lit_level(lits[i]) <= lit_level(lits[1]));
+    ASSERT(lit_level(lits[i]) <= lit_level(lits[0]));
+  }
+#endif
+  unsigned size = lits.size();
+  Tclause cl = allocate_clause(size, true, false);
+  memcpy(_clauses[cl].lits(), lits.data(), size * sizeof(Tlit));
+  _n_learned_clauses++;
+  _stats.theory_clauses++;
+  set_clause_lbd(cl, compute_lbd(lits.data(), size));
+  attach_clause(cl);
+  return cl;
+}
+
+bool NapSAT::add_cardinality(const Tlit* lits, unsigned size, unsigned bound)
+{
+  if (_proof || _drat) {
+    LOG_ERROR("The cardinality constraints cannot be justified in a proof.");
+    return false;
+  }
+#if USE_OBSERVER
+  if (_observer) {
+    LOG_ERROR("The cardinality constraints are not supported by the observer.");
+    return false;
+  }
+#endif
+  Tvar max_var = 0;
+  for (unsigned i = 0; i < size; i++)
+    max_var = max(max_var, lit_to_var(lits[i]));
+  var_allocate(max_var);
+  reset_search();
+  if (eliminated_literal(lits, size))
+    restore_eliminated_variables();
+  if (_status != UNDEF)
+    return true;
+  backtrack(LEVEL_ROOT);
+
+  // duplicate literals are adjacent once sorted, and so are the two literals of a variable
+  vector<Tlit> sorted(lits, lits + size);
+  sort(sorted.begin(), sorted.end());
+  sorted.erase(unique(sorted.begin(), sorted.end()), sorted.end());
+  vector<Tlit> normalized;
+  unsigned pairs = 0;
+  for (unsigned i = 0; i < sorted.size(); i++) {
+    // exactly one literal of the pair is true
+    if (i + 1 < sorted.size() && lit_to_var(sorted[i]) == lit_to_var(sorted[i + 1])) {
+      pairs++;
+      i++;
+      continue;
+    }
+    normalized.push_back(sorted[i]);
+  }
+  if (pairs > bound) {
+    _status = UNSAT;
+    return true;
+  }
+  bound -= pairs;
+  if (bound >= normalized.size())
+    return true;
+  if (bound == 0) {
+    for (unsigned i = 0; i < normalized.size() && _status != UNSAT; i++) {
+      Tlit lit = lit_neg(normalized[i]);
+      internal_add_clause(&lit, 1, false, true);
+    }
+    return true;
+  }
+
+  if (!_cardinality) {
+    _cardinality = new cardinality_propagator(*this, _propagators.size());
+    _propagators.push_back(_cardinality);
+  }
+  Tclause conflict = _cardinality->add_constraint(normalized.data(), normalized.size(), bound);
+  if (conflict != CLAUSE_UNDEF)
+    repair_conflict(conflict);
+  return true;
+}
+
+void propagator::imply(Tlit lit, Tlevel level, unsigned constraint)
+{
+  _solver.theory_imply(lit, level, _id, constraint);
+}
+
+Tclause propagator::conflict(const vector<Tlit>& lits)
+{
+  return _solver.add_theory_clause(lits);
+}
@@ -21,68 +21,248 @@
 #include <fstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace napsat;
 using namespace std;
 
 bool napsat::NapSAT::parse_dimacs(const char* filename)
 {
+  utils::profiler::scope timer(_profiler, utils::PHASE_PARSE);
+  reset_search();
   // the file is a compressed xz file
-  // first decompress it and store it in a temporary file
-  istringstream stream;
-  if (string(filename).substr(string(filename).size() - 3) == ".xz") {
-    // create a virtual file and read the content of the compressed file
-    ostringstream decompressed_data;
-    if (!decompress_xz(filename, decompressed_data)) {
+  // the decompressed chunks are parsed while the next ones are decompressed
+  if (string(filename).size() >= 3 && string(filename).substr(string(filename).size() - 3) == ".xz") {
+    // incomplete line at the end of the previous chunk
+    string pending;
+    bool parsing = true;
+    auto consumer = [this, &pending, &parsing](const char* data, size_t size) {
+      const char* end = data + size;
+      const char* last_line = static_cast<const char*>(memrchr(data, '\n', size));
+      if (!last_line) {
+        pending.append(data, size);
+        return true;
+      }
+      last_line++;
+      if (!pending.empty()) {
+        const char* first_line = static_cast<const char*>(memchr(data, '\n', size)) + 1;
+        pending.append(data, first_line - data);
+        parsing = parse_dimacs(pending.data(), pending.data() + pending.size(), false);
+        data = first_line;
+      }
+      if (parsing)
+        parsing = parse_dimacs(data, last_line, false);
+      pending.assign(last_line, end - last_line);
+      return parsing;
+    };
+    if (!decompress_xz(filename, consumer)) {
       LOG_ERROR("The file " << filename << " could not be decompressed.");
       _status = ERROR;
       return false;
     }
-    stream = istringstream(decompressed_data.str());
+    if (parsing)
+      parse_dimacs(pending.data(), pending.data() + pending.size(), true);
+    return _status != ERROR;
   }
-  else {
-    ifstream file = ifstream(filename);
-    if (!file.is_open()) {
-      LOG_ERROR("The file " << filename << " could not be opened.");
-      _status = ERROR;
+
+  // map the file in memory to avoid copying it
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    LOG_ERROR("The file " << filename << " could not be opened.");
+    _status = ERROR;
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) < 0) {
+    LOG_ERROR("The file " << filename << " could not be read.");
+    close(fd);
+    _status = ERROR;
+    return false;
+  }
+  size_t size = file_stat.st_size;
+  if (size == 0) {
+    close(fd);
+    return true;
+  }
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG_ERROR("The file " << filename << " could not be mapped in memory.");
+    _status = ERROR;
+    return false;
+  }
+  madvise(data, size, MADV_SEQUENTIAL);
+  const char* begin = static_cast<const char*>(data);
+  parse_dimacs(begin, begin + size, true);
+  munmap(data, size);
+  return _status != ERROR;
+}
+
+/**
+ * @brief Returns true if the character is a white space in a DIMACS file.
+ */
+static inline bool is_dimacs_space(char c)
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Returns true if the character is a decimal digit.
+ */
+static inline bool is_digit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Largest variable index such that its literals fit in a Tlit.
+ */
+static const unsigned long DIMACS_MAX_VALUE = 0x7FFFFFFE;
+
+/**
+ * @brief Largest number of variables or clauses reserved from the header of a DIMACS formula.
+ * @details The header is only a hint, a malformed header must not allocate more than the formula uses.
+ */
+static const unsigned long DIMACS_MAX_HINT = 1ul << 24;
+
+/**
+ * @brief Scans an unsigned integer starting at p and moves p past it.
+ * @return false if there is no integer at p or if it does not fit in a variable.
+ */
+static inline bool scan_unsigned(const char*& p, const char* end, unsigned long& value)
+{
+  if (p == end || !is_digit(*p))
+    return false;
+  value = 0;
+  while (p < end && is_digit(*p)) {
+    value = value * 10 + (*p - '0');
+    if (value > DIMACS_MAX_VALUE)
       return false;
-    }
-    stream = istringstream(string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>()));
+    p++;
   }
+  return true;
+}
 
-  string line;
-  while (getline(stream, line)) {
-    while (line.size() > 0 && line[0] == ' ')
-      line.erase(0, 1);
-    if (line.size() == 0 || line[0] == 'c' || line[0] == 'p' || line[0] == '\n')
+bool napsat::NapSAT::parse_dimacs(const char* begin, const char* end, bool last)
+{
+  const char* p = begin;
+  while (p < end) {
+    char c = *p;
+    if (is_dimacs_space(c)) {
+      p++;
       continue;
-    if (line[0] == '%')
-      break;
-    start_clause();
-
-    string token = "";
-    for (char c : line) {
-      if (c == ' ' || c == '\n') {
-        if (token == "")
-          continue;
-        int lit = stoi(token);
-        if (lit == 0)
-          break;
-        add_literal(napsat::literal(abs(lit), lit > 0));
-        token = "";
+    }
+    if (c == 'c' || c == 'p') {
+      const char* line = p;
+      while (p < end && *p != '\n')
+        p++;
+      if (c == 'c')
+        continue;
+      // header of the form "p cnf <variables> <clauses>", or "p inccnf" for an iCNF file
+      const char* q = line + 1;
+      unsigned long n_vars;
+      unsigned long n_clauses;
+      while (q < p && is_dimacs_space(*q))
+        q++;
+      if (p - q >= 6 && strncmp(q, "inccnf", 6) == 0)
+        continue;
+      if (p - q < 3 || strncmp(q, "cnf", 3) != 0) {
+        LOG_WARNING("Ignoring the unexpected header " << string(line, p - line));
         continue;
       }
-      token += c;
+      q += 3;
+      while (q < p && is_dimacs_space(*q))
+        q++;
+      if (!scan_unsigned(q, p, n_vars)) {
+        LOG_WARNING("Ignoring the unexpected header " << string(line, p - line));
+        continue;
+      }
+      while (q < p && is_dimacs_space(*q))
+        q++;
+      if (!scan_unsigned(q, p, n_clauses)) {
+        LOG_WARNING("Ignoring the unexpected header " << string(line, p - line));
+        continue;
+      }
+      // the variables are allocated from the literals read, the header only reserves memory
+      unsigned long hint_limit = DIMACS_MAX_HINT;
+      // each clause and each variable takes at least two characters of the rest of the formula
+      if (last)
+        hint_limit = min(hint_limit, (unsigned long) (end - p) / 2);
+      n_vars = min(n_vars, hint_limit);
+      n_clauses = min(n_clauses, hint_limit);
+      _vars.reserve(n_vars + 1);
+      _trail.reserve(n_vars);
+      _clauses.reserve(_clauses.size() + n_clauses);
+      _activities.reserve(_activities.size() + n_clauses);
+      continue;
+    }
+    if (c == '%') {
+      if (_writing_clause)
+        finalize_clause();
+      return false;
+    }
+    if (c == 'a') {
+      // cube of an iCNF file, of the form "a <literals> 0"
+      if (_writing_clause)
+        finalize_clause();
+      _cubes.emplace_back();
+      _reading_cube = true;
+      p++;
+      continue;
+    }
+
+    bool negative = c == '-';
+    if (negative)
+      p++;
+    unsigned long var;
+    if (!scan_unsigned(p, end, var) || (p < end && !is_dimacs_space(*p))) {
+      const char* line = p;
+      while (line > begin && *(line - 1) != '\n')
+        line--;
+      const char* line_end = p;
+      while (line_end < end && *line_end != '\n')
+        line_end++;
+      LOG_ERROR("Unexpected token in the DIMACS line: " << string(line, line_end - line));
+      _status = ERROR;
+      return false;
+    }
+    if (_reading_cube) {
+      if (var != 0) {
+        var_allocate(var);
+        _cubes.back().push_back(napsat::literal(var, !negative));
+      }
+      else
+        _reading_cube = false;
+      continue;
+    }
+    if (!_writing_clause)
+      start_clause();
+    if (var != 0) {
+      add_literal(napsat::literal(var, !negative));
+      continue;
     }
     finalize_clause();
     if (_status != UNDEF)
-      return true;
+      return false;
   }
-  return true;
+  // the last clause or cube may not be terminated by 0
+  if (last && _writing_clause)
+    finalize_clause();
+  if (last)
+    _reading_cube = false;
+  return _status == UNDEF;
 }
 
 void napsat::NapSAT::bump_var_activity(Tvar var)
 {
+  if (_decision_heuristic == DECISION_VMTF) {
+    _vmtf_bumped.push_back(var);
+    return;
+  }
   _vars.at(var).activity += _var_activity_increment;
   if (_vars.at(var).activity > 1e100) {
     for (Tvar i = 1; i < _vars.size(); i++) {
@@ -95,6 +275,36 @@ void napsat::NapSAT::bump_var_activity(Tvar var)
     _variable_heap.increase_activity(var, _vars.at(var).activity);
 }
 
+void napsat::NapSAT::flush_vmtf_bumped()
+{
+  // the same variable may be bumped several times during the analysis
+  sort(_vmtf_bumped.begin(), _vmtf_bumped.end(), [this](Tvar a, Tvar b) {
+    return _variable_queue.stamp(a) < _variable_queue.stamp(b);
+  });
+  _vmtf_bumped.erase(unique(_vmtf_bumped.begin(), _vmtf_bumped.end()), _vmtf_bumped.end());
+  for (Tvar var : _vmtf_bumped) {
+    if (!_variable_queue.contains(var))
+      continue;
+    _variable_queue.move_to_front(var);
+    if (var_undef(var))
+      _variable_queue.update_search(var);
+  }
+  _vmtf_bumped.clear();
+}
+
+napsat::Tvar napsat::NapSAT::next_decision_var()
+{
+  if (_decision_heuristic == DECISION_VMTF) {
+    Tvar var = _variable_queue.search();
+    while (var != LOCATION_UNDEF && !var_undef(var))
+      var = _variable_queue.skip();
+    return var == LOCATION_UNDEF ? 0 : var;
+  }
+  while (!_variable_heap.empty() && !var_undef(_variable_heap.top()))
+    _variable_heap.pop();
+  return _variable_heap.empty() ? 0 : _variable_heap.top();
+}
+
 void napsat::NapSAT::bump_clause_activity(Tclause cl)
 {
   _activities[cl] += _clause_activity_increment;
@@ -108,6 +318,58 @@ void napsat::NapSAT::bump_clause_activity(Tclause cl)
   }
 }
 
+unsigned napsat::NapSAT::compute_lbd(const Tlit* lits, unsigned size)
+{
+  if (_level_stamps.size() <= solver_level())
+    _level_stamps.resize(solver_level() + 1, 0);
+  _level_stamp++;
+  unsigned lbd = 0;
+  for (unsigned i = 0; i < size; i++) {
+    Tlevel lvl = lit_level(lits[i]);
+    ASSERT(lvl <= solver_level());
+    if (_level_stamps[lvl] == _level_stamp)
+      continue;
+    _level_stamps[lvl] = _level_stamp;
+    lbd++;
+  }
+  return lbd;
+}
+
+unsigned napsat::NapSAT::record_learned_clause(const Tlit* lits, unsigned size)
+{
+  unsigned lbd = compute_lbd(lits, size);
+  _stats.learned_clauses++;
+  _stats.learned_literals += size;
+  _stats.size_histogram[min(size, STAT_HISTOGRAM_SIZE - 1)]++;
+  _stats.lbd_histogram[min(lbd, STAT_HISTOGRAM_SIZE - 1)]++;
+  return lbd;
+}
+
+void napsat::NapSAT::set_clause_lbd(Tclause cl, unsigned lbd)
+{
+  TSclause& clause = _clauses[cl];
+  ASSERT(clause.learned);
+  clause.lbd = min(lbd, (unsigned) CLAUSE_MAX_LBD);
+  if (lbd <= _options.core_lbd)
+    clause.tier = TIER_CORE;
+  else if (lbd <= _options.tier2_lbd)
+    clause.tier = min((unsigned) clause.tier, (unsigned) TIER_2);
+}
+
+void napsat::NapSAT::update_clause_lbd(Tclause cl)
+{
+  TSclause& clause = _clauses[cl];
+  if (!clause.learned || clause.tier == TIER_CORE)
+    return;
+  clause.used = true;
+  // binary clauses are never deleted, their LBD is irrelevant
+  if (clause.size <= 2)
+    return;
+  unsigned lbd = compute_lbd(clause.lits(), clause.size);
+  if (lbd < clause.lbd)
+    set_clause_lbd(cl, lbd);
+}
+
 void napsat::NapSAT::delete_clause(Tclause cl)
 {
   // If the clause is the reason for a literal, it cannot be deleted
@@ -115,8 +377,16 @@ void napsat::NapSAT::delete_clause(Tclause cl)
   TSclause &clause = _clauses[cl];
   ASSERT(!is_protected(cl));
   _n_learned_clauses -= _clauses[cl].learned;
+  // the watch lists (or binary lists) of the watched literals still refer to the clause
+  if (clause.watched && clause.size >= 2) {
+    mark_watch_list_dirty(clause.lits()[0]);
+    mark_watch_list_dirty(clause.lits()[1]);
+  }
+  if (_drat)
+    _drat->delete_clause(clause.lits(), clause.size);
   clause.deleted = true;
   clause.watched = false;
+  _clauses.release(cl);
   _deleted_clauses.push_back(cl);
   NOTIFY_OBSERVER(_observer, new napsat::gui::delete_clause(cl));
   if(_proof)
@@ -133,8 +403,8 @@ void napsat::NapSAT::watch_lit(Tlit lit, Tclause cl)
   ASSERT(cl != CLAUSE_UNDEF);
   ASSERT(cl < _clauses.size());
   ASSERT(_clauses[cl].size > 2);
-  ASSERT(lit == _clauses[cl].lits[0] || lit == _clauses[cl].lits[1]);
-  _watch_lists[lit].push_back(cl);
+  ASSERT(lit == _clauses[cl].lits()[0] || lit == _clauses[cl].lits()[1]);
+  _watch_lists[lit].push_back({_clauses[cl].blocker, cl});
 }
 
 void napsat::NapSAT::stop_watch(Tlit lit, Tclause cl)
@@ -143,9 +413,10 @@ void napsat::NapSAT::stop_watch(Tlit lit, Tclause cl)
   NOTIFY_OBSERVER(_observer, new napsat::gui::unwatch(cl, lit));
 #endif
   ASSERT(cl != CLAUSE_UNDEF);
-  ASSERT(_clauses[cl].lits[0] == lit || _clauses[cl].lits[1] == lit);
+  ASSERT(_clauses[cl].lits()[0] == lit || _clauses[cl].lits()[1] == lit);
   ASSERT(_clauses[cl].size > 2);
-  auto location = find(_watch_lists[lit].begin(), _watch_lists[lit].end(), cl);
+  auto location = find_if(_watch_lists[lit].begin(), _watch_lists[lit].end(),
+    [cl](const TSwatch& watch) { return watch.cl == cl; });
   ASSERT(location != _watch_lists[lit].end());
   _watch_lists[lit].erase(location);
 }
@@ -210,8 +481,8 @@ string NapSAT::clause_to_string(Tclause cl)
     s += "d";
   }
   s += to_string(cl) + ": ";
-  for (Tlit* i = _clauses[cl].lits; i < _clauses[cl].lits + _clauses_sizes[cl]; i++) {
-    if (i == _clauses[cl].lits + _clauses[cl].size)
+  for (Tlit* i = _clauses[cl].lits(); i < _clauses[cl].lits() + _clauses[cl].capacity; i++) {
+    if (i == _clauses[cl].lits() + _clauses[cl].size)
       s += "| ";
     if (*i == _clauses[cl].blocker)
       s += "\033[3mb";
@@ -357,12 +628,56 @@ void napsat::NapSAT::print_watch_lists(Tlit lit)
     }
     cout << "\n                non-binary: ";
 
-    for (Tclause cl : _watch_lists[i])
-      cout << cl << " ";
+    for (TSwatch watch : _watch_lists[i])
+      cout << watch.cl << " ";
     cout << "\n";
   }
 }
 
+void napsat::NapSAT::print_benchmark() const
+{
+  ASSERT(_profiler.enabled());
+  double solve_time = 0;
+  for (unsigned ph = 0; ph < utils::PHASE_COUNT; ph++) {
+    cout << "c bench " << utils::phase_names[ph] << "_time " << _profiler.seconds((utils::phase) ph) << "\n";
+    cout << "c bench " << utils::phase_names[ph] << "_calls " << _profiler.calls((utils::phase) ph) << "\n";
+    if (ph != utils::PHASE_PARSE)
+      solve_time += _profiler.seconds((utils::phase) ph);
+  }
+  cout << "c bench solve_time " << solve_time << "\n";
+  cout << "c bench propagations " << _stats.propagations << "\n";
+  cout << "c bench conflicts " << _stats.conflicts << "\n";
+  cout << "c bench decisions " << _stats.decisions << "\n";
+  cout << "c bench restarts " << _stats.restarts << "\n";
+  cout << "c bench rephases " << _stats.rephases << "\n";
+  cout << "c bench watch_visits " << _stats.watch_visits << "\n";
+  cout << "c bench blocker_hits " << _stats.blocker_hits << "\n";
+  if (_stats.exported_clauses > 0 || _stats.imported_clauses > 0) {
+    cout << "c bench exported_clauses " << _stats.exported_clauses << "\n";
+    cout << "c bench imported_clauses " << _stats.imported_clauses << "\n";
+  }
+  cout << "c bench eliminated_variables " << _stats.eliminated_variables << "\n";
+  cout << "c bench subsumed_clauses " << _stats.subsumed_clauses << "\n";
+  cout << "c bench strengthened_clauses " << _stats.strengthened_clauses << "\n";
+  cout << "c bench vivified_clauses " << _stats.vivified_clauses << "\n";
+  cout << "c bench vivified_literals " << _stats.vivified_literals << "\n";
+  cout << "c bench vivification_deletions " << _stats.vivification_deletions << "\n";
+  if (_stats.theory_propagations > 0 || _stats.theory_clauses > 0) {
+    cout << "c bench theory_propagations " << _stats.theory_propagations << "\n";
+    cout << "c bench theory_clauses " << _stats.theory_clauses << "\n";
+  }
+  if (_stats.memory_reductions > 0)
+    cout << "c bench memory_reductions " << _stats.memory_reductions << "\n";
+  cout << "c bench memory_bytes " << get_memory_usage().total << "\n";
+  cout << "c bench propagations_per_sec " << (solve_time > 0 ? _stats.propagations / solve_time : 0) << "\n";
+  cout << "c bench conflicts_per_sec " << (solve_time > 0 ? _stats.conflicts / solve_time : 0) << endl;
+}
+
+const napsat::statistics& napsat::NapSAT::get_statistics() const
+{
+  return _stats;
+}
+
 bool napsat::NapSAT::parse_command(std::string input)
 {
   if (input == "") {
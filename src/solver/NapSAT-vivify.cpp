@@ -0,0 +1,280 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/NapSAT-vivify.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the vivification of the learned clauses.
+ * @details A vivification round is scheduled by each clause deletion, and runs from level 0 at the next
+ * decision. For a clause C = c₁ ∨ ... ∨ cₙ, the literals ¬c₁, ¬c₂, ... are decided and propagated one at
+ * a time. If a literal cᵢ becomes true, or a conflict occurs, the decisions involved form a subset of C
+ * implied by the clause set, which replaces C if it is shorter. The literals of C falsified by the
+ * propagation of the previous decisions are redundant, and are never decided. The round stops when its
+ * propagation budget, a fraction of the propagations of the search, is exhausted.
+ */
+#include "NapSAT.hpp"
+
+#include "custom-assert.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+napsat::Tclause napsat::NapSAT::vivification_propagate(unsigned long& propagations)
+{
+  while (_propagated_literals < _trail.size()) {
+    Tlit lit = _trail[_propagated_literals];
+    Tclause conflict = propagate_binary_clauses(lit);
+    if (conflict == CLAUSE_UNDEF)
+      conflict = propagate_lit(lit);
+    propagations++;
+    if (conflict != CLAUSE_UNDEF)
+      return conflict;
+    _vars[lit_to_var(lit)].propagated = true;
+    _propagated_literals++;
+    NOTIFY_OBSERVER(_observer, new napsat::gui::propagation(lit));
+  }
+  return CLAUSE_UNDEF;
+}
+
+bool napsat::NapSAT::vivification_mark(Tlit lit)
+{
+  ASSERT(lit_false(lit));
+  if (lit_seen(lit))
+    return false;
+  lit_mark_seen(lit);
+  if (lit_level(lit) != LEVEL_ROOT)
+    return true;
+  _vivification_root_literals.push_back(lit);
+  return false;
+}
+
+napsat::Tclause napsat::NapSAT::vivification_duplicate()
+{
+  ASSERT(_next_literal_index >= 2);
+  for (unsigned i = 0; i < _next_literal_index; i++)
+    lit_mark_seen(_literal_buffer[i]);
+  Tlit* first = _literal_buffer;
+  Tlit* last = _literal_buffer + _next_literal_index;
+  Tclause duplicate = CLAUSE_UNDEF;
+  if (_next_literal_index == 2) {
+    for (pair<Tlit, Tclause> bin : _binary_clauses[first[0]])
+      if (bin.first == first[1] && !_clauses[bin.second].deleted)
+        duplicate = bin.second;
+  }
+  // an identical clause is watched by two of the literals, hence by one of the first n - 1 literals
+  else for (Tlit* watched = first; watched + 1 < last && duplicate == CLAUSE_UNDEF; watched++)
+    for (TSwatch& watch : _watch_lists[*watched]) {
+      TSclause& clause = _clauses[watch.cl];
+      if (clause.deleted || clause.size != _next_literal_index)
+        continue;
+      Tlit* lits = clause.lits();
+      unsigned j = 0;
+      // the marks are on the variables, the polarity is checked on the variables marked only
+      while (j < clause.size && lit_seen(lits[j]) && find(first, last, lits[j]) != last)
+        j++;
+      if (j == clause.size) {
+        duplicate = watch.cl;
+        break;
+      }
+    }
+  for (unsigned i = 0; i < _next_literal_index; i++)
+    lit_unmark_seen(_literal_buffer[i]);
+  return duplicate;
+}
+
+bool napsat::NapSAT::vivify_clause(Tclause cl, unsigned long& propagations)
+{
+  ASSERT(solver_level() == LEVEL_ROOT);
+  ASSERT(_propagated_literals == _trail.size());
+  _vivification_literals.assign(_clauses[cl].lits(), _clauses[cl].lits() + _clauses[cl].size);
+  // the clauses with literals assigned at level 0 are simplified by the next purge
+  for (Tlit lit : _vivification_literals)
+    if (!lit_undef(lit))
+      return true;
+
+  Tclause start = CLAUSE_UNDEF;
+  Tlit implied = LIT_UNDEF;
+  for (Tlit lit : _vivification_literals) {
+    if (lit_false(lit))
+      continue;
+    if (lit_true(lit)) {
+      implied = lit;
+      start = lit_reason(lit);
+      break;
+    }
+    imply_literal(lit_neg(lit), CLAUSE_UNDEF);
+    start = vivification_propagate(propagations);
+    if (start != CLAUSE_UNDEF)
+      break;
+  }
+  // the clause itself is falsified after the last decision at the latest
+  ASSERT(start != CLAUSE_UNDEF);
+
+  // Collect the decisions involved in the implication or the conflict. The trail is visited backward,
+  // such that a literal is resolved after all the literals whose reason introduces it.
+  _vivification_chain.clear();
+  _vivification_root_literals.clear();
+  _next_literal_index = 0;
+  if (implied != LIT_UNDEF)
+    _literal_buffer[_next_literal_index++] = implied;
+  bool self = start == cl;
+  unsigned count = 0;
+  TSclause& first = _clauses[start];
+  for (unsigned i = 0; i < first.size; i++)
+    if (first.lits()[i] != implied)
+      count += vivification_mark(first.lits()[i]);
+  for (unsigned i = _trail.size(); count > 0; ) {
+    ASSERT(i > 0);
+    i--;
+    Tlit lit = _trail[i];
+    if (!lit_seen(lit) || lit_level(lit) == LEVEL_ROOT)
+      continue;
+    lit_unmark_seen(lit);
+    count--;
+    Tclause reason = lit_reason(lit);
+    if (reason == CLAUSE_UNDEF) {
+      _literal_buffer[_next_literal_index++] = lit_neg(lit);
+      continue;
+    }
+    self |= reason == cl;
+    _vivification_chain.push_back({lit_neg(lit), reason});
+    TSclause& clause = _clauses[reason];
+    for (unsigned j = 1; j < clause.size; j++)
+      count += vivification_mark(clause.lits()[j]);
+  }
+  for (Tlit lit : _vivification_root_literals)
+    lit_unmark_seen(lit);
+  backtrack(LEVEL_ROOT);
+
+  unsigned size = _vivification_literals.size();
+  ASSERT(_next_literal_index > 0 && _next_literal_index <= size);
+  if (!self && _vivification_chain.empty() && _vivification_root_literals.empty()) {
+    // the clause is subsumed by the clause start, which must be kept as long as the clause would be
+    if (_clauses[start].learned && _clauses[start].lbd > _clauses[cl].lbd)
+      set_clause_lbd(start, _clauses[cl].lbd);
+    _vivification_redundant.push_back(cl);
+    _stats.vivification_deletions++;
+    NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Vivified clause subsumed"));
+    return true;
+  }
+  if (_next_literal_index == size) {
+    if (self)
+      return true;
+    _vivification_redundant.push_back(cl);
+    _stats.vivification_deletions++;
+    NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Vivified clause implied"));
+    return true;
+  }
+
+  Tclause duplicate = _next_literal_index >= 2 ? vivification_duplicate() : CLAUSE_UNDEF;
+  if (duplicate != CLAUSE_UNDEF) {
+    // another clause already subsumes the clause, typically a clause vivified before
+    if (_clauses[duplicate].learned && _clauses[duplicate].lbd > _clauses[cl].lbd)
+      set_clause_lbd(duplicate, _clauses[cl].lbd);
+    _vivification_redundant.push_back(cl);
+    _stats.vivification_deletions++;
+    NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Vivified clause subsumed"));
+    return true;
+  }
+
+  if (_proof) {
+    _proof->start_resolution_chain();
+    _proof->link_resolution(LIT_UNDEF, start);
+    for (pair<Tlit, Tclause>& step : _vivification_chain)
+      _proof->link_resolution(step.first, step.second);
+    if (!_vivification_root_literals.empty())
+      prove_root_literal_removal(_vivification_root_literals.data(), _vivification_root_literals.size());
+  }
+  unsigned lbd = min((unsigned) _clauses[cl].lbd, _next_literal_index);
+  double activity = _activities[cl];
+  Tclause vivified = internal_add_clause(_literal_buffer, _next_literal_index, true, false);
+  ASSERT(vivified != CLAUSE_UNDEF);
+  if (_proof)
+    _proof->finalize_resolution(vivified, _literal_buffer, _next_literal_index);
+  set_clause_lbd(vivified, lbd);
+  _activities[vivified] = activity;
+  // vivifying the new clause would only repeat the same decisions
+  _vivified[vivified] = true;
+  _vivification_redundant.push_back(cl);
+  _stats.vivified_clauses++;
+  _stats.vivified_literals += size - _next_literal_index;
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Clause vivified"));
+  return _propagated_literals == _trail.size();
+}
+
+void napsat::NapSAT::vivify_clauses()
+{
+  ASSERT(_vivification_pending);
+  utils::profiler::scope timer(_profiler, utils::PHASE_VIVIFY);
+  _vivification_pending = false;
+  vector<Tlit> decisions;
+  for (Tlevel level = solver_level(); level > LEVEL_ROOT; level--)
+    decisions.push_back(_trail[_decision_index[level - 1]]);
+  backtrack(LEVEL_ROOT);
+  unsigned long budget = _options.vivification_effort * (_stats.propagations - _propagations_at_vivification);
+  _propagations_at_vivification = _stats.propagations;
+  unsigned long propagations = 0;
+  // in chronological backtracking, literals may be left to propagate at level 0
+  Tclause conflict = vivification_propagate(propagations);
+  if (conflict != CLAUSE_UNDEF) {
+    repair_conflict(conflict);
+    ASSERT(_status == UNSAT);
+    return;
+  }
+
+  _vivification_candidates.clear();
+  for (Tclause cl = 0; cl < _clauses.size(); cl++) {
+    TSclause& clause = _clauses[cl];
+    if (clause.deleted || !clause.watched || !clause.learned || clause.size <= 2 || _vivified[cl])
+      continue;
+    _vivification_candidates.push_back(cl);
+  }
+  // the clauses most likely to be kept first: low LBD, then high activity
+  sort(_vivification_candidates.begin(), _vivification_candidates.end(), [this](Tclause a, Tclause b) {
+    if (_clauses[a].lbd != _clauses[b].lbd)
+      return _clauses[a].lbd < _clauses[b].lbd;
+    return _activities[a] > _activities[b];
+  });
+
+  vector<bool> phases(_vars.size());
+  for (Tvar var = 1; var < _vars.size(); var++)
+    phases[var] = _vars[var].phase_cache;
+  double agility = _agility;
+  double agility_threshold = _options.agility_threshold;
+  _phase_saving_suspended = true;
+
+  for (Tclause cl : _vivification_candidates) {
+    if (propagations >= budget || termination_requested())
+      break;
+    // a clause deletion may be triggered by the vivified clauses
+    if (_clauses[cl].deleted)
+      continue;
+    _vivified[cl] = true;
+    if (!vivify_clause(cl, propagations))
+      break;
+  }
+  _vivification_candidates.clear();
+
+  // the redundant clauses are still valid, they are deleted together to repair the watch lists once
+  for (Tclause cl : _vivification_redundant)
+    // a clause deletion may be triggered by the vivified clauses
+    if (!_clauses[cl].deleted && !is_protected(cl))
+      delete_clause(cl);
+  _vivification_redundant.clear();
+  repair_watch_lists();
+
+  for (Tvar var = 1; var < _vars.size(); var++)
+    _vars[var].phase_cache = phases[var];
+  _phase_saving_suspended = false;
+  _agility = agility;
+  _options.agility_threshold = agility_threshold;
+  // the search resumes with the same decisions, unless a conflict occurs before
+  _vivification_decisions = decisions;
+  ASSERT(watch_lists_complete());
+  ASSERT(watch_lists_minimal());
+  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Clauses vivified"));
+}
@@ -19,6 +19,13 @@
 #include <cstring>
 #include <functional>
 
+#if USE_SIMD && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_REPLACEMENT 1
+#include <immintrin.h>
+#else
+#define SIMD_REPLACEMENT 0
+#endif
+
 using namespace napsat;
 using namespace std;
 
@@ -40,8 +47,8 @@ void NapSAT::imply_literal(Tlit lit, Tclause reason)
 #ifndef NDEBUG
   if (reason != CLAUSE_UNDEF && reason != CLAUSE_LAZY) {
     for (unsigned i = 1; i < _clauses[reason].size; i++) {
-      ASSERT(lit_false(_clauses[reason].lits[i]));
-      ASSERT(lit_level(_clauses[reason].lits[i]) <= lit_level(lit));
+      ASSERT(lit_false(_clauses[reason].lits()[i]));
+      ASSERT(lit_level(_clauses[reason].lits()[i]) <= lit_level(lit));
     }
   }
 #endif
@@ -49,7 +56,9 @@ void NapSAT::imply_literal(Tlit lit, Tclause reason)
   Tvar var = lit_to_var(lit);
   _trail.push_back(lit);
   TSvar& svar = _vars[var];
-  svar.state = lit_pol(lit);
+  Tlevel& level = _levels[var];
+  _lit_values[lit] = VAR_TRUE;
+  _lit_values[lit_neg(lit)] = VAR_FALSE;
   svar.propagated = false;
   svar.reason = reason;
 
@@ -59,35 +68,38 @@ void NapSAT::imply_literal(Tlit lit, Tclause reason)
   if (reason == CLAUSE_UNDEF) {
     // Decision
     _decision_index.push_back(_trail.size() - 1);
-    svar.level = solver_level();
+    level = solver_level();
     NOTIFY_OBSERVER(_observer, new napsat::gui::decision(lit));
   }
   else if (reason == CLAUSE_LAZY) {
-    // Theory propagation
-    ASSERT_MSG(false, "Lazy reason is not implemented yet");
+    // Hint or theory propagation, theory_imply sets the level and the constraint afterwards
+    level = solver_level();
+    _theory_reasons[var].propagator = PROPAGATOR_UNDEF;
   }
   else {
     // Implied literal
-    ASSERT(lit == _clauses[reason].lits[0]);
+    ASSERT(lit == _clauses[reason].lits()[0]);
     if (_clauses[reason].size == 1)
-      svar.level = LEVEL_ROOT;
+      level = LEVEL_ROOT;
     else {
-      ASSERT(lit == _clauses[reason].lits[0]);
-      svar.level = lit_level(_clauses[reason].lits[1]);
+      ASSERT(lit == _clauses[reason].lits()[0]);
+      level = lit_level(_clauses[reason].lits()[1]);
     }
-    NOTIFY_OBSERVER(_observer, new napsat::gui::implication(lit, reason, svar.level));
+    NOTIFY_OBSERVER(_observer, new napsat::gui::implication(lit, reason, level));
   }
   if (lit_pol(lit) != svar.phase_cache)
     _agility += 1 - _options.agility_decay;
   svar.phase_cache = lit_pol(lit);
 
-  if (svar.level == LEVEL_ROOT) {
+  if (level == LEVEL_ROOT) {
     _n_root_lvl_lits++;
     if (_proof)
       _proof->root_assign(lit, reason);
   }
-  ASSERT(svar.level != LEVEL_UNDEF);
-  ASSERT(svar.level <= solver_level());
+  for (propagator* p : _propagators)
+    p->assign(lit);
+  ASSERT(level != LEVEL_UNDEF);
+  ASSERT(level <= solver_level());
 }
 
 void napsat::NapSAT::reimply_literal(Tlit lit, Tclause reason)
@@ -95,28 +107,68 @@ void napsat::NapSAT::reimply_literal(Tlit lit, Tclause reason)
   ASSERT(lit_true(lit));
   ASSERT(reason != CLAUSE_UNDEF);
   ASSERT(reason != CLAUSE_LAZY);
-  ASSERT(lit == _clauses[reason].lits[0]);
+  ASSERT(lit == _clauses[reason].lits()[0]);
   ASSERT(_options.lazy_strong_chronological_backtracking);
 
   TSclause& clause = _clauses[reason];
-  Tlevel reimplication_level = clause.size == 1 ? 0 : lit_level(clause.lits[1]);
+  Tlevel reimplication_level = clause.size == 1 ? 0 : lit_level(clause.lits()[1]);
 #ifndef NDEBUG
   for (unsigned i = 1; i < clause.size; i++) {
-    ASSERT(lit_false(clause.lits[i]));
-    ASSERT(lit_level(clause.lits[i]) <= reimplication_level);
+    ASSERT(lit_false(clause.lits()[i]));
+    ASSERT(lit_level(clause.lits()[i]) <= reimplication_level);
   }
 #endif
 
   Tlevel current_level = lit_level(lit);
   if (current_level <= reimplication_level)
     return;
-  if (lit_lazy_reason(lit) != CLAUSE_UNDEF
-   && lit_level(_clauses[lit_lazy_reason(lit)].lits[1]) <= reimplication_level)
+  if (lit_lazy_level(lit) <= reimplication_level)
     return;
 
   lit_set_lazy_reason(lit, reason);
 }
 
+#if SIMD_REPLACEMENT
+/**
+ * @brief Clauses shorter than this are searched one literal at a time, since the first literals are
+ * usually enough.
+ */
+#define SIMD_REPLACEMENT_MIN_SIZE 16
+
+static bool avx2_supported()
+{
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+
+static const bool AVX2 = avx2_supported();
+
+/**
+ * @brief Skips the falsified literals of [k, end), 8 literals at a time.
+ * @param values the values of the literals, readable as 32 bit words at any literal.
+ * @return the first literal of the first block of 8 literals that is not entirely falsified, or the
+ * beginning of the last incomplete block.
+ */
+__attribute__((target("avx2")))
+static Tlit* skip_false_avx2(const uint8_t* values, Tlit* k, Tlit* end)
+{
+  static_assert(VAR_FALSE == 0, "the falsified literals are detected as zero bytes");
+  static_assert(sizeof(Tlit) == 4, "the literals are used as 32 bit gather indices");
+  const __m256i byte = _mm256_set1_epi32(0xFF);
+  const __m256i zero = _mm256_setzero_si256();
+  for (; k + 8 <= end; k += 8) {
+    __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(k));
+    __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(values), indices, 1);
+    __m256i falsified = _mm256_cmpeq_epi32(_mm256_and_si256(words, byte), zero);
+    unsigned not_falsified = ~_mm256_movemask_ps(_mm256_castsi256_ps(falsified)) & 0xFF;
+    if (not_falsified)
+      return k + __builtin_ctz(not_falsified);
+  }
+  return k;
+}
+#endif
+
+template <napsat::NapSAT::backtracking_mode MODE>
 Tlit* napsat::NapSAT::search_replacement(Tlit* lits, unsigned size)
 {
   /**
@@ -131,6 +183,17 @@ Tlit* napsat::NapSAT::search_replacement(Tlit* lits, unsigned size)
   // This must be as efficient as possible!
   Tlit* end = lits + size;
   Tlit* k = lits + 2;
+  if constexpr (MODE == BACKTRACK_NCB) {
+    // the falsified literals are never above ¬ℓ, only the first literal not falsified is of interest
+#if SIMD_REPLACEMENT
+    if (size >= SIMD_REPLACEMENT_MIN_SIZE && AVX2)
+      k = skip_false_avx2(_lit_values.data(), k, end);
+#endif
+    for (; k < end; k++)
+      if (!lit_false(*k))
+        return k;
+    return lits + 1;
+  }
   Tlevel low_sat_lvl = lit_true(lits[0]) ? lit_level(lits[0]) : LEVEL_UNDEF;
   Tlevel high_non_sat_lvl = lit_level(lits[1]);
   Tlit* high_non_sat_lit = lits + 1;
@@ -138,13 +201,10 @@ Tlit* napsat::NapSAT::search_replacement(Tlit* lits, unsigned size)
     if (!lit_false(*k))
       return k;
     if (lit_level(*k) > high_non_sat_lvl) {
-      // in non-chronological backtracking, the watched literals are always at the highest level
-      ASSERT(_options.chronological_backtracking);
       high_non_sat_lvl = lit_level(*k);
       high_non_sat_lit = k;
     }
     if (low_sat_lvl <= high_non_sat_lvl) {
-      ASSERT(_options.chronological_backtracking);
       ASSERT(k == high_non_sat_lit);
       return k;
     }
@@ -153,6 +213,7 @@ Tlit* napsat::NapSAT::search_replacement(Tlit* lits, unsigned size)
   return high_non_sat_lit;
 }
 
+template <napsat::NapSAT::backtracking_mode MODE>
 Tclause napsat::NapSAT::propagate_binary_clauses(Tlit lit)
 {
   lit = lit_neg(lit);
@@ -161,9 +222,9 @@ Tclause napsat::NapSAT::propagate_binary_clauses(Tlit lit)
   for (pair<Tlit, Tclause> bin : _binary_clauses[lit]) {
     ASSERT_MSG(_clauses[bin.second].size == 2, "Clause: " + clause_to_string(bin.second) + ",Literal: " + lit_to_string(lit));
     if (lit_true(bin.first)) {
-      if (_options.lazy_strong_chronological_backtracking && lit_level(bin.first) > lit_level(lit)) {
+      if (MODE == BACKTRACK_LSCB && lit_level(bin.first) > lit_level(lit)) {
         // missed lower implication
-        Tlit* lits = _clauses[bin.second].lits;
+        Tlit* lits = _clauses[bin.second].lits();
         if (lits[0] != bin.first) {
           lits[0] = lits[0] ^ lits[1];
           lits[1] = lits[0] ^ lits[1];
@@ -176,7 +237,7 @@ Tclause napsat::NapSAT::propagate_binary_clauses(Tlit lit)
     }
     if (lit_undef(bin.first)) {
       // ensure that the implied literal is positioned at the first position
-      Tlit* lits = _clauses[bin.second].lits;
+      Tlit* lits = _clauses[bin.second].lits();
       ASSERT(lits[0] == lit || lits[1] == lit);
       ASSERT(lits[0] == bin.first || lits[1] == bin.first);
       lits[0] = bin.first;
@@ -185,10 +246,10 @@ Tclause napsat::NapSAT::propagate_binary_clauses(Tlit lit)
       continue;
     }
     // Conflict
-    ASSERT(_options.chronological_backtracking || lit_level(bin.first) == lit_level(lit));
-    if (_options.chronological_backtracking) {
+    ASSERT(MODE != BACKTRACK_NCB || lit_level(bin.first) == lit_level(lit));
+    if constexpr (MODE != BACKTRACK_NCB) {
       // make sure that the highest literal is at the first position
-      Tlit* lits = _clauses[bin.second].lits;
+      Tlit* lits = _clauses[bin.second].lits();
       if (lit_level(lits[0]) < lit_level(lits[1])) {
         // in place swapping
         lits[0] ^= lits[1];
@@ -197,12 +258,28 @@ Tclause napsat::NapSAT::propagate_binary_clauses(Tlit lit)
         // we do not need to update the next watched clause because the clause is binary
       }
     }
-    ASSERT(lit_level(_clauses[bin.second].lits[0]) >= lit_level(_clauses[bin.second].lits[1]));
+    ASSERT(lit_level(_clauses[bin.second].lits()[0]) >= lit_level(_clauses[bin.second].lits()[1]));
     return bin.second;
   }
   return CLAUSE_UNDEF;
 }
 
+Tclause napsat::NapSAT::propagate_binary_clauses(Tlit lit)
+{
+  switch (_backtracking_mode) {
+  case BACKTRACK_NCB:
+    return propagate_binary_clauses<BACKTRACK_NCB>(lit);
+  case BACKTRACK_WCB:
+    return propagate_binary_clauses<BACKTRACK_WCB>(lit);
+  case BACKTRACK_RSCB:
+    return propagate_binary_clauses<BACKTRACK_RSCB>(lit);
+  default:
+    ASSERT(_backtracking_mode == BACKTRACK_LSCB);
+    return propagate_binary_clauses<BACKTRACK_LSCB>(lit);
+  }
+}
+
+template <napsat::NapSAT::backtracking_mode MODE>
 Tclause NapSAT::propagate_lit(Tlit lit)
 {
   // ASSERT(watch_lists_complete());
@@ -215,13 +292,17 @@ Tclause NapSAT::propagate_lit(Tlit lit)
 
   // level of the propagation
   Tlevel lvl = lit_level(lit);
-  vector<Tclause>& watch_list = _watch_lists[lit];
+  vector<TSwatch>& watch_list = _watch_lists[lit];
 
   // Be careful that with this method, we do not want to push anything to the watch list.
   // Otherwise the memory might be reallocated and the pointers invalidated.
   // TODO check if this watch list shuffling is good for performance
-  Tclause* i = watch_list.data();
-  Tclause* end = i + watch_list.size();
+  TSwatch* i = watch_list.data();
+  TSwatch* end = i + watch_list.size();
+  // statistics are accumulated locally and flushed when leaving the function
+  unsigned long visits = 0;
+  unsigned long blocker_hits = 0;
+  unsigned long searches = 0;
 
   /**
    * Let F* be a set of clauses such that each clause in the set satisfies
@@ -256,24 +337,26 @@ Tclause NapSAT::propagate_lit(Tlit lit)
    * all the clauses watched by ¬ℓ and F* = F. Therefore, we satisfy our contract.
    */
   while (i < end) {
-    Tclause cl = *i;
-    TSclause& clause = _clauses[cl];
-    ASSERT(clause.watched);
-    ASSERT(clause.size >= 2);
-    // Skip condition before dereferencing the pointers
-    if (lit_true(clause.blocker)
-      && (!_options.chronological_backtracking || lit_level(clause.blocker) <= lvl)) {
+    Tclause cl = i->cl;
+    visits++;
+    // Skip condition before dereferencing the clause
+    if (lit_true(i->blocker)
+      && (MODE == BACKTRACK_NCB || lit_level(i->blocker) <= lvl)) {
       /**
        * NCB: b ∈ π
        * WCB: b ∈ π ∧ δ(b) ≤ δ(c₁)
        * SCB: b ∈ π ∧ δ(b) ≤ δ(c₁)
        * the invariants are preserved without any action
        */
+      blocker_hits++;
       i++;
       continue;
     }
 
-    Tlit* lits = clause.lits;
+    TSclause& clause = _clauses[cl];
+    ASSERT(clause.watched);
+    ASSERT(clause.size >= 2);
+    Tlit* lits = clause.lits();
     /**
      * we call c₁ and c₂ the watched literals of the clause
      * we ensure that c₁ = ¬ℓ to make the rest of the function more efficient
@@ -290,7 +373,7 @@ Tclause NapSAT::propagate_lit(Tlit lit)
 
     /** SKIP CONDITIONS **/
     if (lit_true(lit2)
-      && (!_options.lazy_strong_chronological_backtracking || lit_level(lit2) <= lvl)) {
+      && (MODE != BACKTRACK_LSCB || lit_level(lit2) <= lvl)) {
       /**
        * NCB: c₂ ∈ π
        * WCB: c₂ ∈ π
@@ -301,7 +384,8 @@ Tclause NapSAT::propagate_lit(Tlit lit)
       continue;
     }
     /** SEARCH REPLACEMENT **/
-    Tlit* replacement = search_replacement(lits, clause.size);
+    searches++;
+    Tlit* replacement = search_replacement<MODE>(lits, clause.size);
     /**
      * Search replacement returns a literal r ∈ C \ {c₂} such that it either is a good replacement
      * such that
@@ -322,10 +406,10 @@ Tclause NapSAT::propagate_lit(Tlit lit)
 
     Tlevel replacement_lvl = lit_level(*replacement);
 
-    ASSERT_MSG(_options.chronological_backtracking || (!lit_true(*replacement) || replacement_lvl <= lvl),
+    ASSERT_MSG(MODE != BACKTRACK_NCB || (!lit_true(*replacement) || replacement_lvl <= lvl),
       "Clause: " + clause_to_string(cl) + "\nLiteral: " + lit_to_string(lit) + "\nReplacement: " + lit_to_string(*replacement) + "\nLevel: " + to_string(lvl));
     /** TRUE literal **/
-    if (lit_true(*replacement) && replacement_lvl <= lvl) {
+    if (lit_true(*replacement) && (MODE == BACKTRACK_NCB || replacement_lvl <= lvl)) {
       /**
        * r ∈ π ∧ δ(r) ≤ δ(c₁)
        * NCB: We know that r ∈ π ⇒ δ(r) ≤ δ(c₁). Therefore after this condition is satisfied in NCB,
@@ -333,6 +417,18 @@ Tclause NapSAT::propagate_lit(Tlit lit)
        * ¬c₁ ∈ τ ⇒ c₂ ∈ π ∨ [b ∈ π ∧ δ(b) ≤ δ(c₁)] is satisfied if we set b = r
       */
       clause.blocker = *replacement;
+      i->blocker = *replacement;
+#if USE_OBSERVER
+      // The observer checks the invariants with a single blocker per clause, so the watch of c₂
+      // is updated as well. Otherwise, the watch of c₂ keeps its own blocker, which is still a
+      // literal of the clause.
+      if (_observer)
+        for (TSwatch& watch : _watch_lists[lit2])
+          if (watch.cl == cl) {
+            watch.blocker = *replacement;
+            break;
+          }
+#endif
 #if NOTIFY_WATCH_CHANGES
       NOTIFY_OBSERVER(_observer, new napsat::gui::block(cl, *replacement));
 #endif
@@ -385,7 +481,7 @@ Tclause NapSAT::propagate_lit(Tlit lit)
        * We know that δ(r) > δ(c₁)
        * We swap the literals such that c₁ ← r
       */
-      ASSERT(_options.chronological_backtracking);
+      ASSERT(MODE != BACKTRACK_NCB);
       // In strong chronological backtracking, we need to swap the literals such that the highest falsified literal is at the second position. In weak chronological backtracking, it is not necessary, but it is still useful to determine the level of the conflict or the implication.
       // swap the literals
       lits[1] = *replacement;
@@ -438,6 +534,9 @@ Tclause NapSAT::propagate_lit(Tlit lit)
       ASSERT_MSG(lit_level(lits[0]) >= lit_level(lits[1]),
         "Conflict: " + clause_to_string(cl) + "\nLiteral: " + lit_to_string(lit));
       watch_list.resize(end - watch_list.data());
+      _stats.watch_visits += visits;
+      _stats.blocker_hits += blocker_hits;
+      _stats.replacement_searches += searches;
       // ASSERT(watch_lists_complete());
       // ASSERT(watch_lists_minimal());
       return cl;
@@ -489,7 +588,7 @@ Tclause NapSAT::propagate_lit(Tlit lit)
      * We now also know that δ(c₂) > δ(c₁), so we can simplify our knowledge as
      * c₂ ∈ π ∧ ¬c₁ ∈ π ∧ C \ {c₂}, π ⊧ ⊥ ∧ δ(c₁) = δ(C \ {c₂})
      */
-    ASSERT(_options.lazy_strong_chronological_backtracking);
+    ASSERT(MODE == BACKTRACK_LSCB);
     ASSERT(lit_true(lit2));
     /**
      * If δ(λ(c₂) \ {c₂}) > δ(c₁), then reimply c₂ at the level of c₁
@@ -511,16 +610,38 @@ Tclause NapSAT::propagate_lit(Tlit lit)
   }
 
   watch_list.resize(end - watch_list.data());
+  _stats.watch_visits += visits;
+  _stats.blocker_hits += blocker_hits;
+  _stats.replacement_searches += searches;
   // ASSERT(watch_lists_complete());
   // ASSERT(watch_lists_minimal());
   return CLAUSE_UNDEF;
 }
 
+Tclause NapSAT::propagate_lit(Tlit lit)
+{
+  switch (_backtracking_mode) {
+  case BACKTRACK_NCB:
+    return propagate_lit<BACKTRACK_NCB>(lit);
+  case BACKTRACK_WCB:
+    return propagate_lit<BACKTRACK_WCB>(lit);
+  case BACKTRACK_RSCB:
+    return propagate_lit<BACKTRACK_RSCB>(lit);
+  default:
+    ASSERT(_backtracking_mode == BACKTRACK_LSCB);
+    return propagate_lit<BACKTRACK_LSCB>(lit);
+  }
+}
+
+template <napsat::NapSAT::backtracking_mode MODE>
 void napsat::NapSAT::backtrack(Tlevel level)
 {
   ASSERT(level <= solver_level());
   if (level == solver_level())
     return;
+  utils::profiler::scope timer(_profiler, utils::PHASE_BACKTRACK);
+  if (_options.rephase && !_phase_saving_suspended)
+    save_phases();
   NOTIFY_OBSERVER(_observer, new napsat::gui::backtracking_started(level));
   unsigned waiting_count = 0;
 
@@ -533,15 +654,17 @@ void napsat::NapSAT::backtrack(Tlevel level)
     Tlit lit = _trail[i];
     Tvar var = lit_to_var(lit);
     if (lit_level(lit) > level) {
-      ASSERT(_options.lazy_strong_chronological_backtracking || lit_lazy_reason(lit) == CLAUSE_UNDEF);
-      if (lit_lazy_level(lit) <= level) {
+      ASSERT(MODE == BACKTRACK_LSCB || lit_lazy_reason(lit) == CLAUSE_UNDEF);
+      if (MODE == BACKTRACK_LSCB) {
         // look if the literal can be reimplied at a lower level
-        ASSERT(_options.lazy_strong_chronological_backtracking);
-        Tclause lazy_reason = lit_lazy_reason(lit);
-        ASSERT(lazy_reason != CLAUSE_UNDEF);
-        ASSERT(_clauses[lazy_reason].lits[0] == lit);
-        ASSERT(lit_true(_clauses[lazy_reason].lits[0]));
-        _reimplication_backtrack_buffer.push_back(lazy_reason);
+        Tlevel lazy_level = lit_lazy_level(lit);
+        if (lazy_level <= level) {
+          Tclause lazy_reason = lit_lazy_reason(lit);
+          ASSERT(lazy_reason != CLAUSE_UNDEF);
+          ASSERT(_clauses[lazy_reason].lits()[0] == lit);
+          ASSERT(lit_true(_clauses[lazy_reason].lits()[0]));
+          _reimplication_backtrack_buffer.emplace_back(lazy_level, lazy_reason);
+        }
       }
       /* in LSCB, we cannot backtrack from front to back because it breaks the missed lower implications
         for example, if ℓ₁ ∨ ℓ₂ ∨ ℓ₃ is a missed lower implication and the trail looks like
@@ -569,15 +692,17 @@ void napsat::NapSAT::backtrack(Tlevel level)
   }
   _trail.resize(j);
   _decision_index.resize(level);
+  _assumption_index = 0;
+  _vivification_decisions.clear();
 
-  ASSERT_MSG(_options.chronological_backtracking || waiting_count == 0,
+  ASSERT_MSG(MODE != BACKTRACK_NCB || waiting_count == 0,
              "Waiting count: " + to_string(waiting_count) + "\nLevel: " + to_string(level) + "\nRestore point: " + to_string(restore_point));
   _propagated_literals = _trail.size() - waiting_count;
-  ASSERT_MSG(_options.chronological_backtracking || _propagated_literals == restore_point,
+  ASSERT_MSG(MODE != BACKTRACK_NCB || _propagated_literals == restore_point,
     "Propagated literals: " + to_string(_propagated_literals) + "\nRestore point: " + to_string(restore_point));
   // in RSCB we need to move the propagation head back to the location of the first literal that moved
   // that is, the location of the first literal that was unassigned.
-  if (_options.restoring_strong_chronological_backtracking) {
+  if constexpr (MODE == BACKTRACK_RSCB) {
     while (_propagated_literals > restore_point) {
       Tlit lit = _trail[_propagated_literals - 1];
       Tvar var = lit_to_var(lit);
@@ -588,17 +713,20 @@ void napsat::NapSAT::backtrack(Tlevel level)
       NOTIFY_OBSERVER(_observer, new napsat::gui::remove_propagation(lit));
     }
   }
-  if (_reimplication_backtrack_buffer.size() > 0) {
-    ASSERT(_options.lazy_strong_chronological_backtracking);
+  ASSERT(MODE == BACKTRACK_LSCB || _reimplication_backtrack_buffer.empty());
+  if (MODE == BACKTRACK_LSCB && _reimplication_backtrack_buffer.size() > 0) {
     // adds the literals on the lazy reimplication buffer to the trail by order of increasing level
     // Sort the literals by increasing level. It is not necessary, but it probably is more effective
     // TODO evaluate the performance of this. Is sorting useful?
     // The topological order will automatically be respected because the reimplied literals cannot depend on each other.
     // see Theorem 17 in [Lazy Reimplication in Chronological Backtracking, Robin Coutelier and Mathias Fleury and Laura Kovács]
-    sort(_reimplication_backtrack_buffer.begin(), _reimplication_backtrack_buffer.end(), [this](Tclause a, Tclause b)
-      { return lit_level(_clauses[a].lits[1]) < lit_level(_clauses[b].lits[1]); });
-    for (Tclause lazy_clause : _reimplication_backtrack_buffer) {
-      Tlit reimpl_lit = _clauses[lazy_clause].lits[0];
+    // The levels were recorded before unassigning, so the clauses do not need to be read again.
+    sort(_reimplication_backtrack_buffer.begin(), _reimplication_backtrack_buffer.end(),
+      [](const std::pair<Tlevel, Tclause>& a, const std::pair<Tlevel, Tclause>& b)
+      { return a.first < b.first; });
+    for (const std::pair<Tlevel, Tclause>& entry : _reimplication_backtrack_buffer) {
+      Tclause lazy_clause = entry.second;
+      Tlit reimpl_lit = _clauses[lazy_clause].lits()[0];
       ASSERT(lit_undef(reimpl_lit));
       imply_literal(reimpl_lit, lazy_clause);
       NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Lazy reimplication used"));
@@ -607,23 +735,194 @@ void napsat::NapSAT::backtrack(Tlevel level)
   }
 }
 
+void napsat::NapSAT::backtrack(Tlevel level)
+{
+  switch (_backtracking_mode) {
+  case BACKTRACK_NCB:
+    backtrack<BACKTRACK_NCB>(level);
+    break;
+  case BACKTRACK_WCB:
+    backtrack<BACKTRACK_WCB>(level);
+    break;
+  case BACKTRACK_RSCB:
+    backtrack<BACKTRACK_RSCB>(level);
+    break;
+  default:
+    ASSERT(_backtracking_mode == BACKTRACK_LSCB);
+    backtrack<BACKTRACK_LSCB>(level);
+  }
+}
+
 bool napsat::NapSAT::lit_is_required_in_learned_clause(Tlit lit)
 {
   ASSERT(lit_false(lit));
-  if (lit_reason(lit) == CLAUSE_UNDEF)
+  // the reasons of the propagators are not built for the minimization
+  if (lit_reason(lit) == CLAUSE_UNDEF || lit_reason(lit) == CLAUSE_LAZY)
     return true;
   ASSERT(lit_reason(lit) < _clauses.size());
   TSclause& clause = _clauses[lit_reason(lit)];
   ASSERT_MSG(!clause.deleted,
     "Literal: " + lit_to_string(lit) + "\nClause: " + clause_to_string(lit_reason(lit)));
   for (unsigned i = 1; i < clause.size; i++)
-    if (!lit_seen(clause.lits[i]))
+    if (!lit_seen(clause.lits()[i]))
       return true;
   return false;
 }
 
+/**
+ * @brief Maps a level to a bit of a 32-bit mask. Two literals with different
+ * abstract levels are necessarily at different levels.
+ */
+static inline unsigned abstract_level(Tlevel level)
+{
+  return 1u << (level & 31);
+}
+
+bool napsat::NapSAT::lit_is_redundant(Tlit lit, unsigned abstract_levels)
+{
+  ASSERT(lit_false(lit));
+  ASSERT(lit_reason(lit) != CLAUSE_UNDEF);
+  unsigned first_marked = _minimize_marked.size();
+  _minimize_stack.clear();
+  _minimize_stack.push_back(lit);
+  while (!_minimize_stack.empty()) {
+    Tlit current = _minimize_stack.back();
+    _minimize_stack.pop_back();
+    ASSERT(lit_reason(current) != CLAUSE_UNDEF);
+    TSclause& reason = _clauses[lit_reason(current)];
+    for (unsigned i = 1; i < reason.size; i++) {
+      Tlit other = reason.lits()[i];
+      ASSERT(lit_false(other));
+      TSvar& var = _vars[lit_to_var(other)];
+      if (var.seen || var.removable || lit_level(other) == LEVEL_ROOT)
+        continue;
+      if (!var.poison && lit_reason(other) != CLAUSE_UNDEF && lit_reason(other) != CLAUSE_LAZY
+          && (abstract_level(lit_level(other)) & abstract_levels)) {
+        // removable, unless one of its antecedents is not
+        var.removable = true;
+        _minimize_marked.push_back(lit_to_var(other));
+        _minimize_stack.push_back(other);
+        continue;
+      }
+      // the literals explored during this call are not known to be redundant anymore
+      for (unsigned j = first_marked; j < _minimize_marked.size(); j++)
+        _vars[_minimize_marked[j]].removable = false;
+      _minimize_marked.resize(first_marked);
+      if (!var.poison) {
+        var.poison = true;
+        _minimize_marked.push_back(lit_to_var(other));
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+void napsat::NapSAT::minimize_learned_clause()
+{
+  ASSERT(_next_literal_index > 0);
+  ASSERT(_minimize_marked.empty());
+  unsigned last = _next_literal_index - 1;
+  unsigned abstract_levels = 0;
+  for (unsigned j = 0; j < last; j++)
+    abstract_levels |= abstract_level(lit_level(_literal_buffer[j]));
+
+  _minimize_removed.clear();
+  unsigned k = 0;
+  for (unsigned j = 0; j < last; j++) {
+    Tlit lit = _literal_buffer[j];
+    // literals at level 0 are removed afterwards, by prove_root_literal_removal for the proof
+    if (lit_reason(lit) == CLAUSE_UNDEF || lit_reason(lit) == CLAUSE_LAZY || lit_level(lit) == LEVEL_ROOT
+        || !lit_is_redundant(lit, abstract_levels)) {
+      _literal_buffer[k++] = lit;
+      continue;
+    }
+    // the removed literals remain seen until the end of the minimization
+    _minimize_removed.push_back(lit);
+  }
+  _literal_buffer[k++] = _literal_buffer[last];
+  _next_literal_index = k;
+
+  for (Tvar var : _minimize_marked) {
+    _vars[var].removable = false;
+    _vars[var].poison = false;
+  }
+  _minimize_marked.clear();
+  for (Tlit lit : _minimize_removed)
+    lit_unmark_seen(lit);
+  _stats.minimized_literals += _minimize_removed.size();
+
+  if (!_proof || _minimize_removed.empty())
+    return;
+  // Resolve the removed literals with their reasons. The reasons introduce
+  // literals that are not in the clause, which must be resolved in turn. The
+  // trail is visited backward, such that a literal is resolved after all the
+  // literals whose reason introduces it. The literals of the minimized clause
+  // are the only ones marked as seen.
+  unsigned count = 0;
+  for (Tlit lit : _minimize_removed) {
+    _vars[lit_to_var(lit)].removable = true;
+    _minimize_marked.push_back(lit_to_var(lit));
+    count++;
+  }
+  unsigned i = _trail.size();
+  while (count != 0) {
+    ASSERT(i > 0);
+    i--;
+    if (!_vars[lit_to_var(_trail[i])].removable)
+      continue;
+    Tlit lit = lit_neg(_trail[i]);
+    Tclause reason = lit_reason(lit);
+    ASSERT(reason != CLAUSE_UNDEF);
+    _proof->link_resolution(lit, reason);
+    count--;
+    for (unsigned j = 1; j < _clauses[reason].size; j++) {
+      TSvar& var = _vars[lit_to_var(_clauses[reason].lits()[j])];
+      if (var.seen || var.removable)
+        continue;
+      var.removable = true;
+      _minimize_marked.push_back(lit_to_var(_clauses[reason].lits()[j]));
+      count++;
+    }
+  }
+  for (Tvar var : _minimize_marked)
+    _vars[var].removable = false;
+  _minimize_marked.clear();
+}
+
+void napsat::NapSAT::binary_minimize_learned_clause()
+{
+  ASSERT(_next_literal_index > 0);
+  unsigned last = _next_literal_index - 1;
+  Tlit asserting = _literal_buffer[last];
+  ASSERT(!lit_seen(asserting));
+  unsigned n_removed = 0;
+  for (pair<Tlit, Tclause> bin : _binary_clauses[asserting]) {
+    Tlit other = bin.first;
+    // the clause contains ¬other, resolving with (asserting ∨ other) removes it
+    if (!lit_true(other) || !lit_seen(other) || _clauses[bin.second].deleted)
+      continue;
+    lit_unmark_seen(other);
+    n_removed++;
+    if (_proof)
+      _proof->link_resolution(lit_neg(other), bin.second);
+  }
+  if (n_removed == 0)
+    return;
+  unsigned k = 0;
+  for (unsigned j = 0; j < last; j++)
+    if (lit_seen(_literal_buffer[j]))
+      _literal_buffer[k++] = _literal_buffer[j];
+  _literal_buffer[k++] = asserting;
+  ASSERT(k + n_removed == _next_literal_index);
+  _next_literal_index = k;
+  _stats.minimized_literals += n_removed;
+}
+
+template <napsat::NapSAT::backtracking_mode MODE>
 void NapSAT::analyze_conflict(Tclause conflict)
 {
+  utils::profiler::scope timer(_profiler, utils::PHASE_ANALYZE);
   // ASSERT(watch_lists_minimal());
   ASSERT(conflict != CLAUSE_UNDEF);
   ASSERT(!_writing_clause);
@@ -638,13 +937,13 @@ void NapSAT::analyze_conflict(Tclause conflict)
   bump_clause_activity(conflict);
   _next_literal_index = 0;
 
-  TSclause clause = _clauses[conflict];
-  Tlevel conflict_level = lit_level(clause.lits[0]);
+  TSclause* clause = &_clauses[conflict];
+  Tlevel conflict_level = lit_level(clause->lits()[0]);
   Tlevel second_highest_level = LEVEL_ROOT;
 
   // This does nothing in non-chronological backtracking
-  ASSERT(_options.chronological_backtracking || conflict_level == solver_level());
-  backtrack(conflict_level);
+  ASSERT(MODE != BACKTRACK_NCB || conflict_level == solver_level());
+  backtrack<MODE>(conflict_level);
 
   // Variable used to determine the first literal from the clause that should be added to the learned clause
   // This is used to avoid adding the satisfied literal of the reason to the learned clause
@@ -653,13 +952,17 @@ void NapSAT::analyze_conflict(Tclause conflict)
   Tlit pivot = LIT_UNDEF;
   do {
     ASSERT(cl != CLAUSE_UNDEF);
+    // the clause store may be reallocated, the clause is fetched afterwards
+    if (cl == CLAUSE_LAZY)
+      cl = theory_reason(lit_neg(pivot));
     if (_proof)
       _proof->link_resolution(pivot, cl);
 
-    clause = _clauses[cl];
+    update_clause_lbd(cl);
+    clause = &_clauses[cl];
     // Be careful that the first time, we start at index 0, then we start at index 1
-    for (unsigned j = not_first_round; j < clause.size; j++) {
-      Tlit lit = clause.lits[j];
+    for (unsigned j = not_first_round; j < clause->size; j++) {
+      Tlit lit = clause->lits()[j];
       ASSERT_MSG(lit_false(lit),
         "Reason: " + clause_to_string(cl));
       bump_var_activity(lit_to_var(lit));
@@ -688,7 +991,7 @@ void NapSAT::analyze_conflict(Tclause conflict)
     count--;
     lit_unmark_seen(pivot);
     cl = lit_reason(pivot);
-    if (lit_lazy_reason(pivot) != CLAUSE_UNDEF)
+    if (MODE == BACKTRACK_LSCB && lit_lazy_reason(pivot) != CLAUSE_UNDEF)
       cl = lit_lazy_reason(pivot);
 
     // This is no longer the first round, and we should ignore the first literal of the clause
@@ -697,20 +1000,19 @@ void NapSAT::analyze_conflict(Tclause conflict)
     /*************************************************************************/
     /*                         LAZY RE-IMPLICATION                           */
     /*************************************************************************/
-    if (count == 0 && lit_lazy_reason(pivot) != CLAUSE_UNDEF) {
-      ASSERT(_options.lazy_strong_chronological_backtracking);
+    if (MODE == BACKTRACK_LSCB && count == 0 && lit_lazy_reason(pivot) != CLAUSE_UNDEF) {
       ASSERT(lit_lazy_reason(pivot) == cl);
-      ASSERT(lit_neg(pivot) == _clauses[cl].lits[0]);
+      ASSERT(lit_neg(pivot) == _clauses[cl].lits()[0]);
       NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Lazy reimplication used"));
 
       // make sure the conflict level cannot be increased by the content of the new clause
       for (unsigned j = 1; j < _clauses[cl].size; j++)
-        second_highest_level = max(second_highest_level, lit_level(_clauses[cl].lits[j]));
+        second_highest_level = max(second_highest_level, lit_level(_clauses[cl].lits()[j]));
 
       conflict_level = second_highest_level;
       // This is used to reimply the literals at the right level.
       // Otherwise we need to make sure that the levels used are the lazy ones, and this is more complicated.
-      backtrack(conflict_level);
+      backtrack<MODE>(conflict_level);
       second_highest_level = LEVEL_ROOT;
 
       // reset the conflict at a lower level
@@ -721,7 +1023,7 @@ void NapSAT::analyze_conflict(Tclause conflict)
       // Note that it is not possible to have twice a lazy reimplication on the same literal
       ASSERT(count == 0);
       for (unsigned j = 1; j < _clauses[cl].size; j++) {
-        Tlit lit = _clauses[cl].lits[j];
+        Tlit lit = _clauses[cl].lits()[j];
         ASSERT_MSG(lit_false(lit),
           "Reason: " + clause_to_string(cl));
         ASSERT(lit != pivot);
@@ -763,6 +1065,11 @@ void NapSAT::analyze_conflict(Tclause conflict)
 
   _literal_buffer[_next_literal_index++] = pivot;
 
+  if (_options.recursive_minimization)
+    minimize_learned_clause();
+  if (_options.binary_minimization)
+    binary_minimize_learned_clause();
+
   // remove the seen markers on literals in the clause
   // we need to unmark them first because of the proof
   // prove_root_literal_removal assumes that the literals are not marked
@@ -793,9 +1100,27 @@ void NapSAT::analyze_conflict(Tclause conflict)
     return;
   }
 
+  // the levels of the literals are only meaningful before backtracking
+  unsigned lbd = record_learned_clause(_literal_buffer, _next_literal_index);
+  export_learned_clause(_literal_buffer, _next_literal_index, lbd);
+  if (_restart_policy == RESTART_GLUCOSE) {
+    _lbd_ema_fast.update(lbd);
+    _lbd_ema_slow.update(lbd);
+  }
+
   // backtrack depending on the chronological backtracking strategy
-  if (_options.chronological_backtracking)
-    backtrack(conflict_level - 1);
+  if constexpr (MODE != BACKTRACK_NCB) {
+    Tlevel backtrack_level = conflict_level - 1;
+    if (_options.adaptive_backtracking) {
+      // the invariants of chronological backtracking also hold after a jump to the assertion level
+      Tlevel assertion_level = LEVEL_ROOT;
+      for (unsigned j = 0; j < _next_literal_index - 1; j++)
+        assertion_level = max(assertion_level, lit_level(_literal_buffer[j]));
+      if (adaptive_jump(conflict_level - assertion_level))
+        backtrack_level = assertion_level;
+    }
+    backtrack<MODE>(backtrack_level);
+  }
   else {
     Tlevel second_highest_level = LEVEL_ROOT;
     for (unsigned j = 0; j < _next_literal_index - 1; j++) {
@@ -804,11 +1129,12 @@ void NapSAT::analyze_conflict(Tclause conflict)
       ASSERT(lit_level(lit) <= conflict_level);
       second_highest_level = max(second_highest_level, lit_level(lit));
     }
-    backtrack(second_highest_level);
+    backtrack<MODE>(second_highest_level);
   }
 
   cl = internal_add_clause(_literal_buffer, _next_literal_index, true, false);
   ASSERT(cl != CLAUSE_UNDEF);
+  set_clause_lbd(cl, lbd);
   if (_proof)
     _proof->finalize_resolution(cl, _literal_buffer, _next_literal_index);
 }
@@ -840,7 +1166,7 @@ void napsat::NapSAT::prove_root_literal_removal(Tlit* lits, unsigned size)
     _proof->link_resolution(lit_neg(lit), reason);
 
     for (unsigned j = 1; j < _clauses[reason].size; j++) {
-      Tlit lit = _clauses[reason].lits[j];
+      Tlit lit = _clauses[reason].lits()[j];
       ASSERT(lit_false(lit));
       if (lit_seen(lit))
         continue;
@@ -852,6 +1178,7 @@ void napsat::NapSAT::prove_root_literal_removal(Tlit* lits, unsigned size)
   }
 }
 
+template <napsat::NapSAT::backtracking_mode MODE>
 void NapSAT::repair_conflict(Tclause conflict)
 {
   /**
@@ -863,11 +1190,11 @@ void NapSAT::repair_conflict(Tclause conflict)
    * - The first literal in the conflict clause is the highest level literal
    *    δ(c₁) = δ(C)
   */
-  Tlit* lits = _clauses[conflict].lits;
+  Tlit* lits = _clauses[conflict].lits();
 
   /********** CHECKING PRECONDITIONS **********/
   ASSERT(_clauses[conflict].size > 0);
-  ASSERT_MSG(_options.chronological_backtracking || _clauses[conflict].external
+  ASSERT_MSG(MODE != BACKTRACK_NCB || _clauses[conflict].external
   || (lit_level(lits[0]) == solver_level()
    && lit_level(lits[1]) == solver_level()),
     "Conflict: " + clause_to_string(conflict) + "\nDecision level: " + to_string(solver_level()));
@@ -879,6 +1206,7 @@ void NapSAT::repair_conflict(Tclause conflict)
 #endif
 
   NOTIFY_OBSERVER(_observer, new napsat::gui::conflict(conflict));
+  _stats.conflicts++;
   if (_status == SAT)
     _status = UNDEF;
 
@@ -896,12 +1224,12 @@ void NapSAT::repair_conflict(Tclause conflict)
   /********** UNIT CLAUSE **********/
   if (_clauses[conflict].size == 1) {
     Tlevel backtrack_level = LEVEL_ROOT;
-    if (_options.chronological_backtracking)
+    if (MODE != BACKTRACK_NCB)
       backtrack_level = lit_level(lits[0]) - 1;
-    backtrack(backtrack_level);
+    backtrack<MODE>(backtrack_level);
     // In strong chronological backtracking, the literal might have been implied again during reimplication
     // Therefore, we might need to trigger another conflict analysis
-    ASSERT(_options.lazy_strong_chronological_backtracking || lit_undef(lits[0]));
+    ASSERT(MODE == BACKTRACK_LSCB || lit_undef(lits[0]));
     if (!lit_undef(lits[0])) {
       // the problem is unsat
       // The literal could have been propagated by the reimplication
@@ -919,12 +1247,12 @@ void NapSAT::repair_conflict(Tclause conflict)
     unique = lit_level(lits[i]) != lit_level(lits[0]);
 
   /********** CLAUSES WITH ONE LITERAL AT MAX LEVEL **********/
-  if (unique && lit_lazy_reason(lits[0]) == CLAUSE_UNDEF) {
+  if (unique && (MODE != BACKTRACK_LSCB || lit_lazy_reason(lits[0]) == CLAUSE_UNDEF)) {
     NOTIFY_OBSERVER(_observer, new napsat::gui::stat("One literal at highest level"));
-    ASSERT(_options.chronological_backtracking || _clauses[conflict].external);
+    ASSERT(MODE != BACKTRACK_NCB || _clauses[conflict].external);
 
     Tlevel backtrack_level = lit_level(lits[1]);
-    if (_options.chronological_backtracking)
+    if (MODE != BACKTRACK_NCB)
       backtrack_level = lit_level(lits[0]) - 1;
 #ifndef NDEBUG
     else {
@@ -935,7 +1263,7 @@ void NapSAT::repair_conflict(Tclause conflict)
         ASSERT(lit_level(lits[i]) <= lit_level(lits[1]));
     }
 #endif
-    backtrack(backtrack_level);
+    backtrack<MODE>(backtrack_level);
     ASSERT(lit_undef(lits[0]));
 #ifndef NDEBUG
     for (unsigned i = 1; i < _clauses[conflict].size; i++)
@@ -943,7 +1271,7 @@ void NapSAT::repair_conflict(Tclause conflict)
         "Conflict: " + clause_to_string(conflict) + "\nLiteral: " + lit_to_string(lits[i]));
 #endif
 
-    if (_options.chronological_backtracking) {
+    if constexpr (MODE != BACKTRACK_NCB) {
       // In chronological backtracking, it might be the case that the second highest literal is not at the second position.
       // We need to ensure that it becomes the second watched literal
       Tlit* end = lits + _clauses[conflict].size;
@@ -967,17 +1295,30 @@ void NapSAT::repair_conflict(Tclause conflict)
     return;
   }
 
-  analyze_conflict(conflict);
+  analyze_conflict<MODE>(conflict);
 
-  _var_activity_increment /= _options.var_activity_decay;
+  if (_decision_heuristic == DECISION_VMTF)
+    flush_vmtf_bumped();
+  else
+    _var_activity_increment /= _options.var_activity_decay;
 }
 
-void NapSAT::restart()
+void NapSAT::repair_conflict(Tclause conflict)
 {
-  _agility = 1;
-  _options.agility_threshold *= _options.agility_threshold_decay;
-  backtrack(LEVEL_ROOT);
-  NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Restart"));
+  switch (_backtracking_mode) {
+  case BACKTRACK_NCB:
+    repair_conflict<BACKTRACK_NCB>(conflict);
+    break;
+  case BACKTRACK_WCB:
+    repair_conflict<BACKTRACK_WCB>(conflict);
+    break;
+  case BACKTRACK_RSCB:
+    repair_conflict<BACKTRACK_RSCB>(conflict);
+    break;
+  default:
+    ASSERT(_backtracking_mode == BACKTRACK_LSCB);
+    repair_conflict<BACKTRACK_LSCB>(conflict);
+  }
 }
 
 void napsat::NapSAT::order_trail()
@@ -1028,11 +1369,55 @@ void napsat::NapSAT::select_watched_literals(Tlit* lits, unsigned size)
   lits[second_index] = tmp;
 }
 
+Tclause napsat::NapSAT::allocate_clause(unsigned size, bool learned, bool external)
+{
+  Tclause cl;
+  if (_deleted_clauses.empty() || _preprocessing) {
+    cl = _clauses.allocate(size, learned, external);
+    _activities.push_back(_max_clause_activity);
+    _vivified.push_back(false);
+  }
+  else {
+    cl = _deleted_clauses.back();
+    ASSERT(cl < _clauses.size());
+    _deleted_clauses.pop_back();
+    ASSERT(_clauses[cl].deleted);
+    ASSERT(!_clauses[cl].watched);
+    _clauses.reallocate(cl, size, learned, external);
+  }
+  _activities[cl] = _max_clause_activity;
+  _vivified[cl] = false;
+  return cl;
+}
+
+void napsat::NapSAT::attach_clause(Tclause cl)
+{
+  const TSclause& clause = _clauses[cl];
+  ASSERT(clause.size >= 2);
+  const Tlit* lits = clause.lits();
+  if (clause.size == 2) {
+    NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Binary clause added"));
+    _binary_clauses[lits[0]].push_back(make_pair(lits[1], cl));
+    _binary_clauses[lits[1]].push_back(make_pair(lits[0], cl));
+    NOTIFY_OBSERVER(_observer, new napsat::gui::watch(cl, lits[0]));
+    NOTIFY_OBSERVER(_observer, new napsat::gui::watch(cl, lits[1]));
+    return;
+  }
+  watch_lit(lits[0], cl);
+  watch_lit(lits[1], cl);
+}
+
 Tclause napsat::NapSAT::internal_add_clause(const Tlit* lits_input, unsigned input_size, bool learned, bool external)
 {
   ASSERT(lits_input != nullptr);
-  for (unsigned i = 0; i < input_size; i++)
-    bump_var_activity(lit_to_var(lits_input[i]));
+  if (input_size > TSclause::MAX_SIZE) {
+    LOG_ERROR("The clause has " << input_size << " literals, the maximum is " << TSclause::MAX_SIZE << ".");
+    return CLAUSE_UNDEF;
+  }
+  // the VMTF queue is only updated by conflicts
+  if (_decision_heuristic == DECISION_VSIDS)
+    for (unsigned i = 0; i < input_size; i++)
+      bump_var_activity(lit_to_var(lits_input[i]));
   Tlit* lits;
   Tclause cl;
   TSclause* clause;
@@ -1060,36 +1445,10 @@ Tclause napsat::NapSAT::internal_add_clause(const Tlit* lits_input, unsigned inp
 
   unsigned clause_size = input_size - n_removed;
 
-  if (_deleted_clauses.empty()) {
-    lits = new Tlit[clause_size];
-    TSclause added(lits, clause_size, learned, external);
-    _clauses.push_back(added);
-    _clauses_sizes.push_back(clause_size);
-    _activities.push_back(_max_clause_activity);
-    clause = &_clauses.back();
-    cl = _clauses.size() - 1;
-  }
-  else {
-    cl = _deleted_clauses.back();
-    ASSERT(cl < _clauses.size());
-    _deleted_clauses.pop_back();
-    clause = &_clauses[cl];
-    ASSERT(clause->deleted);
-    ASSERT(!clause->watched);
-    if (_clauses_sizes[cl] < clause_size) {
-      delete[] clause->lits;
-      clause->lits = new Tlit[clause_size];
-      _clauses_sizes[cl] = clause_size;
-    }
-    // fill the end of the clause with LIT_UNDEF for printing purposes
-    // Note that this is not necessary for the solver
-    for (unsigned i = clause_size; i < _clauses_sizes[cl]; i++)
-      clause->lits[i] = LIT_UNDEF;
-
-    lits = clause->lits;
-    *clause = TSclause(lits, clause_size, learned, external);
-  }
-
+  cl = allocate_clause(clause_size, learned, external);
+  // The clause store may have been reallocated, so the header is fetched only now
+  clause = &_clauses[cl];
+  lits = clause->lits();
 
   // copy the literals to the clause
   if (n_removed == 0)
@@ -1118,6 +1477,12 @@ Tclause napsat::NapSAT::internal_add_clause(const Tlit* lits_input, unsigned inp
     clause->size = clause_size;
   }
 
+  // the input clauses are not written, and the removal of the root literals is justified by unit propagation
+  if (_drat && !external)
+    _drat->add_clause(lits_input, input_size);
+  else if (_drat && n_removed > 0)
+    _drat->add_clause(lits, clause_size);
+
   if (_proof && external) {
     _proof->input_clause(cl, lits_input, input_size);
     // Remove the literals falsified at level 0 in the proof
@@ -1125,7 +1490,6 @@ Tclause napsat::NapSAT::internal_add_clause(const Tlit* lits_input, unsigned inp
       _proof->remove_root_literals(cl);
   }
 
-  _activities[cl] = _max_clause_activity;
   #if USE_OBSERVER
   if (_observer) {
     vector<Tlit> lits_vector;
@@ -1158,12 +1522,7 @@ Tclause napsat::NapSAT::internal_add_clause(const Tlit* lits_input, unsigned inp
     return cl;
   }
   else if (clause_size == 2) {
-    NOTIFY_OBSERVER(_observer, new napsat::gui::stat("Binary clause added"));
-    // clause->watched = false;
-    _binary_clauses[lits[0]].push_back(make_pair(lits[1], cl));
-    _binary_clauses[lits[1]].push_back(make_pair(lits[0], cl));
-    NOTIFY_OBSERVER(_observer, new napsat::gui::watch(cl, lits[0]));
-    NOTIFY_OBSERVER(_observer, new napsat::gui::watch(cl, lits[1]));
+    attach_clause(cl);
     if (lit_false(lits[0]) && !lit_false(lits[1])) {
       // swap the literals so that the false literal is at the second position
       lits[1] = lits[0] ^ lits[1];
@@ -1178,15 +1537,13 @@ Tclause napsat::NapSAT::internal_add_clause(const Tlit* lits_input, unsigned inp
         repair_conflict(cl);
       else if (_options.lazy_strong_chronological_backtracking) {
         ASSERT(lit_true(lits[0]));
-        if (lit_lazy_reason(lits[0]) == CLAUSE_UNDEF || lit_level(_clauses[lit_lazy_reason(lits[0])].lits[1]) > lit_level(lits[0]))
-          lit_set_lazy_reason(lits[1], cl);
+        reimply_literal(lits[0], cl);
       }
     }
   }
   else {
     select_watched_literals(lits, clause_size);
-    watch_lit(lits[0], cl);
-    watch_lit(lits[1], cl);
+    attach_clause(cl);
     if (lit_false(lits[0]))
       repair_conflict(cl);
     else if (lit_false(lits[1]) && lit_undef(lits[0]))
@@ -1207,23 +1564,42 @@ Tclause napsat::NapSAT::internal_add_clause(const Tlit* lits_input, unsigned inp
 /*****************************************************************************/
 
 napsat::NapSAT::NapSAT(unsigned n_var, unsigned n_clauses, napsat::options& options) :
-  _options(options)
+  _options(options),
+  _random(options.seed)
 {
   _vars = vector<TSvar>(n_var + 1);
+  _lit_values.resize(2 * n_var + 2 + LIT_VALUES_PADDING, VAR_UNDEF);
+  _levels.resize(n_var + 1, LEVEL_UNDEF);
+  _theory_reasons.resize(n_var + 1);
+  _target_phase.resize(n_var + 1, VAR_UNDEF);
+  _best_phase.resize(n_var + 1, VAR_UNDEF);
+  _original_phase.resize(n_var + 1, 0);
+  _next_rephase = options.rephase_interval;
   _trail = vector<Tlit>();
   _trail.reserve(n_var);
   _watch_lists.resize(2 * n_var + 2);
+  _binary_clauses.resize(2 * n_var + 2);
+  _watch_list_dirty.resize(2 * n_var + 2, false);
+
+  if (options.decision_heuristic == "vmtf")
+    _decision_heuristic = DECISION_VMTF;
+  else {
+    ASSERT(options.decision_heuristic == "vsids");
+    _decision_heuristic = DECISION_VSIDS;
+  }
 
   for (Tvar var = 1; var <= n_var; var++) {
     NOTIFY_OBSERVER(_observer, new napsat::gui::new_variable(var));
-    _variable_heap.insert(var, 0);
+    enqueue_var(var);
+    if (options.seed)
+      _vars[var].phase_cache = _original_phase[var] = _random() & 1;
   }
 
-  _clauses = vector<TSclause>();
   _clauses.reserve(n_clauses);
   _activities.reserve(n_clauses);
 
-  _literal_buffer = new Tlit[n_var];
+  _literal_buffer_size = n_var + 1;
+  _literal_buffer = new Tlit[_literal_buffer_size];
   _next_literal_index = 0;
 
 #if USE_OBSERVER
@@ -1257,18 +1633,50 @@ napsat::NapSAT::NapSAT(unsigned n_var, unsigned n_clauses, napsat::options& opti
     _proof = new napsat::proof::resolution_proof();
   else
     _proof = nullptr;
+  if (options.proof_file != "") {
+    _drat = new napsat::proof::drat_writer(options.proof_file, options.binary_proof);
+    if (!_drat->is_open())
+      _status = ERROR;
+  }
+
+  _profiler.set_enabled(options.benchmark);
+
+  if (options.lazy_strong_chronological_backtracking)
+    _backtracking_mode = BACKTRACK_LSCB;
+  else if (options.restoring_strong_chronological_backtracking)
+    _backtracking_mode = BACKTRACK_RSCB;
+  else if (options.chronological_backtracking)
+    _backtracking_mode = BACKTRACK_WCB;
+  else
+    _backtracking_mode = BACKTRACK_NCB;
+
+  if (options.restart_policy == "luby")
+    _restart_policy = RESTART_LUBY;
+  else if (options.restart_policy == "geometric")
+    _restart_policy = RESTART_GEOMETRIC;
+  else if (options.restart_policy == "glucose")
+    _restart_policy = RESTART_GLUCOSE;
+  else {
+    ASSERT(options.restart_policy == "agility");
+    _restart_policy = RESTART_AGILITY;
+  }
+  _restart_limit = options.restart_interval;
+  _lbd_ema_fast = utils::ema(options.restart_ema_fast);
+  _lbd_ema_slow = utils::ema(options.restart_ema_slow);
 }
 
 NapSAT::~NapSAT()
 {
-  for (unsigned i = 0; i < _clauses.size(); i++)
-    delete[] _clauses[i].lits;
 #if USE_OBSERVER
   if (_observer)
     delete _observer;
 #endif
   if (_proof)
     delete _proof;
+  if (_drat)
+    delete _drat;
+  for (propagator* p : _propagators)
+    delete p;
   delete[] _literal_buffer;
 }
 
@@ -1296,51 +1704,136 @@ napsat::gui::observer* napsat::NapSAT::get_observer() const
 #endif
 }
 
+template <napsat::NapSAT::backtracking_mode MODE>
 bool NapSAT::propagate()
 {
   // ASSERT(watch_lists_complete());
   // ASSERT(watch_lists_minimal());
   if (_status != UNDEF)
     return false;
+  utils::profiler::scope timer(_profiler, utils::PHASE_PROPAGATE);
   while (_propagated_literals < _trail.size()) {
     Tlit lit = _trail[_propagated_literals];
-    Tclause conflict = propagate_binary_clauses(lit);
+    Tclause conflict = propagate_binary_clauses<MODE>(lit);
     if (conflict == CLAUSE_UNDEF)
-      conflict = propagate_lit(lit);
+      conflict = propagate_lit<MODE>(lit);
+    if (conflict == CLAUSE_UNDEF && !_propagators.empty())
+      conflict = propagate_theory(lit);
     if (conflict == CLAUSE_UNDEF) {
       _vars[lit_to_var(lit)].propagated = true;
       _propagated_literals++;
+      _stats.propagations++;
       NOTIFY_OBSERVER(_observer, new napsat::gui::propagation(lit));
       continue;
     }
     NOTIFY_OBSERVER(_observer, new napsat::gui::conflict(conflict));
-    repair_conflict(conflict);
-    if (_status == UNSAT)
+    repair_conflict<MODE>(conflict);
+    if (_status == UNSAT || termination_requested())
       return false;
-    if (_agility < _options.agility_threshold)
+    if (restart_needed())
       restart();
+    if (_options.memory_limit && _stats.conflicts >= _next_memory_check)
+      check_memory_budget();
   }
-  if (_trail.size() == _vars.size() - 1) {
+  // a falsified assumption is detected by the next decision
+  if (_trail.size() + _eliminated_vars.size() == _vars.size() - 1 && assumptions_satisfied()) {
     _status = SAT;
     return false;
   }
   return true;
 }
 
+bool NapSAT::propagate()
+{
+  switch (_backtracking_mode) {
+  case BACKTRACK_NCB:
+    return propagate<BACKTRACK_NCB>();
+  case BACKTRACK_WCB:
+    return propagate<BACKTRACK_WCB>();
+  case BACKTRACK_RSCB:
+    return propagate<BACKTRACK_RSCB>();
+  default:
+    ASSERT(_backtracking_mode == BACKTRACK_LSCB);
+    return propagate<BACKTRACK_LSCB>();
+  }
+}
+
 status NapSAT::solve()
 {
-  if (_status != UNDEF)
+  return solve(nullptr, 0);
+}
+
+status NapSAT::solve(const Tlit* assumptions, unsigned n)
+{
+  reset_search();
+  if (_status != UNDEF) {
+    write_empty_clause();
+    _interrupted = false;
     return _status;
+  }
+  ASSERT(_assumptions.empty() && _failed_assumptions.empty());
+  // the decisions taken through the interface would be mistaken for assumptions
+  if (n > 0)
+    backtrack(LEVEL_ROOT);
+  for (unsigned i = 0; i < n; i++) {
+    var_allocate(lit_to_var(assumptions[i]));
+    _assumptions.push_back(assumptions[i]);
+  }
+  _assumption_index = 0;
+  if (eliminated_literal(assumptions, n))
+    restore_eliminated_variables();
+  if (_options.preprocess && !_preprocessed)
+    preprocess();
+  {
+    utils::profiler::scope timer(_profiler, utils::PHASE_SEARCH);
+    switch (_backtracking_mode) {
+    case BACKTRACK_NCB:
+      search<BACKTRACK_NCB>();
+      break;
+    case BACKTRACK_WCB:
+      search<BACKTRACK_WCB>();
+      break;
+    case BACKTRACK_RSCB:
+      search<BACKTRACK_RSCB>();
+      break;
+    default:
+      ASSERT(_backtracking_mode == BACKTRACK_LSCB);
+      search<BACKTRACK_LSCB>();
+    }
+  }
+  write_empty_clause();
+  _interrupted = false;
+  return _status;
+}
+
+void NapSAT::write_empty_clause()
+{
+  if (!_drat)
+    return;
+  // an unsatisfiable set of assumptions does not refute the formula
+  if (_status == UNSAT && _failed_assumptions.empty())
+    _drat->add_clause(nullptr, 0);
+  _drat->flush();
+}
+
+template <napsat::NapSAT::backtracking_mode MODE>
+status NapSAT::search()
+{
   while (true) {
+    if (termination_requested())
+      return _status;
     NOTIFY_OBSERVER(_observer, new napsat::gui::check_invariants());
-    if (!propagate()) {
+    if (!propagate<MODE>()) {
+      // the search was stopped by the termination flag
+      if (_status == UNDEF)
+        return _status;
       if (_status == UNSAT || !_options.interactive)
         break;
       NOTIFY_OBSERVER(_observer, new napsat::gui::done(_status == SAT));
     }
     NOTIFY_OBSERVER(_observer, new napsat::gui::check_invariants());
     if (_n_root_lvl_lits >= _purge_threshold
-    && ((!_options.weak_chronological_backtracking && !_options.restoring_strong_chronological_backtracking)
+    && ((MODE != BACKTRACK_WCB && MODE != BACKTRACK_RSCB)
        || solver_level() == LEVEL_ROOT)) {
       // in WCB and RSCB, missed lower implications can be a problem when purging clauses.
       // this is the same trick as in CaDiCaL, but we might be able to do better
@@ -1352,6 +1845,18 @@ status NapSAT::solve()
       // therefore we cannot take a decision before we propagate
       continue;
     }
+    // at level 0, the imported clauses cannot conflict with the decisions
+    if (_exchange && solver_level() == LEVEL_ROOT && _stats.conflicts != _conflicts_at_import
+    && import_clauses()) {
+      if (_status == UNSAT)
+        return _status;
+      continue;
+    }
+    if (_vivification_pending) {
+      vivify_clauses();
+      // the vivified clauses may imply literals at level 0
+      continue;
+    }
     NOTIFY_OBSERVER(_observer, new napsat::gui::check_invariants());
 #if USE_OBSERVER
     if (_observer && _options.interactive)
@@ -1372,16 +1877,64 @@ status NapSAT::get_status()
   return _status;
 }
 
+void napsat::NapSAT::set_termination_flag(const std::atomic<bool>* flag)
+{
+  _termination_flag = flag;
+}
+
+void napsat::NapSAT::set_conflict_budget(unsigned long n)
+{
+  _conflict_limit = n == 0 ? ULONG_MAX : _stats.conflicts + n;
+}
+
+void napsat::NapSAT::set_propagation_budget(unsigned long n)
+{
+  _propagation_limit = n == 0 ? ULONG_MAX : _stats.propagations + n;
+}
+
+void napsat::NapSAT::set_time_budget(double seconds)
+{
+  _time_limited = seconds > 0;
+  if (!_time_limited)
+    return;
+  auto budget = std::chrono::duration<double>(seconds);
+  _time_limit = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget);
+  _time_check_countdown = 0;
+}
+
+void napsat::NapSAT::interrupt()
+{
+  _interrupted = true;
+}
+
+void napsat::NapSAT::set_clause_exchange(utils::clause_exchange* exchange, unsigned id)
+{
+  ASSERT(!exchange || !_proof);
+  ASSERT(!exchange || id < exchange->workers());
+  _exchange = exchange;
+  _exchange_id = id;
+}
+
 bool NapSAT::decide()
 {
-  while (!_variable_heap.empty() && !var_undef(_variable_heap.top()))
-    _variable_heap.pop();
-  if (_variable_heap.empty()) {
+  if (decide_assumption())
+    return _status == UNDEF;
+  while (!_vivification_decisions.empty()) {
+    Tlit lit = _vivification_decisions.back();
+    _vivification_decisions.pop_back();
+    if (!lit_undef(lit))
+      continue;
+    _stats.decisions++;
+    imply_literal(lit, CLAUSE_UNDEF);
+    return true;
+  }
+  Tvar var = next_decision_var();
+  if (var == 0) {
     _status = SAT;
     return false;
   }
-  Tvar var = _variable_heap.top();
-  Tlit lit = literal(var, _vars[var].phase_cache);
+  Tlit lit = literal(var, decision_phase(var));
+  _stats.decisions++;
   imply_literal(lit, CLAUSE_UNDEF);
   return true;
 }
@@ -1389,6 +1942,8 @@ bool NapSAT::decide()
 bool napsat::NapSAT::decide(Tlit lit)
 {
   ASSERT(lit_undef(lit));
+  ASSERT(!_vars[lit_to_var(lit)].eliminated);
+  _stats.decisions++;
   imply_literal(lit, CLAUSE_UNDEF);
   return true;
 }
@@ -1413,6 +1968,9 @@ napsat::Tclause NapSAT::finalize_clause()
 {
   ASSERT(_writing_clause);
   _writing_clause = false;
+  reset_search();
+  if (eliminated_literal(_literal_buffer, _next_literal_index))
+    restore_eliminated_variables();
   Tclause cl = internal_add_clause(_literal_buffer, _next_literal_index, false, true);
   return cl;
 }
@@ -1424,14 +1982,118 @@ napsat::Tclause napsat::NapSAT::add_clause(const Tlit* lits, unsigned size)
     if (lit_to_var(lits[i]) > max_var)
       max_var = lit_to_var(lits[i]);
   var_allocate(max_var);
+  reset_search();
+  if (eliminated_literal(lits, size))
+    restore_eliminated_variables();
   Tclause cl = internal_add_clause(lits, size, false, true);
   return cl;
 }
 
+void napsat::NapSAT::add_clauses(const Tlit* lits, const unsigned* offsets, unsigned n_clauses)
+{
+  if (n_clauses == 0)
+    return;
+  const Tlit* first = lits + offsets[0];
+  unsigned n_lits = offsets[n_clauses] - offsets[0];
+  Tvar max_var = 0;
+  for (unsigned i = 0; i < n_lits; i++)
+    max_var = max(max_var, lit_to_var(first[i]));
+  var_allocate(max_var);
+  reset_search();
+  if (eliminated_literal(first, n_lits))
+    restore_eliminated_variables();
+
+  bool direct = !_proof;
+#if USE_OBSERVER
+  direct = direct && !_observer;
+#endif
+  // first pass: select the clauses added directly, and count their entries in the binary and watch lists
+  vector<unsigned> delayed;
+  vector<unsigned> binary_entries(_watch_lists.size(), 0);
+  vector<unsigned> watch_entries(_watch_lists.size(), 0);
+  unsigned n_direct_lits = 0;
+  for (unsigned i = 0; i < n_clauses; i++) {
+    const Tlit* clause_lits = lits + offsets[i];
+    unsigned size = offsets[i + 1] - offsets[i];
+    bool added = direct && size >= 2 && size <= TSclause::MAX_SIZE;
+    unsigned j = 0;
+    for (; added && j < size; j++) {
+      Tvar var = lit_to_var(clause_lits[j]);
+      added = !_vars[var].seen && var_undef(var);
+      _vars[var].seen = true;
+    }
+    for (unsigned k = 0; k < j; k++)
+      _vars[lit_to_var(clause_lits[k])].seen = false;
+    if (!added) {
+      delayed.push_back(i);
+      continue;
+    }
+    n_direct_lits += size;
+    vector<unsigned>& entries = size == 2 ? binary_entries : watch_entries;
+    entries[clause_lits[0]]++;
+    entries[clause_lits[1]]++;
+  }
+
+  unsigned n_direct = n_clauses - delayed.size();
+  _clauses.reserve_more(n_direct, n_direct_lits);
+  _activities.reserve(_activities.size() + n_direct);
+  _vivified.reserve(_vivified.size() + n_direct);
+  for (Tlit lit = 0; lit < _watch_lists.size(); lit++) {
+    if (binary_entries[lit] > 0)
+      _binary_clauses[lit].reserve(_binary_clauses[lit].size() + binary_entries[lit]);
+    if (watch_entries[lit] > 0)
+      _watch_lists[lit].reserve(_watch_lists[lit].size() + watch_entries[lit]);
+  }
+
+  // second pass: copy the clauses and watch the first two literals, which are all unassigned
+  for (unsigned i = 0, next_delayed = 0; i < n_clauses; i++) {
+    if (next_delayed < delayed.size() && delayed[next_delayed] == i) {
+      next_delayed++;
+      continue;
+    }
+    const Tlit* clause_lits = lits + offsets[i];
+    unsigned size = offsets[i + 1] - offsets[i];
+    Tclause cl = _clauses.allocate(size, false, true);
+    _activities.push_back(_max_clause_activity);
+    _vivified.push_back(false);
+    memcpy(_clauses[cl].lits(), clause_lits, size * sizeof(Tlit));
+    if (_decision_heuristic == DECISION_VSIDS)
+      for (unsigned j = 0; j < size; j++)
+        _vars[lit_to_var(clause_lits[j])].activity += _var_activity_increment;
+    if (size == 2) {
+      _binary_clauses[clause_lits[0]].push_back(make_pair(clause_lits[1], cl));
+      _binary_clauses[clause_lits[1]].push_back(make_pair(clause_lits[0], cl));
+      continue;
+    }
+    watch_lit(clause_lits[0], cl);
+    watch_lit(clause_lits[1], cl);
+  }
+  _next_clause_elimination += n_direct;
+
+  // the heap is ordered once for the whole batch instead of once per literal
+  if (_decision_heuristic == DECISION_VSIDS && n_direct > 0) {
+    double max_activity = 0;
+    for (Tvar var = 1; var < _vars.size(); var++)
+      max_activity = max(max_activity, _vars[var].activity);
+    if (max_activity > 1e100) {
+      for (Tvar var = 1; var < _vars.size(); var++)
+        _vars[var].activity *= 1e-100;
+      _var_activity_increment *= 1e-100;
+    }
+    _variable_heap.rebuild([this](unsigned var) { return _vars[var].activity; });
+  }
+
+  for (unsigned i : delayed) {
+    internal_add_clause(lits + offsets[i], offsets[i + 1] - offsets[i], false, true);
+    if (_status == UNSAT)
+      return;
+  }
+}
+
 const Tlit* napsat::NapSAT::get_clause(Tclause cl) const
 {
   assert(cl < _clauses.size());
-  return _clauses[cl].lits;
+  return _clauses[cl].lits();
 }
 
 unsigned napsat::NapSAT::get_clause_size(Tclause cl) const
@@ -1445,6 +2107,7 @@ void NapSAT::hint(Tlit lit)
   ASSERT(lit_to_var(lit) < _vars.size());
   ASSERT(!_writing_clause);
   ASSERT(lit_undef(lit));
+  ASSERT(!_vars[lit_to_var(lit)].eliminated);
   imply_literal(lit, CLAUSE_LAZY);
 }
 
@@ -1455,14 +2118,14 @@ void NapSAT::hint(Tlit lit, unsigned int level)
   ASSERT(lit_undef(lit));
   ASSERT(level <= solver_level() + 1);
   hint(lit);
-  _vars[lit_to_var(lit)].level = level;
+  _levels[lit_to_var(lit)] = level;
 }
 
 void NapSAT::synchronize()
 {
   _number_of_valid_literals = _trail.size();
   for (Tvar var : _touched_variables)
-    _vars[var].state_last_sync = _vars[var].state;
+    _vars[var].state_last_sync = _lit_values[literal(var, 1)];
 
   _touched_variables.clear();
 }
@@ -1475,9 +2138,10 @@ unsigned NapSAT::sync_validity_limit()
 unsigned NapSAT::sync_color(Tvar var)
 {
   ASSERT(var < _vars.size() && var > 0);
-  if (_vars[var].state == _vars[var].state_last_sync)
+  Tval state = _lit_values[literal(var, 1)];
+  if (state == _vars[var].state_last_sync)
     return 0;
-  if (VAR_UNDEF == _vars[var].state)
+  if (VAR_UNDEF == state)
     return 1;
   if (VAR_UNDEF == _vars[var].state_last_sync)
     return 2;
@@ -1510,5 +2174,5 @@ bool napsat::NapSAT::check_proof()
 {
   ASSERT(_proof);
   ASSERT(_status == UNSAT)
-  return _proof->check_proof();
+  return _proof->check_proof(_options.check_proof_threads);
 }
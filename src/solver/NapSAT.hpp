@@ -99,13 +99,23 @@
 #include "SAT-options.hpp"
 #include "custom-assert.hpp"
 #include "../proof/proof.hpp"
+#include "../proof/drat.hpp"
 #include "../utils/printer.hpp"
 #include "../utils/heap.hpp"
+#include "../utils/vmtf.hpp"
+#include "../utils/profiler.hpp"
+#include "../utils/ema.hpp"
+#include "../utils/clause-exchange.hpp"
+#include "cardinality-propagator.hpp"
 #include "../observer/SAT-notification.hpp"
 #include "../observer/SAT-observer.hpp"
 
 #include <vector>
 #include <set>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <random>
 #include <iostream>
 #include <cstring>
 #include <cassert>
@@ -127,6 +137,8 @@ namespace napsat
 {
   class NapSAT
   {
+    friend class propagator;
+
   public:
 #ifndef TEST
   private:
@@ -136,24 +148,24 @@ namespace napsat
     /*************************************************************************/
     /**
      * @brief Structure to store the state an metadata of a propositional variable.
+     * @details The value and the level of the variable are read for each literal
+     * visited by the propagation, and are stored in the dense arrays
+     * _lit_values and _levels instead. The structure only contains the data
+     * accessed once per assignment or in conflict analysis.
      */
     typedef struct TSvar
     {
       TSvar()
-        : level(LEVEL_UNDEF),
-        reason(CLAUSE_UNDEF),
+        : reason(CLAUSE_UNDEF),
         activity(0.0),
         seen(false),
+        removable(false),
+        poison(false),
         propagated(false),
-        state(VAR_UNDEF),
+        eliminated(false),
         phase_cache(0),
         state_last_sync(VAR_UNDEF)
       {}
-      /**
-       * @brief Decision level at which the variable was assigned.
-       * @details If the variable is unassigned, the level is LEVEL_UNDEF.
-       */
-      Tlevel level;
       /**
        * @brief Clause that propagated the variable.
        * @details If the variable is assigned by a decision, the reason is
@@ -173,15 +185,29 @@ namespace napsat
        * the method, all variables must be unmarked.
        */
       unsigned seen : 1;
+      /**
+       * @brief Boolean indicating that the literal of the variable is implied
+       * by the literals of the learned clause being minimized.
+       * @details Like seen, variables must remain marked locally.
+       */
+      unsigned removable : 1;
+      /**
+       * @brief Boolean indicating that the literal of the variable is not
+       * implied by the literals of the learned clause being minimized.
+       * @details Like seen, variables must remain marked locally.
+       */
+      unsigned poison : 1;
       /**
        * @brief Boolean indicating whether the variable is in the propagation
        * queue.
        */
       unsigned propagated : 1;
       /**
-       * @brief State of the variable. Can be VAR_TRUE, VAR_FALSE or VAR_UNDEF.
+       * @brief Boolean indicating whether the variable was eliminated by the
+       * preprocessing. Eliminated variables occur in no clause and are never
+       * assigned.
        */
-      Tval state : 2;
+      unsigned eliminated : 1;
       /**
        * @brief Last value assigned to the variable.
        * @note Used to compute the agility of the solver
@@ -204,37 +230,83 @@ namespace napsat
        *          ∧ δ(λ(ℓ) \ {ℓ}) < δ(ℓ)
        */
       Tclause missed_lower_implication = CLAUSE_UNDEF;
+
+      /**
+       * @brief Level at which the missed lower implication would propagate
+       * the variable, that is δ(λ(ℓ) \ {ℓ}), or LEVEL_UNDEF if there is none.
+       * @details Cached when the missed lower implication is set, such that
+       * backtracking does not have to scan the clause again. The falsified
+       * literals of λ(ℓ) stay on the trail as long as ℓ does, so the cached
+       * level cannot become stale.
+       */
+      Tlevel lazy_level = LEVEL_UNDEF;
     } TSvar;
 
-#define CLAUSE_HEAD_SIZE 5
+    /**
+     * @brief Number of 32-bit words used by the header of a clause in the
+     * clause store. The literals of the clause are stored right after it.
+     */
+#define CLAUSE_HEAD_SIZE 3
+
+    /**
+     * @brief Largest literal block distance stored in a clause header. Larger
+     * distances are saturated to this value.
+     */
+#define CLAUSE_MAX_LBD 127
+
+    /**
+     * @brief Tiers of the learned clauses. The tier of a clause determines how
+     * it is treated by the clause deletion procedure (see simplify_clause_set).
+     * @details Core clauses (low LBD) are never deleted. Tier 2 clauses are
+     * kept as long as they are used between two reductions, and are demoted to
+     * the local tier otherwise. Local clauses are deleted by order of
+     * decreasing LBD and increasing activity.
+     */
+    enum clause_tier
+    {
+      TIER_CORE = 0,
+      TIER_2 = 1,
+      TIER_LOCAL = 2
+    };
 
     /**
-     * @brief Structure to store a clause and its metadata.
+     * @brief Header of a clause and its metadata.
+     * @details The header lives in the clause store, and the literals of the
+     * clause are stored inline right after the header. Therefore, a TSclause
+     * must never be copied by value, always manipulate it by reference.
      */
-    typedef struct  alignas(16) TSclause
+    typedef struct TSclause
     {
       /**
-       * @brief Constructor of the clause.
-       * @details This constructor is destructive. It initializes uses the
-       * memory of the lits pointer to store the clause.
+       * @brief Maximum number of literals of a clause, bounded by the width of
+       * the size and capacity fields.
+       */
+      static constexpr unsigned MAX_SIZE = (1 << 25) - 1;
+
+      /**
+       * @brief Constructor of the clause header.
+       * @details The literals are not initialized. They are stored in the
+       * capacity words following the header.
       */
-      TSclause(Tlit* lits, unsigned size, bool learned, bool external) :
-        lits(lits),
+      TSclause(unsigned size, bool learned, bool external, unsigned capacity) :
         deleted(false),
         learned(learned),
         watched(true),
         external(external),
+        used(true),
+        tier(TIER_LOCAL),
         size(size),
-        blocker(LIT_UNDEF)
+        blocker(LIT_UNDEF),
+        capacity(capacity),
+        lbd(std::min(size, (unsigned) CLAUSE_MAX_LBD))
       {
-        assert(size < (1 << 28));
+        assert(capacity <= MAX_SIZE);
+        assert(size <= capacity);
       }
-      /**
-       * @brief Pointer to the first literal of the clause.
-       * @details The two first literals (if they exist) are the watched
-       * literals.
-       */
-      Tlit* lits;
+
+      TSclause(const TSclause&) = delete;
+      TSclause& operator=(const TSclause&) = delete;
+
       /**
        * @brief Boolean indicating whether the clause is deleted. That is, the
        * clause is not in the clause set anymore and the memory is available
@@ -256,19 +328,249 @@ namespace napsat
        */
       unsigned external : 1;
       /**
-       * @brief Size of the clause when it was added to the clause set
-       * @details Used to know the size of the allocated memory.
+       * @brief Boolean indicating whether the clause was used in conflict
+       * analysis since the last clause deletion.
        */
-      unsigned size : 28;
+      unsigned used : 1;
+      /**
+       * @brief Tier of a learned clause (see clause_tier).
+       */
+      unsigned tier : 2;
+      /**
+       * @brief Current size of the clause.
+       * @details Literals removed from the clause (e.g. falsified at level 0)
+       * are kept after the size, up to the capacity, for printing purposes.
+       */
+      unsigned size : 25;
       /**
        * @brief Blocking literal. If the clause is satisfied by the blocking
        * literal, the watched literals are allowed to be falsified.
        * @details In chronological backtracking, the blocking literal must be
        * at a lower level than the watched literals.
+       * The watch lists hold copies of the blocker (see TSwatch). This field
+       * is the most recent blocker, used to initialise new watches.
        */
       Tlit blocker = LIT_UNDEF;
+      /**
+       * @brief Number of literals that can be stored after the header.
+       * @details Since we might remove literals from the clauses, we need to
+       * know the original size of the allocated memory to not reallocate the
+       * memory when it is not necessary.
+       */
+      unsigned capacity : 25;
+      /**
+       * @brief Literal block distance of the clause, that is, the number of
+       * distinct decision levels among its literals when it was learned or
+       * last used in conflict analysis. Saturated at CLAUSE_MAX_LBD.
+       */
+      unsigned lbd : 7;
+
+      /**
+       * @brief Pointer to the first literal of the clause.
+       * @details The two first literals (if they exist) are the watched
+       * literals.
+       */
+      inline Tlit* lits()
+      {
+        return reinterpret_cast<Tlit*>(this) + CLAUSE_HEAD_SIZE;
+      }
+      inline const Tlit* lits() const
+      {
+        return reinterpret_cast<const Tlit*>(this) + CLAUSE_HEAD_SIZE;
+      }
     } TSclause;
 
+    static_assert(sizeof(TSclause) == CLAUSE_HEAD_SIZE * sizeof(Tlit),
+                  "The clause header must fit in CLAUSE_HEAD_SIZE words");
+
+    /**
+     * @brief Entry of a watch list.
+     * @details The blocker is a copy of a blocking literal of the clause. It
+     * allows to skip satisfied clauses in propagate_lit without accessing the
+     * clause itself. The two entries of a clause may hold different blockers,
+     * but both are literals of the clause.
+     */
+    typedef struct TSwatch
+    {
+      /**
+       * @brief If the blocker is satisfied at an appropriate level, the clause
+       * does not need to be visited.
+       */
+      Tlit blocker;
+      /**
+       * @brief The watched clause.
+       */
+      Tclause cl;
+    } TSwatch;
+
+    /**
+     * @brief Contiguous region storing the clauses of the solver.
+     * @details Each clause is stored as a header (TSclause) directly followed
+     * by its literals, such that visiting a clause touches a single memory
+     * region. Clauses are addressed by their ID, which is mapped to the offset
+     * of the header in the region. The ID of a clause never changes, even
+     * when the region is compacted, which keeps the proof and the observer
+     * consistent.
+     * @warning Allocating a clause may reallocate the region. References to
+     * headers and pointers to literals must not be held across an allocation
+     * or a compaction.
+     */
+    class clause_store
+    {
+    private:
+      /**
+       * @brief Memory of the region. Headers and literals are interleaved.
+       */
+      std::vector<Tlit> _memory;
+      /**
+       * @brief _offsets[cl] is the position of the header of cl in _memory.
+       */
+      std::vector<unsigned> _offsets;
+      /**
+       * @brief Number of words in _memory that are not used by a live clause.
+       */
+      unsigned _wasted = 0;
+
+      /**
+       * @brief Appends a new header with the given capacity at the end of the
+       * region and returns its offset.
+       */
+      inline unsigned append(unsigned size, bool learned, bool external,
+                             unsigned capacity)
+      {
+        unsigned offset = _memory.size();
+        _memory.resize(offset + CLAUSE_HEAD_SIZE + capacity, LIT_UNDEF);
+        new (&_memory[offset]) TSclause(size, learned, external, capacity);
+        return offset;
+      }
+
+    public:
+      inline TSclause& operator[](Tclause cl)
+      {
+        assert(cl < _offsets.size());
+        return *reinterpret_cast<TSclause*>(&_memory[_offsets[cl]]);
+      }
+
+      inline const TSclause& operator[](Tclause cl) const
+      {
+        assert(cl < _offsets.size());
+        return *reinterpret_cast<const TSclause*>(&_memory[_offsets[cl]]);
+      }
+
+      /**
+       * @brief Number of clause IDs in the store, deleted clauses included.
+       */
+      inline size_t size() const { return _offsets.size(); }
+
+      /**
+       * @brief Number of words allocated in the region.
+       */
+      inline size_t memory_size() const { return _memory.size(); }
+
+      /**
+       * @brief Number of words in the region that are not used by a live
+       * clause.
+       */
+      inline size_t wasted() const { return _wasted; }
+
+      /**
+       * @brief Number of bytes allocated for the region and the offsets.
+       */
+      inline size_t memory_bytes() const
+      {
+        return _memory.capacity() * sizeof(Tlit) + _offsets.capacity() * sizeof(unsigned);
+      }
+
+      /**
+       * @brief Reserves memory for n_clauses clauses of average size
+       * avg_size.
+       */
+      inline void reserve(size_t n_clauses, unsigned avg_size = 3)
+      {
+        _offsets.reserve(n_clauses);
+        _memory.reserve((size_t) n_clauses * (CLAUSE_HEAD_SIZE + avg_size));
+      }
+
+      /**
+       * @brief Reserves memory for n_clauses more clauses with n_lits
+       * literals in total, such that they are allocated in a single block.
+       */
+      inline void reserve_more(size_t n_clauses, size_t n_lits)
+      {
+        _offsets.reserve(_offsets.size() + n_clauses);
+        _memory.reserve(_memory.size() + (size_t) n_clauses * CLAUSE_HEAD_SIZE + n_lits);
+      }
+
+      /**
+       * @brief Allocates a new clause ID with room for size literals.
+       * @return the ID of the new clause.
+       */
+      inline Tclause allocate(unsigned size, bool learned, bool external)
+      {
+        _offsets.push_back(append(size, learned, external, size));
+        return _offsets.size() - 1;
+      }
+
+      /**
+       * @brief Reinitializes the deleted clause cl with room for size
+       * literals. The clause is reinitialized in place if its capacity is
+       * large enough. Otherwise, it is moved at the end of the region.
+       * @pre The clause cl is deleted.
+       */
+      inline void reallocate(Tclause cl, unsigned size, bool learned,
+                             bool external)
+      {
+        TSclause& clause = (*this)[cl];
+        assert(clause.deleted);
+        unsigned capacity = clause.capacity;
+        if (capacity >= size) {
+          assert(_wasted >= capacity);
+          _wasted -= capacity;
+          new (&clause) TSclause(size, learned, external, capacity);
+          // fill the end of the clause with LIT_UNDEF for printing purposes
+          std::fill(clause.lits(), clause.lits() + capacity, LIT_UNDEF);
+          return;
+        }
+        // the old block is not used anymore
+        assert(_wasted >= capacity);
+        _wasted += CLAUSE_HEAD_SIZE;
+        _offsets[cl] = append(size, learned, external, size);
+      }
+
+      /**
+       * @brief Marks the memory of the clause cl as reusable.
+       * @details The header of the clause remains valid until the clause is
+       * reallocated.
+       */
+      inline void release(Tclause cl)
+      {
+        _wasted += (*this)[cl].capacity;
+      }
+
+      /**
+       * @brief Moves the clauses to the beginning of the region to free the
+       * memory of deleted clauses and removed literals.
+       * @details The IDs of the clauses are unchanged. Deleted clauses keep
+       * their header with an empty capacity.
+       */
+      void compact()
+      {
+        std::vector<Tlit> memory;
+        memory.reserve(_memory.size() - _wasted);
+        for (Tclause cl = 0; cl < _offsets.size(); cl++) {
+          TSclause& clause = (*this)[cl];
+          unsigned capacity = clause.deleted ? 0 : clause.size;
+          unsigned offset = memory.size();
+          memory.insert(memory.end(), &_memory[_offsets[cl]],
+                        &_memory[_offsets[cl]] + CLAUSE_HEAD_SIZE + capacity);
+          reinterpret_cast<TSclause*>(&memory[offset])->capacity = capacity;
+          _offsets[cl] = offset;
+        }
+        _memory.swap(memory);
+        _wasted = 0;
+      }
+    };
+
     /*************************************************************************/
     /*                          Fields definitions                           */
     /*************************************************************************/
@@ -284,6 +586,26 @@ namespace napsat
      * @brief List of variables in the clause set.
      */
     std::vector<TSvar> _vars;
+    /**
+     * @brief Number of bytes allocated in _lit_values after the value of the
+     * last literal.
+     */
+    static constexpr unsigned LIT_VALUES_PADDING = 3;
+    /**
+     * @brief _lit_values[l] is VAR_TRUE if the literal l is satisfied,
+     * VAR_FALSE if it is falsified, and VAR_UNDEF otherwise.
+     * @details The values are duplicated from the state of the variables, such
+     * that the values of the literals of a clause are read without loading the
+     * variables, and can be gathered by vector instructions. The array is
+     * padded with LIT_VALUES_PADDING bytes, such that the value of any literal
+     * can be read as a 32 bit word.
+     */
+    std::vector<uint8_t> _lit_values;
+    /**
+     * @brief _levels[v] is the decision level at which the variable v was
+     * assigned, or LEVEL_UNDEF if v is unassigned.
+     */
+    std::vector<Tlevel> _levels;
     /**
      * @brief Trail of assigned literals.
      * @details The trail is divided into two parts π = τ ⋅ ω
@@ -300,34 +622,34 @@ namespace napsat
     /**
      * @brief Set of clauses
      */
-    std::vector<TSclause> _clauses;
+    clause_store _clauses;
     /**
-     * @brief List of deleted clauses. The memory of these clauses is available
-     * for reuse.
+     * @brief List of deleted clauses. The IDs and the memory of these clauses
+     * are available for reuse.
      */
     std::vector<Tclause> _deleted_clauses;
 
     /**
-     * @brief Sizes of allocated memory for the clauses.
-     * @details Since we might remove literals from the clauses, we need to know
-     * the original size of the allocated memory to not reallocate the memory
-     * when it is not necessary.
-     * @remark This information was previously stored in the TSclause structure
-     * but it was moved here to reduce the size of the TSclause structure.
-    */
-    std::vector<unsigned> _clauses_sizes;
-
-    /**
-     * @brief _watch_lists[i] is the first clause of the watch list of the
-     * literal i.
+     * @brief _watch_lists[i] is the watch list of the literal i, that is, the
+     * clauses watched by i together with their blocker.
      */
-    std::vector<std::vector<Tclause>> _watch_lists;
+    std::vector<std::vector<TSwatch>> _watch_lists;
     /**
      * @brief _binary_clauses[l] is the contains the pairs <lit, cl> where lit
      * is a literal to be propagated if l is falsified, and <cl> is the clause
      * that propagates lit.
     */
     std::vector<std::vector<std::pair<Tlit, Tclause>>> _binary_clauses;
+    /**
+     * @brief Literals whose watch list or binary clause list may contain a
+     * deleted or unwatched clause, and must be repaired by
+     * repair_watch_lists.
+     */
+    std::vector<Tlit> _dirty_watch_lists;
+    /**
+     * @brief _watch_list_dirty[l] is true if l is in _dirty_watch_lists.
+     */
+    std::vector<bool> _watch_list_dirty;
     /**
      * @brief _decision_index[i] is the index of the decision made after level i.
      * @remark _decision_index[0] is the index of the first decision.
@@ -349,12 +671,34 @@ namespace napsat
      * literal of the clause being written.
      */
     Tlit* _literal_buffer;
+    /**
+     * @brief Number of literals _literal_buffer can hold, at least the number
+     * of variables.
+     */
+    size_t _literal_buffer_size = 0;
     /**
      * @brief When in clause input mode, contains the index of the next literal
      * to write.
      */
     unsigned _next_literal_index;
 
+    /**  CLAUSE MINIMIZATION  **/
+    /**
+     * @brief Stack of the literals to explore when checking if a literal of a
+     * learned clause is redundant.
+     */
+    std::vector<Tlit> _minimize_stack;
+    /**
+     * @brief Variables marked as removable or poisoned during the
+     * minimization of the current learned clause.
+     */
+    std::vector<Tvar> _minimize_marked;
+    /**
+     * @brief Literals removed from the current learned clause by the
+     * recursive minimization.
+     */
+    std::vector<Tlit> _minimize_removed;
+
     /**  ACTIVITY HEAP  **/
     /**
      * @brief Activity increment for variables. This value is multiplied by the
@@ -363,102 +707,833 @@ namespace napsat
      * divided by 10^9 and the increment is set to 1.0.
      * TODO update the definition
      */
-    double _var_activity_increment = 1.0;
-
+    double _var_activity_increment = 1.0;
+
+    /**
+     * @brief For a clause C, _activities[C] is the activity of the clause.
+    */
+    std::vector<double> _activities;
+
+    /**
+     * @brief Decision heuristics of the solver (see
+     * options::decision_heuristic).
+     */
+    enum decision_heuristic
+    {
+      DECISION_VSIDS,
+      DECISION_VMTF
+    };
+    /**
+     * @brief Decision heuristic of the solver.
+     */
+    decision_heuristic _decision_heuristic = DECISION_VSIDS;
+
+    /**
+     * @brief Priority queue of variables. The variables are ordered by their
+     * activity.
+     * @note Only used by the VSIDS heuristic.
+     */
+    napsat::utils::heap _variable_heap;
+
+    /**
+     * @brief Queue of variables ordered by the last conflict in which they
+     * were bumped.
+     * @note Only used by the VMTF heuristic.
+     */
+    napsat::utils::vmtf _variable_queue;
+
+    /**
+     * @brief Variables bumped during the current conflict analysis. They are
+     * moved to the front of _variable_queue after the analysis, in the order
+     * they had in the queue.
+     * @note Only used by the VMTF heuristic.
+     */
+    std::vector<Tvar> _vmtf_bumped;
+
+    /**
+     * @brief Generator of the random initial phases of the variables, if
+     * options::seed is not 0.
+     */
+    std::minstd_rand _random;
+
+    /**
+     * @brief Increases the activity of a variable.
+     * @param var variable to bump.
+     * @details With the VMTF heuristic, the variable is only recorded in
+     * _vmtf_bumped, and moved to the front of the queue by
+     * flush_vmtf_bumped.
+     */
+    void bump_var_activity(Tvar var);
+
+    /**
+     * @brief Moves the variables bumped since the last call to the front of
+     * _variable_queue, preserving their relative order.
+     */
+    void flush_vmtf_bumped();
+
+    /**
+     * @brief Makes the variable available to the decision heuristic.
+     * @param var variable to insert in the decision queue.
+     */
+    inline void enqueue_var(Tvar var)
+    {
+      if (_decision_heuristic == DECISION_VMTF) {
+        if (!_variable_queue.contains(var))
+          _variable_queue.insert(var);
+        else
+          _variable_queue.update_search(var);
+      }
+      else if (!_variable_heap.contains(var))
+        _variable_heap.insert(var, _vars[var].activity);
+    }
+
+    /**
+     * @brief Removes the variable from the decision heuristic, e.g. when it
+     * is eliminated.
+     * @param var variable to remove from the decision queue.
+     */
+    inline void dequeue_var(Tvar var)
+    {
+      if (_decision_heuristic == DECISION_VMTF) {
+        if (_variable_queue.contains(var))
+          _variable_queue.remove(var);
+      }
+      else if (_variable_heap.contains(var))
+        _variable_heap.remove(var);
+    }
+
+    /**
+     * @brief Returns the next unassigned variable of the decision heuristic,
+     * or 0 if all the variables in the decision queue are assigned.
+     * @details The assigned variables met on the way are skipped for good.
+     */
+    Tvar next_decision_var();
+
+    /**  CLAUSE DELETION  **/
+    /**
+     * @brief Number of learned clauses in the clause set.
+     */
+    unsigned _n_learned_clauses = 0;
+    /**
+     * @brief Number of learned clauses before a clause elimination procedure
+     * is called
+     * @note At first, the number of learned clauses before elimination is the
+     * number of external clauses.
+     */
+    unsigned _next_clause_elimination = 0;
+    /**
+     * @brief Activity increment for clauses. Each time a clause is used to
+     * resolve a conflict, its activity is increased by
+     * _clause_activity_increment and _clause_activity_increment is multiplied
+     * by _clause_activity_multiplier.
+     */
+    double _clause_activity_increment = 1;
+    /**
+     * @brief Maximum possible activity of a clause. It is the sum of the activity increments.
+     */
+    double _max_clause_activity = 1;
+    /**
+     * @brief Buffer of the local clauses that are candidates for deletion.
+     */
+    std::vector<Tclause> _reduction_candidates;
+
+    /**
+     * @brief Increases the activity of a clause and updates the maximum
+     * possible activity.
+     * @details If the maximum possible activity is greater than 1e100, the
+     * activity of all clauses is divided by 1e100 and the maximum possible
+     * activity is divided by 1e100.
+     * @details This procedure keeps a relative order identical to decaying the
+     * activity of all clauses by a factor d < 1 and increasing the activity of
+     * the clause by 1 - d. Where _clause_activity_multiplier = (1 - d) / d.
+     */
+    void bump_clause_activity(Tclause cl);
+
+    /**
+     * @brief Delete a clause from the clause set.
+     */
+    void delete_clause(Tclause cl);
+
+    /**
+     * @brief Sets the literal block distance of a learned clause and moves it
+     * to the corresponding tier.
+     * @details A clause is never moved to a higher tier, since its LBD is
+     * only updated when it decreases.
+     */
+    void set_clause_lbd(Tclause cl, unsigned lbd);
+
+    /**
+     * @brief Recomputes the literal block distance of a learned clause used
+     * in conflict analysis, and marks it as used.
+     * @pre All the literals of the clause are falsified.
+     */
+    void update_clause_lbd(Tclause cl);
+
+    /**
+     * @brief Deletes learned clauses depending on their tier.
+     * @details Core clauses are kept. Tier 2 clauses that were not used since
+     * the last reduction are demoted to the local tier. Local clauses that
+     * were not used since the last reduction are sorted by decreasing LBD and
+     * increasing activity, and the first local_reduction_fraction of them are
+     * deleted.
+     * @details Does not delete external and propagating clauses.
+     * @details Under memory pressure, the clauses are first moved to the
+     * tiers of the lowered LBD thresholds, the used clauses are not spared,
+     * and a larger fraction of the local clauses is deleted.
+     */
+    void simplify_clause_set();
+
+    /**  MEMORY BUDGET  **/
+    /**
+     * @brief Number of conflicts between two estimations of the memory usage.
+     */
+    static constexpr unsigned MEMORY_CHECK_INTERVAL = 1000;
+    /**
+     * @brief Number of conflicts at which the memory usage is estimated next.
+     */
+    unsigned long _next_memory_check = MEMORY_CHECK_INTERVAL;
+    /**
+     * @brief True if the last estimation of the memory usage reached 90% of
+     * the memory limit.
+     */
+    bool _memory_pressure = false;
+
+    /**
+     * @brief Estimates the memory usage and, if it is close to the memory
+     * limit, lowers the LBD thresholds of the tiers, deletes learned clauses,
+     * and releases the unused memory of the clause store, the binary lists
+     * and the watch lists.
+     * @pre The memory limit is set.
+     */
+    void check_memory_budget();
+
+    /**  VIVIFICATION  **/
+    /**
+     * @brief True if a vivification round should run at the next decision.
+     * Set by each clause deletion.
+     */
+    bool _vivification_pending = false;
+    /**
+     * @brief Number of propagations of the search at the end of the last
+     * vivification round.
+     */
+    unsigned long _propagations_at_vivification = 0;
+    /**
+     * @brief _vivified[C] is true if the clause C was already vivified.
+     * Vivifying it again is unlikely to shorten it.
+     */
+    std::vector<bool> _vivified;
+    /**
+     * @brief Buffer of the learned clauses to vivify in the current round.
+     */
+    std::vector<Tclause> _vivification_candidates;
+    /**
+     * @brief Clauses of the round replaced by a shorter clause or implied by
+     * the other clauses. They are deleted at the end of the round.
+     */
+    std::vector<Tclause> _vivification_redundant;
+    /**
+     * @brief Copy of the literals of the clause being vivified, since
+     * propagation reorders the literals of the clause.
+     */
+    std::vector<Tlit> _vivification_literals;
+    /**
+     * @brief Resolution steps (pivot and clause) justifying the vivified
+     * clause, in the order of the resolution chain.
+     */
+    std::vector<std::pair<Tlit, Tclause>> _vivification_chain;
+    /**
+     * @brief Literals falsified at level 0 met while justifying the vivified
+     * clause.
+     */
+    std::vector<Tlit> _vivification_root_literals;
+    /**
+     * @brief Decisions undone by the last vivification round, from the last
+     * to the first. They are taken again before any other decision, until
+     * the solver backtracks.
+     */
+    std::vector<Tlit> _vivification_decisions;
+
+    /**
+     * @brief Vivifies the learned clauses, until the propagation budget of
+     * the round is exhausted.
+     * @details The clauses are vivified from level 0, therefore the solver
+     * backtracks to level 0. The decisions undone are taken again after the
+     * round (see _vivification_decisions), such that the round does not act
+     * as a restart. The phases and the agility are not modified by the
+     * decisions of the vivification.
+     */
+    void vivify_clauses();
+
+    /**
+     * @brief Vivifies the clause cl. The negations of its literals are
+     * decided one at a time and propagated, until a literal of the clause is
+     * implied or a conflict occurs. The decisions involved in the
+     * implication or the conflict form a subset D of the clause, which
+     * replaces it if it is shorter.
+     * @details If D is justified without the clause itself, the clause is
+     * implied by the other clauses. Then, if D is an existing clause or has
+     * the same size as the clause, the clause is deleted. The replaced and
+     * deleted clauses are added to _vivification_redundant.
+     * @param propagations number of propagations of the round, increased by
+     * the propagations of the call.
+     * @return false if a literal was implied at level 0, such that the
+     * round must stop to propagate it.
+     * @pre The solver is at level 0 and all the literals are propagated.
+     */
+    bool vivify_clause(Tclause cl, unsigned long& propagations);
+
+    /**
+     * @brief Propagates the literals of the trail, without repairing the
+     * conflicts.
+     * @param propagations number of propagations of the round, increased by
+     * the propagations of the call.
+     * @return the conflicting clause, or CLAUSE_UNDEF if there is no conflict.
+     */
+    Tclause vivification_propagate(unsigned long& propagations);
+
+    /**
+     * @brief Marks the literal for the justification of the vivified clause.
+     * @return true if the literal was marked at a level above 0.
+     */
+    bool vivification_mark(Tlit lit);
+
+    /**
+     * @brief Looks for a clause with the same literals as the vivified clause
+     * in _literal_buffer.
+     * @pre the vivified clause has at least 2 literals, and they are not
+     * marked as seen.
+     * @return the identical clause, or CLAUSE_UNDEF if there is none.
+     */
+    Tclause vivification_duplicate();
+
+    /**  RESTART AGILITY  **/
+    /**
+     * @brief Progress metric of the solver
+     * @details The agility measures a moving average of the number of flips of
+     * polarity for literals.
+     * If the agility is high, the solver is making a lot of progress and
+     * changes the polarity of literals often.
+     * If the agility is low, the solver is not making much progress and
+     * changes the polarity of literals rarely.
+     * This metric is used to decide when to restart the solver.
+     * @details The agility is updated upon implying a literal with the
+     * following formula:
+     * agility = agility * _agility_decay + (1 - _agility_decay) * change_of_polarity
+     * where change_of_polarity is 1 if the polarity of the literal is changed,
+     * 0 otherwise.
+     * @details The idea is inspired by [2008 - Biere, Armin. "Adaptive restart
+     * strategies for conflict driven SAT solvers."]
+     * TODO Check if there is not a limit to the decay factor such that it is not possible to finish propagating all literals. It probably depends on the threshold decay factor too.
+     */
+    double _agility = 1;
+
+    /**  BACKTRACKING MODE  **/
+    /**
+     * @brief Backtracking strategies of the solver (see the chronological
+     * backtracking options).
+     * @details The propagation, conflict analysis and backtracking procedures
+     * are templates parameterized by the mode, such that the tests of the
+     * strategy are resolved at compile time. The public procedures dispatch to
+     * the instantiation of _backtracking_mode.
+     */
+    enum backtracking_mode
+    {
+      BACKTRACK_NCB,
+      BACKTRACK_WCB,
+      BACKTRACK_RSCB,
+      BACKTRACK_LSCB
+    };
+    /**
+     * @brief Backtracking mode of the solver. It does not change after the
+     * construction of the solver.
+     */
+    backtracking_mode _backtracking_mode = BACKTRACK_NCB;
+
+    /**
+     * @brief Smoothing factor of the moving average of the jumps, in adaptive
+     * backtracking.
+     */
+    static constexpr double JUMP_EMA_ALPHA = 0.01;
+    /**
+     * @brief Moving average of the number of levels undone by jumping to the
+     * assertion level after the conflict analyses, in adaptive backtracking.
+     */
+    napsat::utils::ema _jump_ema = napsat::utils::ema(JUMP_EMA_ALPHA);
+
+    /**
+     * @brief In adaptive backtracking, decides whether the solver jumps to the
+     * assertion level or backtracks chronologically.
+     * @param jump number of levels undone by jumping to the assertion level.
+     * @return true if the solver should jump to the assertion level.
+     * @details Long jumps discard large parts of the trail that are likely to
+     * be reassigned identically. A jump is replaced by chronological
+     * backtracking if it is long both in absolute terms and compared to the
+     * previous jumps of the instance.
+     */
+    inline bool adaptive_jump(unsigned jump)
+    {
+      bool chronological = jump >= _options.adaptive_backtracking_levels
+        && jump > _options.adaptive_backtracking_margin * _jump_ema.value();
+      _jump_ema.update(jump);
+      if (chronological)
+        _stats.chronological_backtracks++;
+      return !chronological;
+    }
+
+    /**  RESTART POLICY  **/
+    /**
+     * @brief Policies deciding when the solver restarts (see
+     * options::restart_policy).
+     */
+    enum restart_policy
+    {
+      RESTART_AGILITY,
+      RESTART_LUBY,
+      RESTART_GEOMETRIC,
+      RESTART_GLUCOSE
+    };
+    /**
+     * @brief Restart policy of the solver.
+     */
+    restart_policy _restart_policy = RESTART_AGILITY;
+    /**
+     * @brief Number of conflicts when the solver last restarted.
+     */
+    unsigned long _conflicts_at_restart = 0;
+    /**
+     * @brief Number of conflicts between the last restart and the next one,
+     * in the Luby and geometric policies.
+     */
+    double _restart_limit = 0;
+    /**
+     * @brief Index of the current interval in the Luby sequence.
+     */
+    unsigned _luby_index = 0;
+    /**
+     * @brief Fast moving average of the LBD of the learned clauses, used by
+     * the glucose policy.
+     */
+    napsat::utils::ema _lbd_ema_fast;
+    /**
+     * @brief Slow moving average of the LBD of the learned clauses, used by
+     * the glucose policy.
+     */
+    napsat::utils::ema _lbd_ema_slow;
+
+    /**
+     * @brief Returns true if the restart policy requires a restart.
+     */
+    bool restart_needed();
+
+    /**
+     * @brief Returns the level to backtrack to in a partial restart.
+     * @details The decisions are reused as long as they have a higher activity
+     * than the next decision, since they would be taken again in the same
+     * order after a full restart. Propagations at those levels are kept.
+     * @details Removes the assigned variables from the top of the variable
+     * heap.
+     */
+    Tlevel partial_restart_level();
+
+    /**  PHASES  **/
+    /**
+     * @brief _target_phase[v] is the value of v in the longest conflict-free
+     * trail since the last rephasing, or VAR_UNDEF if v was not on that trail.
+     */
+    std::vector<uint8_t> _target_phase;
+    /**
+     * @brief _best_phase[v] is the value of v in the longest conflict-free
+     * trail since the last rephasing to the best phases, or VAR_UNDEF.
+     */
+    std::vector<uint8_t> _best_phase;
+    /**
+     * @brief _original_phase[v] is the phase of v when it was created, that
+     * is, false, or a random phase if the solver is seeded.
+     */
+    std::vector<uint8_t> _original_phase;
+    /**
+     * @brief Number of literals on the trail when _target_phase was saved.
+     */
+    unsigned _target_trail_size = 0;
+    /**
+     * @brief Number of literals on the trail when _best_phase was saved.
+     */
+    unsigned _best_trail_size = 0;
+    /**
+     * @brief Number of conflicts after which the next restart rephases.
+     */
+    unsigned long _next_rephase = 0;
+    /**
+     * @brief If true, the trails are not used to update the saved phases.
+     * @details The trails of vivification are not assignments found by the
+     * search.
+     */
+    bool _phase_saving_suspended = false;
+
+    /**
+     * @brief Returns the polarity to decide for var.
+     */
+    inline bool decision_phase(Tvar var) const
+    {
+      if (_options.rephase && _target_phase[var] != VAR_UNDEF)
+        return _target_phase[var];
+      return _vars[var].phase_cache;
+    }
+
+    /**
+     * @brief Saves the trail in the target and best phases if it is longer
+     * than the trails they were saved from.
+     * @details Called before backtracking, when the trail is conflict-free
+     * except for the last propagated literals. Only the high-water marks are
+     * compared, such that the trail is copied only when it improves.
+     */
+    void save_phases();
+
+    /**
+     * @brief Resets the saved phases of all variables following the rephasing
+     * schedule, and sets the next rephasing.
+     */
+    void rephase();
+
+    /**  ASSUMPTIONS  **/
+    /**
+     * @brief Assumptions of the current search. They are decided before any
+     * other decision, each at its own decision level, unless they are already
+     * satisfied.
+     */
+    std::vector<Tlit> _assumptions;
+    /**
+     * @brief Number of assumptions known to be satisfied. The assumptions
+     * after this index must be checked before taking a decision.
+     * @details Backtracking resets the index, since it may unassign any
+     * assumption. Decisions are taken only when all the assumptions are
+     * satisfied, so unassigning an assumption also removes all the other
+     * decisions above it.
+     */
+    unsigned _assumption_index = 0;
+    /**
+     * @brief Subset of the assumptions that is inconsistent with the clause
+     * set, if the last search was unsatisfiable under the assumptions.
+     * Empty if the clause set itself is unsatisfiable.
+     */
+    std::vector<Tlit> _failed_assumptions;
+
+    /**
+     * @brief Returns true if all the assumptions are satisfied.
+     * @details Moves the assumption index to the first assumption that is not
+     * satisfied.
+     */
+    inline bool assumptions_satisfied()
+    {
+      while (_assumption_index < _assumptions.size()
+          && lit_true(_assumptions[_assumption_index]))
+        _assumption_index++;
+      return _assumption_index == _assumptions.size();
+    }
+
+    /**
+     * @brief Decides the next assumption that is not satisfied yet. If it is
+     * falsified, the failed assumptions are computed and the status is set to
+     * UNSAT.
+     * @return true if an assumption was decided or falsified, false if all
+     * assumptions are satisfied.
+     */
+    bool decide_assumption();
+
+    /**
+     * @brief Computes the assumptions responsible for the falsification of
+     * the assumption lit, and stores them in _failed_assumptions.
+     * @param lit falsified assumption.
+     * @details The reasons are explored from lit down to the decisions, which
+     * are all assumptions, since no other decision is taken before all the
+     * assumptions are satisfied.
+     */
+    void analyze_final(Tlit lit);
+
+    /**
+     * @brief Leaves the state reached by the last search, that is, a
+     * satisfying assignment or a conflict with the assumptions, such that
+     * clauses can be added and a new search can start. The learned clauses
+     * and the variable activities are kept.
+     * @details Does nothing if the search is not finished and does not use
+     * assumptions. If the clause set is unsatisfiable, the status remains
+     * UNSAT. Otherwise, the failed assumptions are cleared.
+     */
+    void reset_search();
+
+    /**  CUBE AND CONQUER  **/
+    /**
+     * @brief Cubes read from the lines "a ... 0" of an iCNF input, or built
+     * by the last call to cube.
+     */
+    std::vector<std::vector<Tlit>> _cubes;
+    /**
+     * @brief True while the parser reads the literals of a cube.
+     */
+    bool _reading_cube = false;
+    /**
+     * @brief Variables by decreasing number of occurrences in the clause
+     * set. The candidates of the lookahead are the first unassigned ones.
+     */
+    std::vector<Tvar> _lookahead_order;
+    /**
+     * @brief Literals of the cube of the current node of the split, that is,
+     * the branches taken and the literals forced by a failed lookahead.
+     */
+    std::vector<Tlit> _cube_literals;
+
+    /**
+     * @brief Decides the literal lit, propagates it, and backtracks to the
+     * current level.
+     * @param gain set to the number of literals assigned by the decision and
+     * its propagation.
+     * @return false if the propagation conflicts.
+     * @pre All the literals of the trail are propagated.
+     */
+    bool lookahead(Tlit lit, unsigned& gain);
+
+    /**
+     * @brief Splits the current node in cubes, until the given depth, and
+     * adds them to _cubes.
+     * @details The literals forced by a failed lookahead do not count in the
+     * depth. A node whose both branches conflict adds no cube. The solver is
+     * back at the level of the node when the function returns.
+     * @pre All the literals of the trail are propagated without conflict.
+     */
+    void split_cube(unsigned depth);
+
+    /**  THEORY PROPAGATION  **/
+    /**
+     * @brief Constraint implying a literal whose reason is CLAUSE_LAZY.
+     */
+    typedef struct TStheory_reason
+    {
+      /**
+       * @brief Index of the propagator in _propagators, or PROPAGATOR_UNDEF
+       * for a hint.
+       */
+      unsigned propagator;
+      /**
+       * @brief Constraint of the propagator implying the literal.
+       */
+      unsigned constraint;
+    } TStheory_reason;
+
+    static constexpr unsigned PROPAGATOR_UNDEF = UINT_MAX;
+
+    /**
+     * @brief Propagators of the constraints that are not clauses. They are
+     * owned by the solver.
+     */
+    std::vector<propagator*> _propagators;
+    /**
+     * @brief Propagator of the cardinality constraints, also in _propagators,
+     * or nullptr if there is no such constraint.
+     */
+    cardinality_propagator* _cardinality = nullptr;
+    /**
+     * @brief Constraint implying each variable whose reason is CLAUSE_LAZY.
+     */
+    std::vector<TStheory_reason> _theory_reasons;
+    /**
+     * @brief Buffer for the reasons and conflicts of the propagators.
+     */
+    std::vector<Tlit> _theory_literals;
+
+    /**
+     * @brief Gives the literal lit, which is true and whose clauses are
+     * propagated, to the propagators.
+     * @return a conflicting clause, or CLAUSE_UNDEF.
+     */
+    Tclause propagate_theory(Tlit lit);
+
+    /**
+     * @brief Implies lit at the given level, as a consequence of a constraint
+     * of the given propagator.
+     * @details The level may be lower than the solver level. The reason is
+     * CLAUSE_LAZY until the conflict analysis requests it.
+     */
+    void theory_imply(Tlit lit, Tlevel level, unsigned propagator, unsigned constraint);
+
+    /**
+     * @brief Asks the propagator of the literal lit, which is true and
+     * implied by a constraint, for its reason clause, and stores the clause
+     * as the reason of lit.
+     * @return the reason clause.
+     * @details The clause store may be reallocated.
+     */
+    Tclause theory_reason(Tlit lit);
+
+    /**
+     * @brief Adds a reason or a conflict of a propagator as a learned clause,
+     * and watches its first two literals.
+     * @pre The clause has at least two literals, the first one true or false
+     * and the other ones false, and the second one at the highest level among
+     * the other ones.
+     * @details The conflicts are not repaired, and the implications are not
+     * made, since the clause is built from the current assignment.
+     */
+    Tclause add_theory_clause(const std::vector<Tlit>& lits);
+
+    /**  PREPROCESSING  **/
+    /**
+     * @brief Clause removed by the variable elimination, kept to reconstruct
+     * the value of the eliminated variable in the model.
+     */
+    typedef struct TSreconstruction
+    {
+      /**
+       * @brief Position of the first literal of the clause in
+       * _reconstruction_literals. The first literal is the literal of the
+       * eliminated variable.
+       */
+      unsigned begin;
+      /**
+       * @brief Number of literals of the clause.
+       */
+      unsigned size;
+      /**
+       * @brief Internal ID of the clause in the proof, to restore it without
+       * justifying it again.
+       */
+      napsat::proof::TclauseID proof_id;
+    } TSreconstruction;
+
+    /**
+     * @brief True once the preprocessing was run. It is run at most once, at
+     * the beginning of the first search.
+     */
+    bool _preprocessed = false;
+    /**
+     * @brief True while the preprocessing runs.
+     * @details The occurrence lists may still refer to deleted clauses, so
+     * the IDs of the deleted clauses are not reused while preprocessing.
+     */
+    bool _preprocessing = false;
+    /**
+     * @brief _occurrences[l] contains the irredundant clauses in which the
+     * literal l occurs. Deleted clauses are removed lazily. Only used while
+     * preprocessing.
+     */
+    std::vector<std::vector<Tclause>> _occurrences;
+    /**
+     * @brief _signatures[cl] is a 64-bit abstraction of the variables of the
+     * clause cl. If the signature of C is not included in the signature of D,
+     * C cannot subsume D.
+     */
+    std::vector<uint64_t> _signatures;
+    /**
+     * @brief Clauses to check for backward subsumption.
+     */
+    std::vector<Tclause> _subsumption_queue;
+    /**
+     * @brief Marks on the literals, used to compare clauses. Literals must
+     * remain marked locally.
+     */
+    std::vector<bool> _lit_marks;
+    /**
+     * @brief Buffer holding the resolvent or the strengthened clause being
+     * added.
+     */
+    std::vector<Tlit> _resolvent;
     /**
-     * @brief For a clause C, _activities[C] is the activity of the clause.
-    */
-    std::vector<double> _activities;
-
+     * @brief Eliminated variables, in the order of elimination.
+     */
+    std::vector<Tvar> _eliminated_vars;
     /**
-     * @brief Priority queue of variables. The variables are ordered by their
-     * activity.
+     * @brief Clauses removed by the variable elimination, in the order of
+     * elimination.
      */
-    napsat::utils::heap _variable_heap;
-
+    std::vector<TSreconstruction> _reconstruction_clauses;
     /**
-     * @brief Increases the activity of a variable.
-     * @param var variable to bump.
+     * @brief Literals of the clauses in _reconstruction_clauses.
      */
-    void bump_var_activity(Tvar var);
+    std::vector<Tlit> _reconstruction_literals;
+    /**
+     * @brief The trail completed with the values of the eliminated variables.
+     * @details Computed by partial_assignment when the clause set is
+     * satisfiable.
+     */
+    std::vector<Tlit> _model;
 
-    /**  CLAUSE DELETION  **/
     /**
-     * @brief Number of learned clauses in the clause set.
+     * @brief Simplifies the irredundant clauses with backward subsumption,
+     * self-subsuming resolution and bounded variable elimination.
+     * @details The variables of the assumptions are not eliminated. Learned
+     * clauses and clauses satisfied at level 0 containing an eliminated
+     * variable are deleted.
+     * @pre The solver is at level 0.
      */
-    unsigned _n_learned_clauses = 0;
+    void preprocess();
+
     /**
-     * @brief Number of learned clauses before a clause elimination procedure
-     * is called
-     * @note At first, the number of learned clauses before elimination is the
-     * number of external clauses.
+     * @brief Adds the clause cl to the occurrence lists of its literals and to
+     * the subsumption queue.
      */
-    unsigned _next_clause_elimination = 0;
+    void attach_occurrences(Tclause cl);
+
     /**
-     * @brief Activity increment for clauses. Each time a clause is used to
-     * resolve a conflict, its activity is increased by
-     * _clause_activity_increment and _clause_activity_increment is multiplied
-     * by _clause_activity_multiplier.
+     * @brief Removes the deleted clauses from the occurrence list of lit.
      */
-    double _clause_activity_increment = 1;
+    void clean_occurrences(Tlit lit);
+
     /**
-     * @brief Maximum possible activity of a clause. It is the sum of the activity increments.
+     * @brief Removes the clauses subsumed by the clauses of the subsumption
+     * queue, and strengthens the clauses D such that a clause C of the queue
+     * contains ¬ℓ and C \ {¬ℓ} ⊆ D \ {ℓ}, by removing ℓ from D.
+     * @details The queue is empty after the call.
      */
-    double _max_clause_activity = 1;
+    void subsume_clauses();
+
     /**
-     * @brief Threshold of the clause activity. If the activity of a clause is
-     * lower than the threshold multiplied by the maximum possible activity,
-     * the clause is deleted.
-     * @details The threshold is a value between 0 and 1. The higher the
-     * threshold, the more clauses are deleted.
+     * @brief Replaces the clauses of var by their non-tautological resolvents
+     * on var, if this does not increase the number of clauses.
+     * @return true if the variable was eliminated.
+     * @pre The variable is not assigned and is not an assumption.
      */
-    double _clause_activity_threshold = 1;
+    bool eliminate_variable(Tvar var);
 
     /**
-     * @brief Increases the activity of a clause and updates the maximum
-     * possible activity.
-     * @details If the maximum possible activity is greater than 1e100, the
-     * activity of all clauses is divided by 1e100 and the maximum possible
-     * activity is divided by 1e100.
-     * @details This procedure keeps a relative order identical to decaying the
-     * activity of all clauses by a factor d < 1 and increasing the activity of
-     * the clause by 1 - d. Where _clause_activity_multiplier = (1 - d) / d.
+     * @brief Computes the resolvent of the clauses first and second on the
+     * pivot in _resolvent.
+     * @param pivot literal of first, whose negation is in second.
+     * @return false if the resolvent is a tautology.
      */
-    void bump_clause_activity(Tclause cl);
+    bool resolve(Tclause first, Tlit pivot, Tclause second);
 
     /**
-     * @brief Delete a clause from the clause set.
+     * @brief Adds the clause in _resolvent, obtained by resolving the clauses
+     * first and second on the pivot, to the clause set and to the occurrence
+     * lists. In the proof, the clause is justified by the resolution of first
+     * and second.
+     * @details The literals falsified at level 0 are removed, and the clause
+     * is not added if it is satisfied at level 0.
+     * @param pivot literal of first, whose negation is in second.
      */
-    void delete_clause(Tclause cl);
+    void add_resolvent(Tclause first, Tlit pivot, Tclause second);
 
     /**
-     * @brief Deletes clauses with a low activity.
-     * @details Deletes clauses with an activity lower than the threshold
-     * multiplied by the maximum possible activity.
-     * @details Does not delete external and propagating clauses.
+     * @brief Adds the clauses removed by the variable elimination back to the
+     * clause set, such that the eliminated variables can be used again.
+     * @details The solver backtracks to level 0. In the proof, the clauses
+     * are restored without being justified again.
      */
-    void simplify_clause_set();
+    void restore_eliminated_variables();
 
-    /**  RESTART AGILITY  **/
     /**
-     * @brief Progress metric of the solver
-     * @details The agility measures a moving average of the number of flips of
-     * polarity for literals.
-     * If the agility is high, the solver is making a lot of progress and
-     * changes the polarity of literals often.
-     * If the agility is low, the solver is not making much progress and
-     * changes the polarity of literals rarely.
-     * This metric is used to decide when to restart the solver.
-     * @details The agility is updated upon implying a literal with the
-     * following formula:
-     * agility = agility * _agility_decay + (1 - _agility_decay) * change_of_polarity
-     * where change_of_polarity is 1 if the polarity of the literal is changed,
-     * 0 otherwise.
-     * @details The idea is inspired by [2008 - Biere, Armin. "Adaptive restart
-     * strategies for conflict driven SAT solvers."]
-     * TODO Check if there is not a limit to the decay factor such that it is not possible to finish propagating all literals. It probably depends on the threshold decay factor too.
+     * @brief Returns true if one of the literals is a literal of an
+     * eliminated variable.
      */
-    double _agility = 1;
+    inline bool eliminated_literal(const Tlit* lits, unsigned size) const
+    {
+      if (_eliminated_vars.empty())
+        return false;
+      for (unsigned i = 0; i < size; i++)
+        if (_vars[lit_to_var(lits[i])].eliminated)
+          return true;
+      return false;
+    }
 
     /**  PURGE  **/
     /**
@@ -505,7 +1580,7 @@ namespace napsat
      * literals that were removed from the trail and should be reimplied after
      * backtracking.
      */
-    std::vector<Tclause> _reimplication_backtrack_buffer;
+    std::vector<std::pair<Tlevel, Tclause>> _reimplication_backtrack_buffer;
 
     /**  PROOFS  **/
     /**
@@ -513,6 +1588,50 @@ namespace napsat
      * builds a resolution proof for unsatisfiability.
     */
     napsat::proof::resolution_proof* _proof = nullptr;
+    /**
+     * @brief DRAT proof writer of the solver. If _drat is not nullptr, the
+     * derived and deleted clauses are written to options::proof_file.
+     * @details Contrary to _proof, the writer does not need the resolution
+     * chains, and its memory does not grow with the length of the proof.
+     */
+    napsat::proof::drat_writer* _drat = nullptr;
+
+    /**  BENCHMARK  **/
+    /**
+     * @brief Measures the time spent in each phase of the solver if the
+     * benchmark option is enabled.
+     */
+    napsat::utils::profiler _profiler;
+
+    /**  STATISTICS  **/
+    /**
+     * @brief Counters collected since the creation of the solver.
+     */
+    napsat::statistics _stats = {};
+    /**
+     * @brief Stamp of each decision level, used to count the distinct levels
+     * of a learned clause.
+     */
+    std::vector<unsigned> _level_stamps;
+    /**
+     * @brief Current stamp. It is incremented each time an LBD is computed.
+     */
+    unsigned _level_stamp = 0;
+
+    /**
+     * @brief Updates the statistics with a clause learned by conflict analysis.
+     * @param lits literals of the learned clause.
+     * @param size number of literals in the learned clause.
+     * @pre All the literals are assigned, at the level they had in the conflict.
+     * @return the literal block distance of the clause.
+     */
+    unsigned record_learned_clause(const Tlit* lits, unsigned size);
+
+    /**
+     * @brief Computes the number of distinct decision levels among literals.
+     * @pre All the literals are assigned.
+     */
+    unsigned compute_lbd(const Tlit* lits, unsigned size);
 
     /**  SMT SYNCHRONIZATION  **/
     /**
@@ -541,6 +1660,137 @@ namespace napsat
      */
     bool _interactive = false;
 
+    /**  TERMINATION  **/
+    /**
+     * @brief Flag set by another thread to stop the search. If nullptr, the
+     * search is never stopped.
+     * @details The flag is checked after each conflict and before each
+     * decision. The solver does not modify it.
+     */
+    const std::atomic<bool>* _termination_flag = nullptr;
+
+    /**
+     * @brief Set by interrupt, possibly from another thread, and cleared when
+     * solve returns.
+     */
+    std::atomic<bool> _interrupted{false};
+
+    /**
+     * @brief Number of conflicts at which the search stops. The budgets are
+     * compared to the statistics, such that they span several calls to solve.
+     */
+    unsigned long _conflict_limit = ULONG_MAX;
+
+    /**
+     * @brief Number of propagations at which the search stops.
+     */
+    unsigned long _propagation_limit = ULONG_MAX;
+
+    /**
+     * @brief True if the search stops at _time_limit.
+     */
+    bool _time_limited = false;
+
+    /**
+     * @brief Time at which the search stops, if _time_limited is true.
+     */
+    std::chrono::steady_clock::time_point _time_limit;
+
+    /**
+     * @brief Number of calls to termination_requested before the clock is read
+     * again. Reading the clock at each conflict would be noticeable on easy
+     * instances.
+     */
+    unsigned _time_check_countdown = 0;
+
+    /**
+     * @brief Number of calls to termination_requested between two readings of
+     * the clock.
+     */
+    static const unsigned TIME_CHECK_INTERVAL = 64;
+
+    /**
+     * @brief Returns true if another thread requested the search to stop, or
+     * if a budget is exhausted.
+     */
+    inline bool termination_requested()
+    {
+      if (_termination_flag && _termination_flag->load(std::memory_order_relaxed))
+        return true;
+      if (_interrupted.load(std::memory_order_relaxed))
+        return true;
+      if (_stats.conflicts >= _conflict_limit || _stats.propagations >= _propagation_limit)
+        return true;
+      if (!_time_limited || _time_check_countdown-- > 0)
+        return false;
+      _time_check_countdown = TIME_CHECK_INTERVAL;
+      return std::chrono::steady_clock::now() >= _time_limit;
+    }
+
+    /**  CLAUSE SHARING  **/
+    /**
+     * @brief Exchange of clauses with the other solvers of a portfolio, or
+     * nullptr if the solver runs alone.
+     */
+    napsat::utils::clause_exchange* _exchange = nullptr;
+    /**
+     * @brief Index of the solver in the exchange.
+     */
+    unsigned _exchange_id = 0;
+    /**
+     * @brief Number of literals implied at level 0, in the order of the
+     * trail, already exported.
+     * @details Literals at level 0 are never removed from the trail, and
+     * backtracking preserves the order of the remaining literals. Therefore,
+     * the exported ones are always the first ones.
+     */
+    unsigned _exported_root_literals = 0;
+    /**
+     * @brief Maximum number of clauses read from the ring of each other solver
+     * by one call to import_clauses.
+     */
+    static constexpr unsigned IMPORT_LIMIT = 256;
+    /**
+     * @brief Number of conflicts at the last import.
+     * @details The clauses are imported at most once between two conflicts,
+     * such that a stream of clauses from the other solvers cannot keep the
+     * solver at level 0.
+     */
+    unsigned long _conflicts_at_import = ULONG_MAX;
+
+    /**
+     * @brief Exports the learned clause to the other solvers if it is short
+     * or has a low LBD (see options::share_max_size and options::share_lbd).
+     */
+    inline void export_learned_clause(const Tlit* lits, unsigned size,
+                                      unsigned lbd)
+    {
+      if (!_exchange || size > utils::clause_exchange::MAX_SIZE)
+        return;
+      if (size > _options.share_max_size && lbd > _options.share_lbd)
+        return;
+      _exchange->export_clause(_exchange_id, lits, size, lbd);
+      _stats.exported_clauses++;
+    }
+
+    /**
+     * @brief Exports the literals implied at level 0 since the last call as
+     * unit clauses.
+     */
+    void export_root_literals();
+
+    /**
+     * @brief Adds the clauses exported by the other solvers since the last
+     * call, at most IMPORT_LIMIT from each of them.
+     * @pre The solver is at level 0 and all literals are propagated.
+     * @return true if at least one clause was added.
+     * @details The imported clauses are learned clauses. They are marked as
+     * used, such that they survive the next clause deletion. The clauses
+     * satisfied at level 0 and the binary clauses already present are
+     * dropped, and are not counted as imported.
+     */
+    bool import_clauses();
+
     /*************************************************************************/
     /*                       Quality of life functions                       */
     /*************************************************************************/
@@ -552,7 +1802,7 @@ namespace napsat
      */
     inline Tlevel lit_level(Tlit lit) const
     {
-      return _vars[lit_to_var(lit)].level;
+      return _levels[lit_to_var(lit)];
     }
 
     /**
@@ -562,7 +1812,7 @@ namespace napsat
      */
     inline bool lit_true(Tlit lit) const
     {
-      return !(_vars[lit_to_var(lit)].state ^ lit_pol(lit));
+      return _lit_values[lit] == VAR_TRUE;
     }
 
     /**
@@ -572,7 +1822,7 @@ namespace napsat
      */
     inline bool lit_false(Tlit lit) const
     {
-      return !(_vars[lit_to_var(lit)].state ^ lit_pol(lit) ^ 1);
+      return _lit_values[lit] == VAR_FALSE;
     }
 
     /**
@@ -582,7 +1832,7 @@ namespace napsat
      */
     inline bool lit_undef(Tlit lit) const
     {
-      return _vars[lit_to_var(lit)].state >> 1;
+      return _lit_values[lit] == VAR_UNDEF;
     }
 
     /**
@@ -628,20 +1878,23 @@ namespace napsat
      */
     inline Tlevel lit_lazy_level(Tlit lit)
     {
-      if (lit_lazy_reason(lit) == CLAUSE_UNDEF)
+      Tclause cl = lit_lazy_reason(lit);
+      if (cl == CLAUSE_UNDEF)
         return LEVEL_UNDEF;
       ASSERT(lit_level(lit) > LEVEL_ROOT);
 #ifndef NDEBUG
-      Tlit* lits = _clauses[lit_lazy_reason(lit)].lits;
-      ASSERT_MSG(lit_level(lit) > lit_level(lits[1]),
-                 "Lazy reason " << clause_to_string(lit_lazy_reason(lit)) << " of literal " << lit_to_string(lit) << " is not a missed lower implication");
-      for (unsigned i = 1; i < _clauses[lit_lazy_reason(lit)].size; i++) {
+      const Tlit* lits = _clauses[cl].lits();
+      const Tlevel level = _clauses[cl].size == 1 ? LEVEL_ROOT : lit_level(lits[1]);
+      ASSERT_MSG(lit_level(lit) > level,
+                 "Lazy reason " << clause_to_string(cl) << " of literal " << lit_to_string(lit) << " is not a missed lower implication");
+      for (unsigned i = 1; i < _clauses[cl].size; i++) {
         ASSERT_MSG(lit_false(lits[i]),
-                   "Literal " << lit_to_string(lits[i]) << " of clause " << clause_to_string(lit_lazy_reason(lit)) << " is not falsified");
-        ASSERT(lit_level(lits[i]) <= lit_level(lits[1]));
+                   "Literal " << lit_to_string(lits[i]) << " of clause " << clause_to_string(cl) << " is not falsified");
+        ASSERT(lit_level(lits[i]) <= level);
       }
+      ASSERT(_vars[lit_to_var(lit)].lazy_level == level);
 #endif
-      return lit_level(_clauses[lit_lazy_reason(lit)].lits[1]);
+      return _vars[lit_to_var(lit)].lazy_level;
     }
 
     /**
@@ -651,6 +1904,7 @@ namespace napsat
     inline void var_set_lazy_reason(Tvar var, Tclause cl)
     {
       _vars[var].missed_lower_implication = cl;
+      _vars[var].lazy_level = _clauses[cl].size == 1 ? LEVEL_ROOT : lit_level(_clauses[cl].lits()[1]);
       NOTIFY_OBSERVER(_observer,
                       new napsat::gui::missed_lower_implication(var, cl));
     }
@@ -661,10 +1915,7 @@ namespace napsat
      */
     inline void lit_set_lazy_reason(Tlit lit, Tclause cl)
     {
-      _vars[lit_to_var(lit)].missed_lower_implication = cl;
-      NOTIFY_OBSERVER(_observer,
-                      new napsat::gui::missed_lower_implication(lit_to_var(lit),
-                                                             cl));
+      var_set_lazy_reason(lit_to_var(lit), cl);
     }
 
     /**
@@ -698,8 +1949,9 @@ namespace napsat
     inline bool is_protected(Tclause cl) const
     {
       ASSERT(cl < _clauses.size());
-      return is_reason_of     (cl, _clauses[cl].lits[0])
-          || is_lazy_reason_of(cl, _clauses[cl].lits[0]);
+      ASSERT(!_clauses[cl].deleted);
+      return is_reason_of     (cl, _clauses[cl].lits()[0])
+          || is_lazy_reason_of(cl, _clauses[cl].lits()[0]);
     }
 
     inline Tlevel solver_level() const
@@ -722,12 +1974,36 @@ namespace napsat
      */
     void stop_watch(Tlit lit, Tclause cl);
 
+    /**
+     * @brief Marks the watch list and the binary clause list of lit to be
+     * repaired by repair_watch_lists.
+     */
+    inline void mark_watch_list_dirty(Tlit lit)
+    {
+      ASSERT(lit < _watch_list_dirty.size());
+      if (_watch_list_dirty[lit])
+        return;
+      _watch_list_dirty[lit] = true;
+      _dirty_watch_lists.push_back(lit);
+    }
+
     /**
      * @brief Removes deleted and non-watched clauses from the watch lists. Also
      * removes clauses which are not watched by the literal of the list.
+     * @details Only the lists marked with mark_watch_list_dirty are visited,
+     * such that the cost is proportional to the size of the affected lists
+     * rather than to the size of the formula.
      */
     void repair_watch_lists();
 
+    /**
+     * @brief Compacts the clause store if enough memory is unused.
+     * @details The memory of deleted clauses and of literals removed from the
+     * clauses is reclaimed. The IDs of the clauses do not change.
+     * @warning Pointers to the literals of the clauses are invalidated.
+     */
+    void compact_clauses();
+
     /**
      * @brief Returns true if a variable was propagated and false otherwise.
      */
@@ -781,7 +2057,7 @@ namespace napsat
      */
     inline bool var_undef(Tvar var) const
     {
-      return _vars[var].state == VAR_UNDEF;
+      return _lit_values[literal(var, 1)] == VAR_UNDEF;
     }
 
     /**
@@ -789,7 +2065,7 @@ namespace napsat
      */
     inline bool var_true(Tvar var) const
     {
-      return _vars[var].state == VAR_TRUE;
+      return _lit_values[literal(var, 1)] == VAR_TRUE;
     }
 
     /**
@@ -797,7 +2073,7 @@ namespace napsat
      */
     inline bool var_false(Tvar var) const
     {
-      return _vars[var].state == VAR_FALSE;
+      return _lit_values[literal(var, 1)] == VAR_FALSE;
     }
 
     /**
@@ -807,18 +2083,21 @@ namespace napsat
     {
       TSvar& v = _vars[var];
       NOTIFY_OBSERVER(_observer,
-                      new napsat::gui::unassignment(literal(var, v.state)));
-      v.state = VAR_UNDEF;
+                      new napsat::gui::unassignment(literal(var, var_true(var))));
+      for (propagator* p : _propagators)
+        p->unassign(literal(var, var_true(var)));
+      _lit_values[literal(var, 0)] = VAR_UNDEF;
+      _lit_values[literal(var, 1)] = VAR_UNDEF;
+      _levels[var] = LEVEL_UNDEF;
       v.reason = CLAUSE_UNDEF;
-      v.level = LEVEL_UNDEF;
       v.propagated = false;
       if (v.missed_lower_implication != CLAUSE_UNDEF) {
         NOTIFY_OBSERVER(_observer,
                         new napsat::gui::remove_lower_implication(var));
         v.missed_lower_implication = CLAUSE_UNDEF;
+        v.lazy_level = LEVEL_UNDEF;
       }
-      if (!_variable_heap.contains(var))
-        _variable_heap.insert(var, v.activity);
+      enqueue_var(var);
     }
 
     /**
@@ -829,23 +2108,55 @@ namespace napsat
      */
     inline void var_allocate(Tvar var)
     {
-      for (Tvar i = _vars.size(); i <= var; i++) {
-        _variable_heap.insert(i, 0.0);
+      if (var < _vars.size())
+        return;
+      Tvar first = _vars.size();
+      _vars.resize(var + 1);
+      for (Tvar i = first; i <= var; i++) {
+        enqueue_var(i);
         NOTIFY_OBSERVER(_observer, new napsat::gui::new_variable(i));
       }
-      if (var >= _vars.size() - 1) {
-        _vars.resize(var + 1);
-        _watch_lists.resize(2 * var + 2);
-        _binary_clauses.resize(2 * var + 2);
-        // reallocate the literal buffer to make sure it is big enough
-        Tlit* new_literal_buffer = new Tlit[_vars.size()];
-        std::memcpy(new_literal_buffer, _literal_buffer,
-                    _next_literal_index * sizeof(Tlit));
-        delete[] _literal_buffer;
-        _literal_buffer = new_literal_buffer;
-      }
+      _original_phase.resize(var + 1, 0);
+      if (_options.seed)
+        for (Tvar i = first; i <= var; i++)
+          _vars[i].phase_cache = _original_phase[i] = _random() & 1;
+      _watch_lists.resize(2 * var + 2);
+      _binary_clauses.resize(2 * var + 2);
+      _watch_list_dirty.resize(2 * var + 2, false);
+      _lit_values.resize(2 * var + 2 + LIT_VALUES_PADDING, VAR_UNDEF);
+      _levels.resize(var + 1, LEVEL_UNDEF);
+      _theory_reasons.resize(var + 1);
+      _target_phase.resize(var + 1, VAR_UNDEF);
+      _best_phase.resize(var + 1, VAR_UNDEF);
+      if (_literal_buffer_size >= _vars.size())
+        return;
+      // the buffer grows geometrically, since the variables of a formula are often met in order
+      _literal_buffer_size = std::max((size_t) _vars.size(), 2 * (size_t) _literal_buffer_size);
+      Tlit* new_literal_buffer = new Tlit[_literal_buffer_size];
+      std::memcpy(new_literal_buffer, _literal_buffer,
+                  _next_literal_index * sizeof(Tlit));
+      delete[] _literal_buffer;
+      _literal_buffer = new_literal_buffer;
     }
 
+    /**
+     * @brief Parses a chunk of a DIMACS formula stored in memory and adds the
+     * clauses to the clause set.
+     * @param begin pointer to the first character of the chunk.
+     * @param end pointer past the last character of the chunk.
+     * @param last true if the chunk is the end of the formula.
+     * @return false if the parsing must stop, that is, if the end of the
+     * formula was reached, the clause set is unsatisfiable, or the formula is
+     * ill-formed (in which case the status is set to ERROR).
+     * @details The integers are scanned directly from the buffer. Clauses are
+     * terminated by 0 and may span several lines, and therefore several
+     * chunks. However, a chunk must end at the end of a line unless it is the
+     * last one. The header "p cnf V C" is only a hint to reserve memory for
+     * the variables and the clauses, bounded by a fixed ceiling and by the
+     * size of the formula. The variables are allocated from the literals.
+     */
+    bool parse_dimacs(const char* begin, const char* end, bool last);
+
     /**
      * @brief Returns a literal utility metric to choose the literals to watch.
      * @param lit literal to evaluate.
@@ -934,6 +2245,7 @@ namespace napsat
      *   C \ {c₂}, π ⊧ ⊥ ∧ δ(r) = δ(C \ {c₂})
      * @pre ¬c₁ ∈ ω
     */
+    template <backtracking_mode MODE>
     Tlit* search_replacement(Tlit* lits, unsigned size);
 
     /**
@@ -948,6 +2260,13 @@ namespace napsat
      * SCB: ¬c₁ ∈ (τ ⋅ ℓ) ⇒ [c₂ ∈ π
      *                    ∧ [δ(c₂) ≤ δ(c₁) ∨ δ(λ(c₂) \ {c₂}) ≤ δ(c₁)]
      */
+    template <backtracking_mode MODE>
+    Tclause propagate_binary_clauses(Tlit lit);
+
+    /**
+     * @brief Calls propagate_binary_clauses<MODE> with the backtracking mode of
+     * the solver.
+     */
     Tclause propagate_binary_clauses(Tlit lit);
 
     /**
@@ -969,6 +2288,13 @@ namespace napsat
      *                           ∧ [δ(c₂) ≤ δ(c₁) ∨ δ(λ(c₂) \ {c₂}) ≤ δ(c₁)]
      *                         ∨ [b ∈ π ∧ δ(b) ≤ δ(c₁)]
      */
+    template <backtracking_mode MODE>
+    Tclause propagate_lit(Tlit lit);
+
+    /**
+     * @brief Calls propagate_lit<MODE> with the backtracking mode of the
+     * solver.
+     */
     Tclause propagate_lit(Tlit lit);
 
     /**
@@ -988,6 +2314,13 @@ namespace napsat
      *      ∃C ∈ F ∃ℓ ∈ C. [¬c₁ ∈ τ ∧ C \ {ℓ}, π ⊧ ⊥ ∧ δ(C \ {ℓ})] < δ(ℓ)
      *                   ⇒ δ(λ(ℓ) \ {ℓ}) ≤ δ(C \ {ℓ})
      */
+    template <backtracking_mode MODE>
+    void backtrack(Tlevel level);
+
+    /**
+     * @brief Calls backtrack<MODE> with the backtracking mode of the solver.
+     * @param level level to backtrack to.
+     */
     void backtrack(Tlevel level);
 
     /**
@@ -1001,6 +2334,13 @@ namespace napsat
      * highest decision level in C
      *    δ(C[0]) = δ(C)
      */
+    template <backtracking_mode MODE>
+    void repair_conflict(Tclause conflict);
+
+    /**
+     * @brief Calls repair_conflict<MODE> with the backtracking mode of the
+     * solver.
+     */
     void repair_conflict(Tclause conflict);
 
     /**
@@ -1013,6 +2353,39 @@ namespace napsat
      */
     bool lit_is_required_in_learned_clause(Tlit lit);
 
+    /**
+     * @brief Returns true if the literal is implied by the literals of the
+     * learned clause through a chain of reasons.
+     * @details The literals found redundant are marked as removable and the
+     * literals found not redundant are marked as poisoned, such that they are
+     * not explored again for the same learned clause. Literals at a level that
+     * does not appear in the clause (according to abstract_levels) cannot be
+     * redundant.
+     * @param lit false literal with a reason.
+     * @param abstract_levels bit mask of the levels of the learned clause.
+     * @pre The literals of the learned clause are marked as seen.
+     */
+    bool lit_is_redundant(Tlit lit, unsigned abstract_levels);
+
+    /**
+     * @brief Removes the redundant literals from the learned clause in
+     * _literal_buffer, and links the corresponding resolutions in the proof.
+     * @details The last literal of the buffer is the asserting literal, and is
+     * never removed.
+     * @pre The literals of the learned clause are marked as seen.
+     * @post The removed literals are unmarked.
+     */
+    void minimize_learned_clause();
+
+    /**
+     * @brief Removes the literals of the learned clause in _literal_buffer that
+     * can be resolved away with a binary clause containing the asserting
+     * literal, and links the corresponding resolutions in the proof.
+     * @pre The literals of the learned clause are marked as seen.
+     * @post The removed literals are unmarked.
+     */
+    void binary_minimize_learned_clause();
+
     /**
      * Analyze a conflict and learn a new clause.
      * @param conflict clause that caused the conflict.
@@ -1037,8 +2410,33 @@ namespace napsat
      * The clause has one unique literal at the highest decision level
      *    |{ℓ ∈ C' : δ(ℓ) = δ(C')}| = 1
      */
+    template <backtracking_mode MODE>
     void analyze_conflict(Tclause conflict);
 
+    /**
+     * @brief Propagates and decides until the status of the solver is known,
+     * or the search is interrupted.
+     * @details This is the main loop of solve, after the assumptions are set
+     * and the clause set is preprocessed.
+     */
+    template <backtracking_mode MODE>
+    status search();
+
+    /**
+     * @brief Writes the empty clause to the DRAT proof if the formula is
+     * unsatisfiable, and flushes the proof so that it can be checked while
+     * the solver is idle.
+     */
+    void write_empty_clause();
+
+    /**
+     * @brief Propagates the literals in the queue and resolves the conflicts
+     * with the procedures specialized for the backtracking mode MODE. See
+     * propagate().
+     */
+    template <backtracking_mode MODE>
+    bool propagate();
+
     /**
      * @brief Link resolutions in the proof system to get rid of the literals at
      * level 0 in the clause.
@@ -1054,9 +2452,10 @@ namespace napsat
     void prove_root_literal_removal(Tlit* lits, unsigned size);
 
     /**
-     * @brief Restarts the solver by resetting the trail
-     * @post The trail is empty
-     *    π = ∅
+     * @brief Restarts the solver by resetting the trail, and updates the
+     * restart policy.
+     * @post The trail only contains literals at level 0, or at the levels
+     * reused by a partial restart.
      */
     void restart();
 
@@ -1084,6 +2483,20 @@ namespace napsat
      */
     void select_watched_literals(Tlit* lits, unsigned size);
 
+    /**
+     * @brief Allocates a clause of the given size, in place of a deleted
+     * clause if possible, and resets its activity and vivification flag.
+     * @details The literals are not set. The clause store may be reallocated.
+     */
+    Tclause allocate_clause(unsigned size, bool learned, bool external);
+
+    /**
+     * @brief Adds a clause with two literals to the binary lists, and watches
+     * the first two literals of a longer clause.
+     * @pre The clause has at least two literals.
+     */
+    void attach_clause(Tclause cl);
+
     /**
      * @brief allocates a new chunk of memory for a clause, and adds to the
      * clause set. The clause is added to the watch lists if needed (size >= 2).
@@ -1098,6 +2511,8 @@ namespace napsat
      * of a deleted clause.
      * @details This function removes literals falsified at level 0 from the
      * clause.
+     * @details Clauses with more than TSclause::MAX_SIZE literals are rejected
+     * with an error.
      * @return a handle to the added clause. If the clause is not added, returns
      * CLAUSE_UNDEF.
      */
@@ -1164,6 +2579,135 @@ namespace napsat
      */
     status solve();
 
+    /**
+     * @brief Solves the clause set under the given assumptions. The learned
+     * clauses, variable activities and phases of previous calls are reused.
+     * @param assumptions literals assumed to be true during the search.
+     * @param n number of assumptions.
+     * @details If the result is UNSAT and failed_assumptions is not empty,
+     * the clause set is unsatisfiable under the failed assumptions only.
+     * Clauses can be added between calls.
+     */
+    status solve(const Tlit* assumptions, unsigned n);
+
+    /**
+     * @brief Returns the subset of the assumptions of the last call to solve
+     * that is inconsistent with the clause set. Empty if the last call was
+     * not unsatisfiable because of the assumptions.
+     */
+    const std::vector<Tlit>& failed_assumptions() const;
+
+    /**
+     * @brief Splits the clause set into at most n cubes with a lookahead (see
+     * the option cubes). The cubes are conjunctions of literals, and every
+     * model of the clause set satisfies one of them.
+     * @return UNDEF if cubes were built, SAT or UNSAT if the propagation at
+     * level 0 concludes, and UNSAT if the lookahead refuted every cube.
+     * @details A refutation by the lookahead sets the status of the solver
+     * to UNSAT. When a resolution or DRAT proof is built, the refutation is
+     * not recorded in the proof, hence the status remains UNDEF, such that
+     * solving the clause set builds the proof. The solver is back at level 0
+     * after the call.
+     */
+    status cube(unsigned n);
+
+    /**
+     * @brief Returns the cubes of the iCNF input, or the cubes built by the
+     * last call to cube.
+     */
+    const std::vector<std::vector<Tlit>>& cubes() const;
+
+    /**
+     * @brief Writes the clause set and the cubes in the iCNF format. The
+     * clause set is made of the original clauses and of the literals
+     * implied at level 0.
+     * @return false if the file could not be written.
+     */
+    bool write_icnf(const char* filename);
+
+    /**
+     * @brief Adds the constraint stating that at most bound literals of lits
+     * are true. It is propagated natively, with a counter, instead of being
+     * encoded in clauses.
+     * @return false if the constraint could not be added, that is, if the
+     * solver builds a proof or is observed.
+     * @details An at-most-one constraint is a constraint with bound 1. The
+     * duplicate literals are ignored, and a literal occurring with its
+     * negation counts for one true literal. The clause set becomes
+     * unsatisfiable if the constraint conflicts at level 0.
+     */
+    bool add_cardinality(const Tlit* lits, unsigned size, unsigned bound);
+
+    /**
+     * @brief Writes the state of the solver in a binary file, such that the
+     * search can be resumed by another instance with load_state.
+     * @return false if the file could not be written.
+     * @details The state holds the clause set, including the learned clauses
+     * with their metadata, the literals implied at level 0, the phases and
+     * activities of the variables, the eliminated variables, and the
+     * schedulers of the search. The decisions are not saved.
+     */
+    bool save_state(const char* filename);
+
+    /**
+     * @brief Loads a state written by save_state. The clauses are added in
+     * bulk, as with add_clauses.
+     * @return false if the file could not be read, or is not a valid state.
+     * The solver is not modified in that case.
+     * @pre The solver has no variables, and builds no proof, resolution or
+     * DRAT.
+     */
+    bool load_state(const char* filename);
+
+    /**
+     * @brief Sets a flag that stops the search when it becomes true. The search
+     * then returns with the status UNDEF, and can be resumed by calling solve
+     * again once the flag is false.
+     * @param flag pointer to the flag, owned by the caller, or nullptr to
+     * remove the flag.
+     */
+    void set_termination_flag(const std::atomic<bool>* flag);
+
+    /**
+     * @brief Stops the search after n more conflicts. The search then returns
+     * with the status UNDEF, and can be resumed after a new budget is set.
+     * @param n number of conflicts, or 0 to remove the budget.
+     */
+    void set_conflict_budget(unsigned long n);
+
+    /**
+     * @brief Stops the search after n more propagations.
+     * @param n number of propagations, or 0 to remove the budget.
+     * @details The budget is checked at each conflict and each decision, and
+     * may therefore be slightly exceeded.
+     */
+    void set_propagation_budget(unsigned long n);
+
+    /**
+     * @brief Stops the search after the given time has elapsed.
+     * @param seconds wall-clock time, or 0 to remove the budget.
+     */
+    void set_time_budget(double seconds);
+
+    /**
+     * @brief Stops the current search, which returns with the status UNDEF.
+     * @details This function can be called from another thread. If the solver
+     * is not searching, the next call to solve returns UNDEF immediately.
+     */
+    void interrupt();
+
+    /**
+     * @brief Connects the solver to an exchange of clauses with other solvers
+     * running on separate threads.
+     * @param exchange the exchange, owned by the caller, or nullptr to
+     * disconnect the solver.
+     * @param id index of the solver in the exchange.
+     * @pre The solver does not build a proof, since the proof could not
+     * justify the imported clauses.
+     */
+    void set_clause_exchange(napsat::utils::clause_exchange* exchange,
+                             unsigned id);
+
     /**
      * @brief Returns the status of the solver.
      * @return status of the solver.
@@ -1218,6 +2762,23 @@ namespace napsat
      */
     Tclause add_clause(const Tlit* lits, unsigned size);
 
+    /**
+     * @brief Adds a batch of clauses to the clause set.
+     * @param lits literals of all the clauses, one after the other.
+     * @param offsets array of n_clauses + 1 positions in lits. The clause i is
+     * made of the literals from lits[offsets[i]] to lits[offsets[i + 1] - 1].
+     * @param n_clauses number of clauses in the batch.
+     * @details The per-variable structures, the clause memory, the binary
+     * lists and the watch lists are sized once for the whole batch, and the
+     * activity heap is rebuilt once at the end. Clauses of at least two
+     * literals over distinct unassigned variables are added directly. The
+     * others (units, clauses with assigned or duplicate literals), as well as
+     * all the clauses when a proof is built or an observer is attached, go
+     * through the same path as add_clause, after the rest of the batch. So
+     * do the clauses longer than TSclause::MAX_SIZE, which are rejected there.
+     */
+    void add_clauses(const Tlit* lits, const unsigned* offsets, unsigned n_clauses);
+
     /**
      * @brief Returns the literals of a clause.
      * @param clause clause id of the clause.
@@ -1289,6 +2850,13 @@ namespace napsat
      */
     const std::vector<Tlit>& trail() const;
 
+    /**
+     * @brief Returns the trail. If the clause set is satisfiable, the trail is
+     * completed with the values of the eliminated variables, such that it is
+     * a model of the clause set.
+     */
+    const std::vector<Tlit>& partial_assignment();
+
     /**
      * @brief Returns true if the literal in the trail is a decision.
      * @pre The literal must be assigned.
@@ -1319,6 +2887,27 @@ namespace napsat
     */
     bool check_proof();
 
+    /**
+     * @brief Prints the time spent in each phase and the search counters on
+     * the standard output. Each line has the form "c bench <key> <value>" such
+     * that it can be collected by scripts/bench.py.
+     * @pre The benchmark option must be enabled.
+    */
+    void print_benchmark() const;
+
+    /**
+     * @brief Returns the counters collected by the solver since its creation.
+     */
+    const napsat::statistics& get_statistics() const;
+
+    /**
+     * @brief Returns an estimate of the number of bytes held by each data
+     * structure of the solver.
+     * @details The capacities of the containers are counted, not their sizes.
+     * The DRAT proof is written as the solver runs and is not counted.
+     */
+    napsat::memory_usage get_memory_usage() const;
+
     /*************************************************************************/
     /*                        Printing the state                             */
     /*************************************************************************/
@@ -1405,4 +2994,19 @@ namespace napsat
      */
     bool watch_lists_minimal();
   };
+
+  inline bool propagator::lit_true(Tlit lit) const
+  {
+    return _solver.lit_true(lit);
+  }
+
+  inline bool propagator::lit_undef(Tlit lit) const
+  {
+    return _solver.lit_undef(lit);
+  }
+
+  inline Tlevel propagator::lit_level(Tlit lit) const
+  {
+    return _solver.lit_level(lit);
+  }
 }
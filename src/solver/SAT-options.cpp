@@ -14,6 +14,7 @@
 #include "SAT-options.hpp"
 
 #include "../utils/printer.hpp"
+#include "../utils/clause-exchange.hpp"
 #include "../observer/SAT-notification.hpp"
 
 #include <string>
@@ -66,6 +67,7 @@ vector<string> napsat::env::extract_environment_variables(vector<string>& tokens
           LOG_WARNING("Default value " << (*bool_options[token] ? "on" : "off") << " is used.");
           continue;
         }
+        i++;
       }
       else
         *bool_options[token] = true;
@@ -141,22 +143,43 @@ napsat::options::options(vector<string>& tokens)
     {"--restoring-chronological-backtracking",   &restoring_strong_chronological_backtracking},
     {"-lscb",                                    &lazy_strong_chronological_backtracking},
     {"--lazy-strong-chronological-backtracking", &lazy_strong_chronological_backtracking},
+    {"-acb",                                     &adaptive_backtracking},
+    {"--adaptive-backtracking",                  &adaptive_backtracking},
     {"-o",                                       &observing},
     {"--observing",                              &observing},
     {"-i",                                       &interactive},
     {"--interactive",                            &interactive},
     {"-c",                                       &check_invariants},
     {"--check-invariants",                       &check_invariants},
+    {"-fic",                                     &full_invariant_check},
+    {"--full-invariant-check",                   &full_invariant_check},
     {"-stat",                                    &print_stats},
     {"--statistics",                             &print_stats},
+    {"-bench",                                   &benchmark},
+    {"--benchmark",                              &benchmark},
     {"-del",                                     &delete_clauses},
     {"--delete-clauses",                         &delete_clauses},
+    {"-rmin",                                    &recursive_minimization},
+    {"--recursive-minimization",                 &recursive_minimization},
+    {"-share",                                   &share_clauses},
+    {"--share-clauses",                          &share_clauses},
+    {"-bmin",                                    &binary_minimization},
+    {"--binary-minimization",                    &binary_minimization},
+    {"-prst",                                    &partial_restarts},
+    {"--partial-restarts",                       &partial_restarts},
+    {"-rephase",                                 &rephase},
+    {"--rephase",                                &rephase},
+    {"-viv",                                     &vivification},
+    {"--vivification",                           &vivification},
+    {"-pre",                                     &preprocess},
+    {"--preprocess",                             &preprocess},
     {"-bp",                                      &build_proof},
     {"--proof",                                  &build_proof},
     {"-pp",                                      &print_proof},
     {"--print-proof",                            &print_proof},
     {"-cp",                                      &check_proof},
     {"--check-proof",                            &check_proof},
+    {"--binary-proof",                           &binary_proof},
   };
 
   /**
@@ -165,21 +188,69 @@ napsat::options::options(vector<string>& tokens)
   std::unordered_map<string, double*> double_options = {
     {"--clause-elimination-multiplier",   &clause_elimination_multiplier},
     {"--clause-activity-multiplier",      &clause_activity_multiplier},
-    {"--clause-activity-threshold-decay", &clause_activity_threshold_decay},
+    {"--local-reduction-fraction",        &local_reduction_fraction},
+    {"--vivification-effort",             &vivification_effort},
+    {"--adaptive-backtracking-margin",    &adaptive_backtracking_margin},
     {"--var-activity-decay",              &var_activity_decay},
     {"--agility-decay",                   &agility_decay},
     {"--agility-threshold",               &agility_threshold},
-    {"--agility-threshold-decay",         &agility_threshold_decay}
+    {"--agility-threshold-decay",         &agility_threshold_decay},
+    {"--restart-geometric-factor",        &restart_geometric_factor},
+    {"--restart-ema-fast",                &restart_ema_fast},
+    {"--restart-ema-slow",                &restart_ema_slow},
+    {"--restart-margin",                  &restart_margin}
+  };
+
+  /**
+   * @brief map of unsigned integer options that can be set with a string.
+  */
+  std::unordered_map<string, unsigned*> unsigned_options = {
+    {"-hist",               &history_size},
+    {"--history-size",      &history_size},
+    {"-snap",               &snapshot_interval},
+    {"--snapshot-interval", &snapshot_interval},
+    {"--core-lbd",          &core_lbd},
+    {"--tier2-lbd",         &tier2_lbd},
+    {"-mem",                &memory_limit},
+    {"--memory-limit",      &memory_limit},
+    {"--restart-interval",  &restart_interval},
+    {"--rephase-interval",  &rephase_interval},
+    {"--adaptive-backtracking-levels", &adaptive_backtracking_levels},
+    {"-seed",               &seed},
+    {"--seed",              &seed},
+    {"-portfolio",          &portfolio},
+    {"--portfolio",         &portfolio},
+    {"--share-max-size",    &share_max_size},
+    {"--share-lbd",         &share_lbd},
+    {"-cube",               &cubes},
+    {"--cubes",             &cubes},
+    {"--lookahead-candidates",    &lookahead_candidates},
+    {"-conquer",            &conquer},
+    {"--conquer",           &conquer},
+    {"--elim-max-occurrences",    &elim_max_occurrences},
+    {"--elim-max-resolvent-size", &elim_max_resolvent_size},
+    {"-cpt",                &check_proof_threads},
+    {"--check-proof-threads",     &check_proof_threads}
   };
 
   /**
    * @brief map of string options that can be set with a string.
   */
   std::unordered_map<string, string*> string_options = {
-    {"-s",             &save_folder},
-    {"--save",         &save_folder},
-    {"-commands",      &commands_file},
-    {"--command-file", &commands_file}
+    {"-s",               &save_folder},
+    {"--save",           &save_folder},
+    {"-commands",        &commands_file},
+    {"--command-file",   &commands_file},
+    {"-trace",           &trace_file},
+    {"--trace-file",     &trace_file},
+    {"-restart",         &restart_policy},
+    {"--restart-policy", &restart_policy},
+    {"-dh",                   &decision_heuristic},
+    {"--decision-heuristic",  &decision_heuristic},
+    {"-drat",                 &proof_file},
+    {"--proof-file",          &proof_file},
+    {"-cf",                   &cube_file},
+    {"--cube-file",           &cube_file}
   };
 
   unsigned n_tokens = tokens.size();
@@ -204,6 +275,7 @@ napsat::options::options(vector<string>& tokens)
           LOG_WARNING("Default value " << (*bool_options[token] ? "on" : "off") << " is used.");
           continue;
         }
+        i++;
       }
       else
         *bool_options[token] = true;
@@ -226,6 +298,23 @@ napsat::options::options(vector<string>& tokens)
         continue;
       }
     }
+    else if (unsigned_options.find(token) != unsigned_options.end()) {
+      if (next_token == "" || next_token[0] == '-') {
+        LOG_WARNING("option " << token << " requires a value (unsigned integer).");
+        LOG_WARNING("Default value " << *unsigned_options[token] << " is used.");
+        continue;
+      }
+      try {
+        *unsigned_options[token] = stoul(next_token);
+        set_options.insert(token);
+        i++;
+      }
+      catch (const std::exception& e) {
+        LOG_WARNING("option " << token << " requires an unsigned integer value.");
+        LOG_WARNING("Default value " << *unsigned_options[token] << " is used.");
+        continue;
+      }
+    }
     else if (string_options.find(token) != string_options.end()) {
       if (next_token == "" || next_token[0] == '-') {
         LOG_WARNING("option " << token << " requires a value (string of characters).");
@@ -259,14 +348,93 @@ napsat::options::options(vector<string>& tokens)
     LOG_WARNING("The solver will run with restoring strong chronological backtracking.");
     weak_chronological_backtracking = false;
   }
+  // the jumps of the adaptive backtracking are compatible with any chronological backtracking variant
+  if (adaptive_backtracking && !restoring_strong_chronological_backtracking && !lazy_strong_chronological_backtracking)
+    weak_chronological_backtracking = true;
   chronological_backtracking = weak_chronological_backtracking || restoring_strong_chronological_backtracking || lazy_strong_chronological_backtracking;
+  if (adaptive_backtracking_margin < 0) {
+    LOG_ERROR("adaptive backtracking margin must be non-negative.");
+    exit(1);
+  }
 
   interactive |= commands_file != "";
 
-  if (clause_activity_threshold_decay <= 0 || clause_activity_threshold_decay >= 1) {
-    LOG_ERROR("clause activity threshold decay must be between 0 and 1.");
+  if (cubes > 0 && interactive) {
+    LOG_WARNING("the cubes cannot be built in interactive mode. The clause set is solved.");
+    cubes = 0;
+  }
+  if (cubes > 0 && portfolio > 1) {
+    LOG_WARNING("the cubes are built by a single solver. The portfolio is not run.");
+    portfolio = 0;
+  }
+  if (cubes > 0 && conquer > 0) {
+    LOG_ERROR("the cubes of an input cannot be built and solved in the same run.");
+    exit(1);
+  }
+  if (lookahead_candidates == 0) {
+    LOG_ERROR("lookahead candidates must be greater than 0.");
+    exit(1);
+  }
+
+  if (portfolio > 1 && interactive) {
+    LOG_WARNING("the portfolio is not available in interactive mode. A single solver is run.");
+    portfolio = 0;
+  }
+  // the decisions of the user could involve eliminated variables
+  preprocess = preprocess && !interactive;
+  // the decisions of the vivification would be mixed with the decisions of the user
+  vivification = vivification && !interactive;
+
+  if (local_reduction_fraction <= 0 || local_reduction_fraction > 1) {
+    LOG_ERROR("local reduction fraction must be between 0 (excluded) and 1.");
+    exit(1);
+  }
+  if (vivification_effort <= 0 || vivification_effort > 1) {
+    LOG_ERROR("vivification effort must be between 0 (excluded) and 1.");
+    exit(1);
+  }
+  if (restart_policy != "agility" && restart_policy != "luby" && restart_policy != "geometric" && restart_policy != "glucose") {
+    LOG_ERROR("unknown restart policy " << restart_policy << ". The policies are agility, luby, geometric and glucose.");
+    exit(1);
+  }
+  if (decision_heuristic != "vsids" && decision_heuristic != "vmtf") {
+    LOG_ERROR("unknown decision heuristic " << decision_heuristic << ". The heuristics are vsids and vmtf.");
+    exit(1);
+  }
+  if (restart_interval == 0) {
+    LOG_ERROR("restart interval must be greater than 0.");
     exit(1);
   }
+  if (rephase_interval == 0) {
+    LOG_ERROR("rephase interval must be greater than 0.");
+    exit(1);
+  }
+  if (restart_geometric_factor < 1 || restart_margin < 1) {
+    LOG_ERROR("restart geometric factor and restart margin must be at least 1.");
+    exit(1);
+  }
+  if (restart_ema_fast <= 0 || restart_ema_fast > 1 || restart_ema_slow <= 0 || restart_ema_slow > 1) {
+    LOG_ERROR("restart moving average smoothing factors must be between 0 (excluded) and 1.");
+    exit(1);
+  }
+  if (tier2_lbd < core_lbd) {
+    LOG_WARNING("tier 2 LBD is lower than the core LBD. The solver will run with tier 2 LBD " << core_lbd << ".");
+    tier2_lbd = core_lbd;
+  }
 
   build_proof = build_proof || print_proof || check_proof;
+  check_invariants = check_invariants || full_invariant_check;
+
+  if (share_max_size > utils::clause_exchange::MAX_SIZE) {
+    LOG_WARNING("clauses of more than " << utils::clause_exchange::MAX_SIZE << " literals cannot be shared. The solver will run with share max size " << utils::clause_exchange::MAX_SIZE << ".");
+    share_max_size = utils::clause_exchange::MAX_SIZE;
+  }
+  if (portfolio > 1 && proof_file != "") {
+    LOG_WARNING("a DRAT proof cannot be written by a portfolio. The solver will run without portfolio.");
+    portfolio = 0;
+  }
+  if (portfolio > 1 && share_clauses && build_proof) {
+    LOG_WARNING("clause sharing is not available when building a proof. The solvers of the portfolio will not share clauses.");
+    share_clauses = false;
+  }
 }
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/cardinality-propagator.cpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It implements the propagator of the cardinality
+ * constraints.
+ */
+#include "cardinality-propagator.hpp"
+#include "NapSAT.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+void napsat::cardinality_propagator::collect_true_literals(const TSconstraint& constraint, unsigned long before)
+{
+  _true_literals.clear();
+  for (unsigned i = constraint.begin; i < constraint.begin + constraint.size; i++) {
+    Tlit lit = _literals[i];
+    if (lit_true(lit) && _stamps[lit_to_var(lit)] < before)
+      _true_literals.push_back(lit);
+  }
+}
+
+napsat::Tclause napsat::cardinality_propagator::add_constraint(const Tlit* lits, unsigned size, unsigned bound)
+{
+  assert(bound > 0 && bound < size);
+  unsigned id = _constraints.size();
+  TSconstraint constraint;
+  constraint.begin = _literals.size();
+  constraint.size = size;
+  constraint.bound = bound;
+  constraint.count = 0;
+  for (unsigned i = 0; i < size; i++) {
+    Tlit lit = lits[i];
+    _literals.push_back(lit);
+    if (lit >= _occurrences.size())
+      _occurrences.resize(2 * lit_to_var(lit) + 2);
+    if (lit_to_var(lit) >= _stamps.size())
+      _stamps.resize(lit_to_var(lit) + 1, 0);
+    _occurrences[lit].push_back(id);
+    constraint.count += lit_true(lit);
+  }
+  _constraints.push_back(constraint);
+  // the true literals are already propagated, the constraint is propagated once here
+  if (constraint.count >= bound)
+    for (unsigned i = 0; i < size; i++)
+      if (lit_true(lits[i]))
+        return propagate(lits[i]);
+  return CLAUSE_UNDEF;
+}
+
+void napsat::cardinality_propagator::assign(Tlit lit)
+{
+  Tvar var = lit_to_var(lit);
+  if (var < _stamps.size())
+    _stamps[var] = _next_stamp++;
+  if (lit < _occurrences.size())
+    for (unsigned id : _occurrences[lit])
+      _constraints[id].count++;
+}
+
+void napsat::cardinality_propagator::unassign(Tlit lit)
+{
+  if (lit < _occurrences.size())
+    for (unsigned id : _occurrences[lit])
+      _constraints[id].count--;
+}
+
+napsat::Tclause napsat::cardinality_propagator::propagate(Tlit lit)
+{
+  if (lit >= _occurrences.size())
+    return CLAUSE_UNDEF;
+  for (unsigned id : _occurrences[lit]) {
+    const TSconstraint& constraint = _constraints[id];
+    if (constraint.count < constraint.bound)
+      continue;
+    collect_true_literals(constraint, _next_stamp);
+    if (constraint.count > constraint.bound) {
+      // the bound + 1 true literals at the lowest levels make the conflict with the lowest level
+      sort(_true_literals.begin(), _true_literals.end(), [this](Tlit a, Tlit b) {
+        return lit_level(a) < lit_level(b);
+      });
+      _true_literals.resize(constraint.bound + 1);
+      reverse(_true_literals.begin(), _true_literals.end());
+      for (Tlit& other : _true_literals)
+        other = lit_neg(other);
+      return conflict(_true_literals);
+    }
+    Tlevel level = LEVEL_ROOT;
+    for (Tlit other : _true_literals)
+      level = max(level, lit_level(other));
+    for (unsigned i = constraint.begin; i < constraint.begin + constraint.size; i++)
+      if (lit_undef(_literals[i]))
+        imply(lit_neg(_literals[i]), level, id);
+  }
+  return CLAUSE_UNDEF;
+}
+
+void napsat::cardinality_propagator::explain(Tlit lit, unsigned constraint, vector<Tlit>& reason)
+{
+  assert(lit_true(lit));
+  collect_true_literals(_constraints[constraint], _stamps[lit_to_var(lit)]);
+  assert(_true_literals.size() == _constraints[constraint].bound);
+  reason.push_back(lit);
+  for (Tlit other : _true_literals)
+    reason.push_back(lit_neg(other));
+  auto highest = max_element(reason.begin() + 1, reason.end(), [this](Tlit a, Tlit b) {
+    return lit_level(a) < lit_level(b);
+  });
+  swap(reason[1], *highest);
+}
+
+void napsat::cardinality_propagator::freeze(vector<bool>& frozen) const
+{
+  for (Tlit lit : _literals)
+    frozen[lit_to_var(lit)] = true;
+}
+
+size_t napsat::cardinality_propagator::memory_size() const
+{
+  size_t size = _constraints.capacity() * sizeof(TSconstraint);
+  size += (_literals.capacity() + _true_literals.capacity()) * sizeof(Tlit);
+  size += _stamps.capacity() * sizeof(unsigned long);
+  size += _occurrences.capacity() * sizeof(vector<unsigned>);
+  for (const vector<unsigned>& occurrences : _occurrences)
+    size += occurrences.capacity() * sizeof(unsigned);
+  return size;
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/cardinality-propagator.hpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It defines the propagator of the cardinality
+ * constraints, that is, the constraints stating that at most k literals of a set are true. The at-most-one
+ * constraints are the cardinality constraints with k = 1.
+ * @details Each constraint counts its true literals. Once k literals are true, the other ones are implied
+ * false, and a conflict is reported when more than k literals are true. The memory is linear in the size
+ * of the constraints, whereas a clausal encoding of an at-most-one constraint is quadratic or needs
+ * auxiliary variables.
+ */
+#pragma once
+
+#include "propagator.hpp"
+
+#include <vector>
+
+namespace napsat
+{
+  class cardinality_propagator : public propagator
+  {
+  private:
+    typedef struct TSconstraint
+    {
+      /**
+       * @brief Position of the first literal of the constraint in _literals.
+       */
+      unsigned begin;
+      /**
+       * @brief Number of literals of the constraint.
+       */
+      unsigned size;
+      /**
+       * @brief Maximum number of true literals.
+       */
+      unsigned bound;
+      /**
+       * @brief Number of literals of the constraint currently true.
+       */
+      unsigned count;
+    } TSconstraint;
+
+    std::vector<TSconstraint> _constraints;
+    /**
+     * @brief Literals of the constraints, stored contiguously.
+     */
+    std::vector<Tlit> _literals;
+    /**
+     * @brief Constraints in which each literal occurs.
+     */
+    std::vector<std::vector<unsigned>> _occurrences;
+    /**
+     * @brief Order of assignment of the variables of the constraints. The reason of an implied literal is
+     * made of the true literals of the constraint assigned before it.
+     */
+    std::vector<unsigned long> _stamps;
+    unsigned long _next_stamp = 1;
+    /**
+     * @brief Buffer for the true literals of a constraint.
+     */
+    std::vector<Tlit> _true_literals;
+
+    /**
+     * @brief Collects the true literals of the constraint in _true_literals.
+     * @param before only the literals assigned before this stamp are collected.
+     */
+    void collect_true_literals(const TSconstraint& constraint, unsigned long before);
+
+  public:
+    cardinality_propagator(NapSAT& solver, unsigned id) : propagator(solver, id) {}
+
+    /**
+     * @brief Adds the constraint stating that at most bound literals of lits are true.
+     * @return a conflicting clause if the constraint is already violated, and CLAUSE_UNDEF otherwise.
+     * @pre The literals are distinct, no literal occurs with its negation, 0 < bound < size, and the
+     * solver is at level 0.
+     * @details The literals already implied by the constraint are implied at level 0.
+     */
+    Tclause add_constraint(const Tlit* lits, unsigned size, unsigned bound);
+
+    /**
+     * @brief Returns the number of constraints.
+     */
+    unsigned size() const { return _constraints.size(); }
+
+    void assign(Tlit lit) override;
+    void unassign(Tlit lit) override;
+    Tclause propagate(Tlit lit) override;
+    void explain(Tlit lit, unsigned constraint, std::vector<Tlit>& reason) override;
+    void freeze(std::vector<bool>& frozen) const override;
+    size_t memory_size() const override;
+  };
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/solver/propagator.hpp
+ * @author Robin Coutelier
+ * @brief This file is part of the NapSAT solver. It defines the interface of the propagators of the
+ * constraints that are not clauses, such as cardinality constraints.
+ * @details A propagator is told about every assignment and unassignment of a literal, such that it can
+ * maintain counters. Each literal of the trail is then given to the propagators once its clauses are
+ * propagated. The propagator implies literals with imply, without a reason clause. The reason clause of
+ * an implied literal is only requested with explain when the conflict analysis resolves it, and is then
+ * added to the clause set as a learned clause. A conflict is reported with a conflicting clause built by
+ * conflict. New theories are added by deriving this class and registering the propagator in the solver.
+ */
+#pragma once
+
+#include "SAT-types.hpp"
+
+#include <vector>
+
+namespace napsat
+{
+  class NapSAT;
+
+  class propagator
+  {
+  public:
+    /**
+     * @param solver the solver that owns the propagator.
+     * @param id index of the propagator in the solver, stored with the literals it implies.
+     */
+    propagator(NapSAT& solver, unsigned id) : _solver(solver), _id(id) {}
+
+    virtual ~propagator() = default;
+
+    /**
+     * @brief Called whenever lit is assigned true, including by the propagator itself.
+     * @details Called for every assignment, hence it must be cheap.
+     */
+    virtual void assign(Tlit lit) = 0;
+
+    /**
+     * @brief Called whenever lit, which was true, is unassigned by backtracking.
+     */
+    virtual void unassign(Tlit lit) = 0;
+
+    /**
+     * @brief Propagates the constraints of the literal lit, which is true.
+     * @return a clause built by conflict if a constraint is violated, and CLAUSE_UNDEF otherwise.
+     * @details The literals must be implied at the highest level of the literals of their reason, which
+     * may be lower than the current level in chronological backtracking.
+     */
+    virtual Tclause propagate(Tlit lit) = 0;
+
+    /**
+     * @brief Writes in reason the clause explaining the implication of lit by the given constraint.
+     * @details The first literal of the reason is lit, and the second one is the literal with the
+     * highest level among the other ones, which are false. The literals of the reason must have been
+     * assigned before lit.
+     */
+    virtual void explain(Tlit lit, unsigned constraint, std::vector<Tlit>& reason) = 0;
+
+    /**
+     * @brief Sets frozen to true for the variables of the constraints, which the preprocessing must not
+     * eliminate.
+     */
+    virtual void freeze(std::vector<bool>& frozen) const = 0;
+
+    /**
+     * @brief Returns the number of bytes held by the constraints of the propagator.
+     */
+    virtual size_t memory_size() const = 0;
+
+  protected:
+    NapSAT& _solver;
+    const unsigned _id;
+
+    /**
+     * The solver only grants access to its internals to the base class, the derived classes go through
+     * these functions. They are defined at the end of NapSAT.hpp.
+     */
+    inline bool lit_true(Tlit lit) const;
+    inline bool lit_undef(Tlit lit) const;
+    inline Tlevel lit_level(Tlit lit) const;
+
+    /**
+     * @brief Implies lit at the given level, as a consequence of the given constraint.
+     * @pre lit is unassigned.
+     */
+    void imply(Tlit lit, Tlevel level, unsigned constraint);
+
+    /**
+     * @brief Adds the conflicting clause lits to the clause set as a learned clause.
+     * @pre The literals are false, the first one at the highest level, and the second one at the
+     * highest level among the other ones.
+     */
+    Tclause conflict(const std::vector<Tlit>& lits);
+  };
+}
@@ -0,0 +1,169 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/utils/clause-exchange.hpp
+ * @author Robin Coutelier
+ *
+ * @brief This file is part of the NapSAT solver. It defines the exchange of learned clauses between the
+ * solvers of a portfolio.
+ */
+#pragma once
+
+#include "SAT-types.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace napsat::utils
+{
+  /**
+   * @brief Exchange of short clauses between workers running on separate threads.
+   * @details Each worker exports its clauses in its own ring of fixed capacity, and reads the rings of
+   * the other workers. Neither side ever blocks: when a ring is full, the oldest clauses are overwritten,
+   * and a worker that reads too slowly misses them. Each slot is protected by a sequence number (as in a
+   * sequence lock) such that a reader detects a slot overwritten while it was reading it and discards it.
+   */
+  class clause_exchange
+  {
+  public:
+    /**
+     * @brief Maximum size of an exchanged clause.
+     */
+    static const unsigned MAX_SIZE = 32;
+
+  private:
+    struct slot
+    {
+      /**
+       * @brief 2 * position + 1 while the clause at position is written, 2 * position + 2 once it is
+       * written.
+       */
+      std::atomic<uint64_t> sequence{0};
+      std::atomic<unsigned> size{0};
+      std::atomic<unsigned> lbd{0};
+      std::atomic<Tlit> lits[MAX_SIZE];
+    };
+
+    struct alignas(64) ring
+    {
+      std::unique_ptr<slot[]> slots;
+      /**
+       * @brief Number of clauses exported in the ring since the beginning.
+       */
+      std::atomic<uint64_t> head{0};
+    };
+
+    /**
+     * @brief Number of slots of each ring.
+     */
+    unsigned _capacity;
+    /**
+     * @brief _rings[w] contains the clauses exported by worker w.
+     */
+    std::vector<std::unique_ptr<ring>> _rings;
+    /**
+     * @brief _positions[w][v] is the number of clauses of worker v already read by worker w. Only worker
+     * w accesses _positions[w].
+     */
+    std::vector<std::vector<uint64_t>> _positions;
+
+  public:
+    /**
+     * @brief Creates an exchange between n_workers workers, in which each worker keeps its last
+     * capacity exported clauses.
+     */
+    clause_exchange(unsigned n_workers, unsigned capacity)
+      : _capacity(capacity),
+      _positions(n_workers, std::vector<uint64_t>(n_workers, 0))
+    {
+      assert(capacity > 0);
+      for (unsigned i = 0; i < n_workers; i++) {
+        _rings.push_back(std::unique_ptr<ring>(new ring));
+        _rings.back()->slots.reset(new slot[capacity]);
+      }
+    }
+
+    /**
+     * @brief Returns the number of workers.
+     */
+    inline unsigned workers() const
+    {
+      return _rings.size();
+    }
+
+    /**
+     * @brief Makes the clause available to the other workers.
+     * @param worker the exporting worker. Only the thread of this worker may export in its ring.
+     * @pre 0 < size <= MAX_SIZE
+     */
+    void export_clause(unsigned worker, const Tlit* lits, unsigned size, unsigned lbd)
+    {
+      assert(worker < _rings.size());
+      assert(size > 0 && size <= MAX_SIZE);
+      ring& r = *_rings[worker];
+      uint64_t position = r.head.load(std::memory_order_relaxed);
+      slot& s = r.slots[position % _capacity];
+      s.sequence.store(2 * position + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      s.size.store(size, std::memory_order_relaxed);
+      s.lbd.store(lbd, std::memory_order_relaxed);
+      for (unsigned i = 0; i < size; i++)
+        s.lits[i].store(lits[i], std::memory_order_relaxed);
+      s.sequence.store(2 * position + 2, std::memory_order_release);
+      r.head.store(position + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Calls consume(lits, size, lbd) on each clause exported by the other workers since the last
+     * call, reading at most limit clauses from each of them.
+     * @param worker the importing worker. Only the thread of this worker may import for it.
+     * @details The clauses left unread are read by the next call, unless they are overwritten by then.
+     * @return the number of clauses consumed.
+     */
+    template <typename consumer>
+    unsigned import_clauses(unsigned worker, unsigned limit, consumer consume)
+    {
+      assert(worker < _rings.size());
+      Tlit lits[MAX_SIZE];
+      unsigned count = 0;
+      for (unsigned other = 0; other < _rings.size(); other++) {
+        if (other == worker)
+          continue;
+        ring& r = *_rings[other];
+        uint64_t head = r.head.load(std::memory_order_acquire);
+        uint64_t& position = _positions[worker][other];
+        // the clauses older than the capacity are overwritten
+        if (head - position > _capacity)
+          position = head - _capacity;
+        if (head - position > limit)
+          head = position + limit;
+        for (; position < head; position++) {
+          slot& s = r.slots[position % _capacity];
+          uint64_t sequence = s.sequence.load(std::memory_order_acquire);
+          if (sequence != 2 * position + 2)
+            continue;
+          unsigned size = s.size.load(std::memory_order_relaxed);
+          unsigned lbd = s.lbd.load(std::memory_order_relaxed);
+          if (size > MAX_SIZE)
+            continue;
+          for (unsigned i = 0; i < size; i++)
+            lits[i] = s.lits[i].load(std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_acquire);
+          // the slot was overwritten while reading it
+          if (s.sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+          consume(lits, size, lbd);
+          count++;
+        }
+      }
+      return count;
+    }
+  };
+}
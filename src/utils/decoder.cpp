@@ -21,6 +21,11 @@
 #include <lzma.h>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 using namespace std;
 
@@ -97,6 +102,116 @@ static string byte_size_to_string(uint64_t n_bytes) {
 }
 
 bool decompress_xz(const char* filename, ostringstream& output)
+{
+  return decompress_xz(filename, [&output](const char* data, size_t size) {
+    output.write(data, size);
+    return true;
+  });
+}
+
+namespace
+{
+  /**
+   * @brief Chunks exchanged between the decompression thread and the consumer.
+   * @details Empty chunks are recycled by the consumer to bound the memory used by the
+   * decompression.
+   */
+  class chunk_queue
+  {
+  private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<std::vector<char>> _chunks;
+    std::deque<std::vector<char>*> _free;
+    std::deque<std::vector<char>*> _ready;
+    bool _finished = false;
+    bool _interrupted = false;
+
+  public:
+    chunk_queue() : _chunks(XZ_CHUNKS_AHEAD, std::vector<char>(XZ_CHUNK_SIZE))
+    {
+      for (std::vector<char>& chunk : _chunks)
+        _free.push_back(&chunk);
+    }
+
+    /**
+     * @brief Returns an empty chunk for the producer, or nullptr if the consumer interrupted
+     * the decompression.
+     */
+    std::vector<char>* take_free()
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this] { return _interrupted || !_free.empty(); });
+      if (_interrupted)
+        return nullptr;
+      std::vector<char>* chunk = _free.front();
+      _free.pop_front();
+      return chunk;
+    }
+
+    /**
+     * @brief Gives a chunk filled with size bytes to the consumer.
+     */
+    void push_ready(std::vector<char>* chunk, size_t size)
+    {
+      chunk->resize(size);
+      std::lock_guard<std::mutex> lock(_mutex);
+      _ready.push_back(chunk);
+      _condition.notify_all();
+    }
+
+    /**
+     * @brief Returns the next chunk for the consumer, or nullptr if there are no more chunks.
+     */
+    std::vector<char>* take_ready()
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this] { return _finished || !_ready.empty(); });
+      if (_ready.empty())
+        return nullptr;
+      std::vector<char>* chunk = _ready.front();
+      _ready.pop_front();
+      return chunk;
+    }
+
+    /**
+     * @brief Gives back a consumed chunk to the producer.
+     */
+    void give_back(std::vector<char>* chunk)
+    {
+      chunk->resize(XZ_CHUNK_SIZE);
+      std::lock_guard<std::mutex> lock(_mutex);
+      _free.push_back(chunk);
+      _condition.notify_all();
+    }
+
+    /**
+     * @brief Signals that the producer will not push any more chunks.
+     */
+    void finish()
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _finished = true;
+      _condition.notify_all();
+    }
+
+    /**
+     * @brief Signals that the consumer does not want any more chunks.
+     */
+    void interrupt()
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _interrupted = true;
+      _condition.notify_all();
+    }
+  };
+}
+
+/**
+ * @brief Decompresses the file into the chunks of the queue.
+ * @return true if the decompression was successful or interrupted, false otherwise.
+ */
+static bool produce_chunks(ifstream& file, chunk_queue& queue)
 {
   lzma_stream strm = LZMA_STREAM_INIT;
   lzma_ret ret = lzma_stream_decoder(&strm, UINT64_MAX, 0);
@@ -104,32 +219,77 @@ bool decompress_xz(const char* filename, ostringstream& output)
     LOG_ERROR("failed to initialize the decompression stream");
     return false;
   }
+  unsigned const buff_size = 1 << 16;
+  char buffer_in[buff_size];
+  lzma_action action = LZMA_RUN;
+
+  std::vector<char>* chunk = queue.take_free();
+  if (!chunk) {
+    lzma_end(&strm);
+    return true;
+  }
+  strm.next_out = reinterpret_cast<uint8_t*>(chunk->data());
+  strm.avail_out = chunk->size();
+  while (true) {
+    if (strm.avail_in == 0 && action == LZMA_RUN) {
+      file.read(buffer_in, sizeof(buffer_in));
+      strm.next_in = reinterpret_cast<const uint8_t*>(buffer_in);
+      strm.avail_in = file.gcount();
+      if (file.eof())
+        action = LZMA_FINISH;
+      else if (!file) {
+        LOG_ERROR("could not read the compressed file");
+        lzma_end(&strm);
+        return false;
+      }
+    }
+    ret = lzma_code(&strm, action);
+    if (ret != LZMA_OK && ret != LZMA_STREAM_END) {
+      print_error_message(ret);
+      lzma_end(&strm);
+      return false;
+    }
+    if (strm.avail_out == 0 || ret == LZMA_STREAM_END) {
+      queue.push_ready(chunk, chunk->size() - strm.avail_out);
+      if (ret == LZMA_STREAM_END)
+        break;
+      chunk = queue.take_free();
+      if (!chunk) {
+        lzma_end(&strm);
+        return true;
+      }
+      strm.next_out = reinterpret_cast<uint8_t*>(chunk->data());
+      strm.avail_out = chunk->size();
+    }
+  }
+  LOG_INFO("Total Decompressed " << byte_size_to_string(strm.total_in) << " to " << byte_size_to_string(strm.total_out));
+  lzma_end(&strm);
+  return true;
+}
+
+bool decompress_xz(const char* filename, const function<bool(const char*, size_t)>& consumer)
+{
   ifstream file(filename, ios::binary);
   if (!file.is_open()) {
     LOG_ERROR("could not open file " << filename);
     return false;
   }
-  unsigned const buff_size = 256;
-  char buffer_in[buff_size];
-  char buffer_out[buff_size];
+  chunk_queue queue;
+  bool success = true;
+  thread producer([&file, &queue, &success] {
+    success = produce_chunks(file, queue);
+    queue.finish();
+  });
 
-  do {
-    strm.avail_in = file.readsome(buffer_in, sizeof(buffer_in));
-    if (strm.avail_in == 0)
+  std::vector<char>* chunk;
+  while ((chunk = queue.take_ready()) != nullptr) {
+    bool keep_going = consumer(chunk->data(), chunk->size());
+    queue.give_back(chunk);
+    if (!keep_going) {
+      queue.interrupt();
       break;
-    strm.next_in = reinterpret_cast<const uint8_t*>(buffer_in);
-    do {
-      strm.avail_out = sizeof(buffer_out);
-      strm.next_out = reinterpret_cast<uint8_t*>(buffer_out);
-      ret = lzma_code(&strm, LZMA_RUN);
-      if (ret != LZMA_OK && ret != LZMA_STREAM_END) {
-        print_error_message(ret);
-        return false;
-      }
-      output.write(buffer_out, sizeof(buffer_out) - strm.avail_out);
-    } while (strm.avail_out == 0);
-  } while (ret != LZMA_STREAM_END);
-  LOG_INFO("Total Decompressed " << byte_size_to_string(strm.total_in) << " to " << byte_size_to_string(strm.total_out));
-
-  return true;
+    }
+  }
+  producer.join();
+  return success;
 }
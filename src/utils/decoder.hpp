@@ -15,8 +15,20 @@
 
 #include <lzma.h>
 #include <fstream>
+#include <functional>
 #include <string>
 
+/**
+ * @brief Size of the chunks of decompressed data given to the consumer of a streaming
+ * decompression.
+ */
+const size_t XZ_CHUNK_SIZE = 1 << 20;
+
+/**
+ * @brief Number of chunks that can be decompressed ahead of the consumer.
+ */
+const unsigned XZ_CHUNKS_AHEAD = 4;
+
 /**
  * @brief Decompresses a XZ file and writes the output to a stream.
  * @param filename The name of the file to decompress.
@@ -26,3 +38,16 @@
  * @details If the decompression fails, an error message is printed to stderr.
  */
 bool decompress_xz(const char* filename, std::ostringstream& output);
+
+/**
+ * @brief Decompresses a XZ file and gives the output to a consumer in chunks.
+ * @param filename The name of the file to decompress.
+ * @param consumer Function called on each chunk of decompressed data, in order. If it returns
+ * false, the decompression is interrupted.
+ * @return true if the decompression was successful or interrupted by the consumer, false
+ * otherwise.
+ * @details The decompression runs on a separate thread while the consumer is called on the
+ * calling thread. At most XZ_CHUNKS_AHEAD chunks of XZ_CHUNK_SIZE bytes are allocated, such that
+ * the memory does not depend on the size of the file.
+ */
+bool decompress_xz(const char* filename, const std::function<bool(const char*, size_t)>& consumer);
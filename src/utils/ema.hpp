@@ -0,0 +1,67 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/utils/ema.hpp
+ * @author Robin Coutelier
+ *
+ * @brief This file is part of the NapSAT solver. It defines an exponential moving average.
+ */
+#pragma once
+
+#include <cassert>
+
+namespace napsat::utils
+{
+  /**
+   * @brief Exponential moving average with bias correction.
+   * @details A plain exponential moving average initialized to 0 underestimates the average until
+   * roughly 1 / alpha values were added. The bias is corrected by dividing the average by
+   * 1 - (1 - alpha)^n, where n is the number of values added. Therefore, slow averages are
+   * meaningful from the beginning of the search.
+   */
+  class ema
+  {
+  private:
+    /**
+     * @brief Smoothing factor. The weight of the new values.
+     */
+    double _alpha = 1;
+    /**
+     * @brief Biased average.
+     */
+    double _biased = 0;
+    /**
+     * @brief (1 - alpha)^n, where n is the number of values added.
+     */
+    double _beta = 1;
+
+  public:
+    ema() = default;
+
+    inline ema(double alpha) : _alpha(alpha)
+    {
+      assert(alpha > 0 && alpha <= 1);
+    }
+
+    /**
+     * @brief Adds a value to the average.
+     */
+    inline void update(double value)
+    {
+      _biased += _alpha * (value - _biased);
+      _beta *= 1 - _alpha;
+    }
+
+    /**
+     * @brief Returns the corrected average, or 0 if no value was added.
+     */
+    inline double value() const
+    {
+      return _beta == 1 ? 0 : _biased / (1 - _beta);
+    }
+  };
+}
@@ -19,60 +19,48 @@
 
 using namespace napsat::utils;
 
-void heap::swap(unsigned i, unsigned j)
-{
-  assert(i < _heap.size());
-  assert(j < _heap.size());
-  unsigned key_i = _heap[i];
-  unsigned key_j = _heap[j];
-  _heap[i] = key_j;
-  _heap[j] = key_i;
-  _index[key_i] = j;
-  _index[key_j] = i;
-}
-
 void heap::heapify_down(unsigned i)
 {
   assert(i < _heap.size());
-  while (left(i) < _heap.size()) {
-    unsigned child;
-    if (right(i) < _heap.size()
-      && _activity[_heap[right(i)]] > _activity[_heap[left(i)]])
-      child = right(i);
-    else
-      child = left(i);
-    if (_activity[_heap[child]] <= _activity[_heap[i]])
+  entry moved = _heap[i];
+  unsigned size = _heap.size();
+  while (first_child(i) < size) {
+    unsigned first = first_child(i);
+    unsigned last = first + 4 < size ? first + 4 : size;
+    unsigned child = first;
+    for (unsigned j = first + 1; j < last; j++)
+      if (_heap[j].activity > _heap[child].activity)
+        child = j;
+    if (_heap[child].activity <= moved.activity)
       break;
-
-    swap(i, child);
+    _heap[i] = _heap[child];
+    _index[_heap[i].key] = i;
     i = child;
   }
+  _heap[i] = moved;
+  _index[moved.key] = i;
 }
 
 void heap::heapify_up(unsigned i)
 {
   assert(i < _heap.size());
-  unsigned p = parent(i);
-  while (i && _activity[_heap[i]] > _activity[_heap[p]]) {
-    swap(i, p);
+  entry moved = _heap[i];
+  while (i && moved.activity > _heap[parent(i)].activity) {
+    _heap[i] = _heap[parent(i)];
+    _index[_heap[i].key] = i;
     i = parent(i);
-    p = parent(i);
   }
+  _heap[i] = moved;
+  _index[moved.key] = i;
 }
 
 void heap::insert(unsigned key, double activity)
 {
-  if (_index.size() <= key) {
-    unsigned old_size = _index.size();
-    _index.resize(key + 1);
-    _activity.resize(key + 1);
-    for (unsigned i = old_size; i < _index.size(); i++)
-      _index[i] = LOCATION_UNDEF;
-  }
+  if (_index.size() <= key)
+    _index.resize(key + 1, LOCATION_UNDEF);
   assert(_index[key] == LOCATION_UNDEF);
-  _heap.push_back(key);
+  _heap.push_back({activity, key});
   _index[key] = _heap.size() - 1;
-  _activity[key] = activity;
   heapify_up(_heap.size() - 1);
 }
 
@@ -81,25 +69,29 @@ void heap::remove(unsigned key)
   assert(key < _index.size());
   assert(_index[key] != LOCATION_UNDEF);
   unsigned i = _index[key];
-  swap(i, _heap.size() - 1);
-  _heap.pop_back();
   _index[key] = LOCATION_UNDEF;
-  if (i < _heap.size())
-    heapify_down(i);
+  entry last = _heap.back();
+  _heap.pop_back();
+  if (i == _heap.size())
+    return;
+  _heap[i] = last;
+  _index[last.key] = i;
+  heapify_up(i);
+  heapify_down(_index[last.key]);
 }
 
 void napsat::utils::heap::update(unsigned key, double activity)
 {
   assert(_index[key] != LOCATION_UNDEF);
-  _activity[key] = activity;
+  _heap[_index[key]].activity = activity;
   heapify_up(_index[key]);
   heapify_down(_index[key]);
 }
 
 void napsat::utils::heap::normalize(double factor)
 {
-  for (unsigned i = 0; i < _activity.size(); i++)
-    _activity[i] *= factor;
+  for (entry& e : _heap)
+    e.activity *= factor;
 }
 
 bool napsat::utils::heap::contains(unsigned key)
@@ -110,27 +102,29 @@ bool napsat::utils::heap::contains(unsigned key)
 void napsat::utils::heap::increase_activity(unsigned key, double activity)
 {
   assert(_index[key] != LOCATION_UNDEF);
-  assert(_activity[key] <= activity);
-  _activity[key] = activity;
+  assert(_heap[_index[key]].activity <= activity);
+  _heap[_index[key]].activity = activity;
   heapify_up(_index[key]);
 }
 
 unsigned heap::pop()
 {
   assert(_heap.size() > 0);
-  unsigned key = _heap[0];
-  swap(0, _heap.size() - 1);
+  unsigned key = _heap[0].key;
+  _index[key] = LOCATION_UNDEF;
+  entry last = _heap.back();
   _heap.pop_back();
-  if (_heap.size() > 0)
+  if (_heap.size() > 0) {
+    _heap[0] = last;
     heapify_down(0);
-  _index[key] = LOCATION_UNDEF;
+  }
   return key;
 }
 
 unsigned heap::top()
 {
   assert(_heap.size() > 0);
-  return _heap[0];
+  return _heap[0].key;
 }
 
 unsigned heap::size()
@@ -145,43 +139,16 @@ bool heap::empty()
 
 void napsat::utils::heap::print()
 {
-  static std::vector<unsigned> bfs_queue;
-  bfs_queue.clear();
-  bfs_queue.push_back(0);
-  unsigned i = 0;
-  while (i < bfs_queue.size()) {
-    unsigned j = bfs_queue[i];
-    if (left(j) < _heap.size())
-      bfs_queue.push_back(left(j));
-    if (right(j) < _heap.size())
-      bfs_queue.push_back(right(j));
-    i++;
-  }
-
-  unsigned max_width = 1;
-  unsigned max_height = 0;
-  for (unsigned i = 0; i < _heap.size(); i = left(i)) {
-    max_width = max_width << 1;
-    max_height++;
-  }
-  unsigned height = 0;
+  // one line per depth of the tree
+  unsigned next_depth = 1;
   unsigned width = 1;
-  unsigned next_level = 1;
-  for (unsigned i = 0; i < bfs_queue.size(); i++) {
-    for (unsigned k = 0; k < max_width / width / 2; k++)
-      std::cout << "      ";
-    if (i == next_level) {
+  for (unsigned i = 0; i < _heap.size(); i++) {
+    if (i == next_depth) {
       std::cout << std::endl;
-      width = width << 1;
-      next_level += width;
-      height++;
-    }
-    unsigned j = bfs_queue[i];
-    if (j < _heap.size()) {
-      std::cout << _heap[j] << " (" << _activity[_heap[j]] << ") ";
-    }
-    else {
-      std::cout << "X ";
+      width *= 4;
+      next_depth += width;
     }
+    std::cout << _heap[i].key << " (" << _heap[i].activity << ") ";
   }
+  std::cout << std::endl;
 }
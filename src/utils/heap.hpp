@@ -20,48 +20,42 @@ namespace napsat::utils
 {
   /**
    * @warning The heap should not be used for arbitrary keys. The memory allocated is proportional to the largest key. This structure is meant for densely packed keys.
+   * @details The heap is 4-ary: the children of the node at index i are at indices 4i+1 to 4i+4. The tree is half as deep as a binary heap, and the four children compared when sifting down are contiguous in memory. The activity is stored next to the key in the heap array, such that comparing two nodes does not require an indirection.
   */
   class heap
   {
   private:
+    /**
+     * @brief Node of the heap.
+    */
+    struct entry
+    {
+      double activity;
+      unsigned key;
+    };
     /**
      * @brief The heap.
     */
-    std::vector<unsigned> _heap;
+    std::vector<entry> _heap;
     /**
      * @brief The index of each element in the heap.
     */
     std::vector<unsigned> _index;
-    /**
-     * @brief The activity of each element in the heap.
-    */
-    std::vector<double> _activity;
 
     inline unsigned parent(unsigned i)
     {
-      return (i - 1) / 2;
-    }
-    inline unsigned left(unsigned i)
-    {
-      return 2 * i + 1;
+      return (i - 1) / 4;
     }
-    inline unsigned right(unsigned i)
+    inline unsigned first_child(unsigned i)
     {
-      return 2 * i + 2;
+      return 4 * i + 1;
     }
 
-    /**
-     * @brief Swaps two elements in the heap.
-     * @param i The index of the first element.
-     * @param j The index of the second element.
-     * @details This function swaps the elements in the heap, the index and the activities.
-    */
-    void swap(unsigned i, unsigned j);
-
     /**
      * @brief Heapifies downward the heap from the given index down.
      * @param i The index from which to heapify down.
      * @pre The activity of the element at index i is lower than or equal to the activity of its children.
+     * @details The larger children are moved up into the hole instead of swapping the element at each level.
     */
     void heapify_down(unsigned i);
 
@@ -117,6 +111,22 @@ namespace napsat::utils
     */
     void normalize(double factor);
 
+    /**
+     * @brief Reads the activity of every element again and restores the heap order.
+     * @param activity_of Function returning the activity of a key.
+     * @details Complexity: O(n) where n is the size of the heap. This is cheaper than calling update for every element when most activities changed.
+    */
+    template <typename activity_function>
+    void rebuild(activity_function activity_of)
+    {
+      for (entry& e : _heap)
+        e.activity = activity_of(e.key);
+      // the nodes after size / 4 are leaves
+      for (unsigned i = _heap.size() / 4 + 1; i-- > 0;)
+        if (i < _heap.size())
+          heapify_down(i);
+    }
+
     /**
      * @brief Checks if the heap contains the given key.
      * @param key The key to check.
@@ -0,0 +1,56 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/utils/profiler.cpp
+ * @author Robin Coutelier
+ *
+ * @brief This file is part of the NapSAT solver. It implements the phase profiler of the solver.
+ */
+#include "profiler.hpp"
+
+#include <cassert>
+
+using namespace napsat::utils;
+
+const char* napsat::utils::phase_names[PHASE_COUNT] = {
+  "parse",
+  "search",
+  "propagate",
+  "analyze",
+  "backtrack",
+  "purge",
+  "simplify",
+  "preprocess",
+  "vivify",
+  "cube"
+};
+
+profiler::clock::time_point profiler::charge()
+{
+  clock::time_point now = clock::now();
+  if (!_stack.empty())
+    _time[_stack.back()] += now - _last;
+  return now;
+}
+
+void profiler::set_enabled(bool enabled)
+{
+  assert(_stack.empty());
+  _enabled = enabled;
+}
+
+double profiler::seconds(phase ph) const
+{
+  assert(ph < PHASE_COUNT);
+  return std::chrono::duration<double>(_time[ph]).count();
+}
+
+unsigned long profiler::calls(phase ph) const
+{
+  assert(ph < PHASE_COUNT);
+  return _calls[ph];
+}
@@ -0,0 +1,148 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/utils/profiler.hpp
+ * @author Robin Coutelier
+ *
+ * @brief This file is part of the NapSAT solver. It defines a lightweight phase profiler used to
+ * measure the time spent in the main procedures of the solver.
+ */
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+namespace napsat::utils
+{
+  /**
+   * @brief Phases of the solver measured by the profiler.
+   */
+  enum phase
+  {
+    PHASE_PARSE = 0,
+    PHASE_SEARCH,
+    PHASE_PROPAGATE,
+    PHASE_ANALYZE,
+    PHASE_BACKTRACK,
+    PHASE_PURGE,
+    PHASE_SIMPLIFY,
+    PHASE_PREPROCESS,
+    PHASE_VIVIFY,
+    PHASE_CUBE,
+    PHASE_COUNT
+  };
+
+  /**
+   * @brief Names of the phases, indexed by the phase enumeration.
+   */
+  extern const char* phase_names[PHASE_COUNT];
+
+  /**
+   * @brief Measures the exclusive time spent in each phase.
+   * @details Phases can be nested (e.g., backtracking happens during conflict analysis, which
+   * happens during propagation). The search phase covers the remainder of the solving loop
+   * (decisions, restarts, ...). The time is only charged to the innermost running phase, such
+   * that the sum of all phases is the total measured time.
+   * @details When the profiler is disabled, start and stop return immediately without reading the
+   * clock.
+   */
+  class profiler
+  {
+  private:
+    typedef std::chrono::steady_clock clock;
+
+    /**
+     * @brief True if the profiler measures the time.
+     */
+    bool _enabled = false;
+    /**
+     * @brief Stack of running phases.
+     */
+    std::vector<phase> _stack;
+    /**
+     * @brief Time at which the top of the stack was last resumed.
+     */
+    clock::time_point _last;
+    /**
+     * @brief Exclusive time spent in each phase.
+     */
+    clock::duration _time[PHASE_COUNT] = {};
+    /**
+     * @brief Number of times each phase was entered.
+     */
+    unsigned long _calls[PHASE_COUNT] = {};
+
+    /**
+     * @brief Charges the time elapsed since the last event to the running phase.
+     */
+    clock::time_point charge();
+
+  public:
+    /**
+     * @brief RAII helper running a phase for the lifetime of the object.
+     */
+    class scope
+    {
+    private:
+      profiler& _profiler;
+
+    public:
+      inline scope(profiler& p, phase ph) : _profiler(p)
+      {
+        _profiler.start(ph);
+      }
+
+      inline ~scope()
+      {
+        _profiler.stop();
+      }
+    };
+
+    /**
+     * @brief Enables or disables the profiler.
+     */
+    void set_enabled(bool enabled);
+
+    /**
+     * @brief Returns true if the profiler is enabled.
+     */
+    inline bool enabled() const { return _enabled; }
+
+    /**
+     * @brief Pauses the running phase and starts the given phase.
+     */
+    inline void start(phase ph)
+    {
+      if (!_enabled)
+        return;
+      _last = charge();
+      _stack.push_back(ph);
+      _calls[ph]++;
+    }
+
+    /**
+     * @brief Stops the running phase and resumes the enclosing one.
+     */
+    inline void stop()
+    {
+      if (!_enabled)
+        return;
+      _last = charge();
+      _stack.pop_back();
+    }
+
+    /**
+     * @brief Returns the exclusive time spent in a phase, in seconds.
+     */
+    double seconds(phase ph) const;
+
+    /**
+     * @brief Returns the number of times a phase was entered.
+     */
+    unsigned long calls(phase ph) const;
+  };
+}
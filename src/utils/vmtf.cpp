@@ -0,0 +1,88 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/utils/vmtf.cpp
+ * @author Robin Coutelier
+ *
+ * @brief This file is part of the NapSAT solver. It implements a variable-move-to-front queue for integer keys.
+ */
+#include "vmtf.hpp"
+
+#include <cassert>
+
+using namespace napsat::utils;
+
+void vmtf::unlink(unsigned key)
+{
+  link& l = _links[key];
+  if (l.prev != LOCATION_UNDEF)
+    _links[l.prev].next = l.next;
+  else
+    _first = l.next;
+  if (l.next != LOCATION_UNDEF)
+    _links[l.next].prev = l.prev;
+  else
+    _last = l.prev;
+  l.prev = l.next = LOCATION_UNDEF;
+}
+
+void vmtf::append(unsigned key)
+{
+  link& l = _links[key];
+  l.prev = _last;
+  l.next = LOCATION_UNDEF;
+  l.stamp = ++_stamp;
+  if (_last != LOCATION_UNDEF)
+    _links[_last].next = key;
+  else
+    _first = key;
+  _last = key;
+}
+
+void vmtf::insert(unsigned key)
+{
+  if (_links.size() <= key)
+    _links.resize(key + 1);
+  assert(!contains(key));
+  append(key);
+  _search = key;
+  _size++;
+}
+
+void vmtf::remove(unsigned key)
+{
+  assert(contains(key));
+  // the keys more recent than the removed key are not candidates
+  if (_search == key)
+    _search = _links[key].prev;
+  unlink(key);
+  _links[key].stamp = 0;
+  _size--;
+}
+
+void vmtf::move_to_front(unsigned key)
+{
+  assert(contains(key));
+  if (key == _last)
+    return;
+  unlink(key);
+  append(key);
+}
+
+void vmtf::update_search(unsigned key)
+{
+  assert(contains(key));
+  if (_search == LOCATION_UNDEF || _links[key].stamp > _links[_search].stamp)
+    _search = key;
+}
+
+unsigned vmtf::skip()
+{
+  assert(_search != LOCATION_UNDEF);
+  _search = _links[_search].prev;
+  return _search;
+}
@@ -0,0 +1,136 @@
+/*
+ * This file is part of the source code of the software program
+ * NapSAT. It is protected by applicable copyright laws.
+ *
+ * This source code is protected by the terms of the MIT License.
+ */
+/**
+ * @file src/utils/vmtf.hpp
+ * @author Robin Coutelier
+ *
+ * @brief This file is part of the NapSAT solver. It defines a variable-move-to-front queue for integer keys.
+ */
+#pragma once
+
+#include <vector>
+
+#ifndef LOCATION_UNDEF
+#define LOCATION_UNDEF 0xffffffff
+#endif
+
+namespace napsat::utils
+{
+  /**
+   * @brief Doubly linked queue of keys ordered by the time they were last moved to the front.
+   * @details Each key receives a new, increasing timestamp when it is moved to the front, such that the order of two keys is decided by comparing their timestamps. The queue also maintains a search position. The user of the queue must ensure that every key more recent than the search position is not a candidate (e.g. the variable is assigned), by calling update_search when a key becomes a candidate again.
+   * @warning The memory allocated is proportional to the largest key. This structure is meant for densely packed keys.
+   */
+  class vmtf
+  {
+  private:
+    /**
+     * @brief Links and timestamp of a key in the queue.
+     */
+    struct link
+    {
+      unsigned prev = LOCATION_UNDEF;
+      unsigned next = LOCATION_UNDEF;
+      unsigned long stamp = 0;
+    };
+    /**
+     * @brief The links of each key. The stamp of a key not in the queue is 0.
+     */
+    std::vector<link> _links;
+    /**
+     * @brief Least recently moved key.
+     */
+    unsigned _first = LOCATION_UNDEF;
+    /**
+     * @brief Most recently moved key.
+     */
+    unsigned _last = LOCATION_UNDEF;
+    /**
+     * @brief Search position. All keys more recent than the search position are not candidates.
+     */
+    unsigned _search = LOCATION_UNDEF;
+    /**
+     * @brief Last timestamp given to a key.
+     */
+    unsigned long _stamp = 0;
+    /**
+     * @brief Number of keys in the queue.
+     */
+    unsigned _size = 0;
+
+    /**
+     * @brief Removes the key from the linked list, without changing the search position.
+     */
+    void unlink(unsigned key);
+
+    /**
+     * @brief Appends the key at the front of the linked list with a new timestamp.
+     */
+    void append(unsigned key);
+
+  public:
+    /**
+     * @brief Inserts a new key at the front of the queue, and moves the search position to it.
+     * @pre The queue does not contain the given key.
+     * @details Complexity: O(1).
+     */
+    void insert(unsigned key);
+
+    /**
+     * @brief Removes a key from the queue.
+     * @pre The queue contains the given key.
+     * @details Complexity: O(1).
+     */
+    void remove(unsigned key);
+
+    /**
+     * @brief Moves a key to the front of the queue. The search position is not updated.
+     * @pre The queue contains the given key.
+     * @details Complexity: O(1).
+     */
+    void move_to_front(unsigned key);
+
+    /**
+     * @brief Moves the search position to the key if it is more recent than the current search position.
+     * @param key The key that became a candidate.
+     * @pre The queue contains the given key.
+     * @details Complexity: O(1).
+     */
+    void update_search(unsigned key);
+
+    /**
+     * @brief Returns the key at the search position, or LOCATION_UNDEF if there is none.
+     * @details Complexity: O(1).
+     */
+    unsigned search() const { return _search; }
+
+    /**
+     * @brief Moves the search position to the next less recent key.
+     * @return The key at the new search position, or LOCATION_UNDEF if there is none.
+     * @pre The key at the search position is not a candidate.
+     * @details Complexity: O(1).
+     */
+    unsigned skip();
+
+    /**
+     * @brief Returns the timestamp of the key. A key with a higher timestamp was moved to the front more recently.
+     * @pre The queue contains the given key.
+     */
+    unsigned long stamp(unsigned key) const { return _links[key].stamp; }
+
+    /**
+     * @brief Checks if the queue contains the given key.
+     * @details Complexity: O(1).
+     */
+    bool contains(unsigned key) const { return key < _links.size() && _links[key].stamp != 0; }
+
+    /**
+     * @brief Returns the number of keys in the queue.
+     */
+    unsigned size() const { return _size; }
+  };
+} // namespace napsat::utils
@@ -21,6 +21,7 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <cstring>
 
 using namespace napsat;
@@ -228,3 +229,135 @@ TEST_CASE( "[Notification] Unit Test" )
     REQUIRE(!obs.is_watching(0, l3));
   }
 }
+
+TEST_CASE( "[Notification] Unit Test : Limited history" )
+{
+  setup();
+  SECTION( "Only the last events are recorded" ) {
+    vector<string> args{"-c", "-hist", "2"};
+    options opt(args);
+    observer obs(opt);
+    obs.notify(new new_variable(1));
+    obs.notify(new new_variable(2));
+    obs.notify(new new_variable(3));
+    REQUIRE( obs.var_value(3) == VAR_UNDEF );
+    ostringstream events;
+    obs.print_recent_events(events);
+    REQUIRE( events.str().find("New variable 1") == string::npos );
+    REQUIRE( events.str().find("New variable 2") != string::npos );
+    REQUIRE( events.str().find("New variable 3") != string::npos );
+  }
+}
+
+TEST_CASE( "[Notification] Unit Test : Incremental invariants" )
+{
+  setup();
+  vector<string> args{"-c"};
+  options opt(args);
+  observer obs(opt);
+  obs.notify(new new_variable(1));
+  obs.notify(new new_variable(2));
+  obs.notify(new new_variable(3));
+  Tlit l1 = literal(1, 1);
+  Tlit l2 = literal(2, 1);
+  Tlit l3 = literal(3, 1);
+
+  SECTION( "Both watched literals falsified" ) {
+    obs.notify(new new_clause(0, { l1, l2, l3 }, false, true));
+    obs.notify(new watch(0, l1));
+    obs.notify(new watch(0, l2));
+    REQUIRE( obs.check_invariants_incremental() );
+    obs.notify(new decision(lit_neg(l1)));
+    obs.notify(new propagation(lit_neg(l1)));
+    obs.notify(new decision(lit_neg(l2)));
+    obs.notify(new propagation(lit_neg(l2)));
+    REQUIRE( !obs.check_invariants_incremental() );
+    REQUIRE( obs.get_error_message().find("Weak watched literals") != string::npos );
+    // the changes were consumed by the previous check, but a full check still sees the violation
+    REQUIRE( obs.check_invariants_incremental() );
+    REQUIRE( !obs.check_invariants() );
+  }
+
+  SECTION( "Reason deleted below the last change" ) {
+    obs.notify(new new_clause(0, { lit_neg(l1), l2 }, false, true));
+    obs.notify(new decision(l1));
+    obs.notify(new propagation(l1));
+    obs.notify(new implication(l2, 0, 1));
+    obs.notify(new propagation(l2));
+    obs.notify(new decision(l3));
+    REQUIRE( obs.check_invariants_incremental() );
+    obs.notify(new delete_clause(0));
+    REQUIRE( !obs.check_invariants_incremental() );
+    REQUIRE( obs.get_error_message().find("is not active") != string::npos );
+  }
+}
+
+TEST_CASE( "[Notification] Unit Test : Snapshots" )
+{
+  setup();
+  vector<string> args{"-c", "-snap", "2"};
+  options opt(args);
+  observer obs(opt);
+  Tlit l1 = literal(1, 1);
+  Tlit l2 = literal(2, 1);
+  Tlit l3 = literal(3, 1);
+  obs.notify(new new_variable(1));
+  obs.notify(new new_variable(2));
+  obs.notify(new new_variable(3));
+  obs.notify(new new_clause(0, { l1, l2, l3 }, false, true));
+  obs.notify(new watch(0, l1));
+  obs.notify(new watch(0, l2));
+  // 6
+  obs.notify(new decision(l1));
+  obs.notify(new propagation(l1));
+  obs.notify(new unwatch(0, l1));
+  obs.notify(new watch(0, l3));
+  // 10
+  obs.notify(new delete_clause(0));
+  obs.notify(new new_clause(0, { l2, l3 }, false, true));
+  obs.notify(new watch(0, l2));
+  obs.notify(new watch(0, l3));
+  obs.notify(new decision(lit_neg(l2)));
+  // 15
+  REQUIRE( obs.notification_number() == 15 );
+
+  SECTION( "Seek backward and forward" ) {
+    obs.seek(6);
+    REQUIRE( obs.notification_number() == 6 );
+    REQUIRE( obs.lit_value(l1) == VAR_UNDEF );
+    REQUIRE( obs.is_watching(0, l1) );
+    REQUIRE( obs.is_watching(0, l2) );
+    REQUIRE( !obs.is_watching(0, l3) );
+
+    obs.seek(10);
+    REQUIRE( obs.lit_value(l1) == VAR_TRUE );
+    REQUIRE( !obs.is_watching(0, l1) );
+    REQUIRE( obs.is_watching(0, l2) );
+    REQUIRE( obs.is_watching(0, l3) );
+
+    obs.seek(0);
+    REQUIRE( obs.is_back_to_origin() );
+    REQUIRE( obs.var_value(1) == VAR_ERROR );
+
+    obs.seek(15);
+    REQUIRE( obs.is_real_time() );
+    REQUIRE( obs.lit_value(l1) == VAR_TRUE );
+    REQUIRE( obs.lit_value(l2) == VAR_FALSE );
+    REQUIRE( obs.get_clauses().size() == 1 );
+    REQUIRE( obs.is_watching(0, l2) );
+    REQUIRE( obs.is_watching(0, l3) );
+    REQUIRE( obs.check_invariants() );
+  }
+
+  SECTION( "Step back after a seek" ) {
+    obs.seek(8);
+    obs.back();
+    REQUIRE( obs.notification_number() == 7 );
+    REQUIRE( obs.lit_value(l1) == VAR_TRUE );
+    REQUIRE( !obs.var_propagated(1) );
+    obs.back();
+    REQUIRE( obs.lit_value(l1) == VAR_UNDEF );
+    obs.seek(100);
+    REQUIRE( obs.is_real_time() );
+  }
+}
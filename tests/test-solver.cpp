@@ -13,17 +13,19 @@
 #include "SAT-types.hpp"
 #include "SAT-config.hpp"
 #include "SAT-options.hpp"
+#include "../src/solver/NapSAT.hpp"
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <vector>
 
 using namespace std;
 using namespace napsat;
 
-static NapSAT* setup(const char* filename) {
+static const char* find_file(const char* filename) {
   // check if the file exists.
   // if it does not exist, try to remove the first 3 characters of the filename
   // and try again.
@@ -32,10 +34,18 @@ static NapSAT* setup(const char* filename) {
   if (!file.good()) {
     filename += 3;
   }
-  vector<string> args;
+  return filename;
+}
+
+static options setup_options(vector<string> args) {
   args.push_back("--suppress-info");
   args = env::extract_environment_variables(args);
-  options options(args);
+  return options(args);
+}
+
+static NapSAT* setup(const char* filename, vector<string> args = vector<string>()) {
+  filename = find_file(filename);
+  options options = setup_options(args);
   NapSAT* solver = create_solver(0, 0, options);
   REQUIRE(solver != nullptr);
 
@@ -53,6 +63,17 @@ TEST_CASE( "[SAT-Integration] Integration Test : Satisfiable" ) {
     REQUIRE(solve(solver) == SAT);
     teardown(solver);
   }
+  SECTION ("Format") {
+    NapSAT* solver = setup("../tests/cnf/sat-format.cnf");
+    REQUIRE(solve(solver) == SAT);
+    teardown(solver);
+  }
+  SECTION ("Dishonest header") {
+    NapSAT* solver = setup("../tests/cnf/sat-header.cnf");
+    REQUIRE(solve(solver) == SAT);
+    REQUIRE(get_memory_usage(solver).total < (1 << 20));
+    teardown(solver);
+  }
 
 }
 
@@ -100,4 +121,1071 @@ TEST_CASE( "[SAT-Integration] Integration Test : Decompress" ) {
     REQUIRE(solve(solver) == SAT);
     teardown(solver);
   }
+  SECTION ("Decompress several chunks") {
+    NapSAT* solver = setup("../tests/cnf/test-compress-02.cnf.xz");
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Statistics" ) {
+  SECTION ("Counters") {
+    NapSAT* solver = setup("../tests/cnf/test-compress-02.cnf.xz");
+    REQUIRE(solve(solver) == UNSAT);
+    statistics stats = get_statistics(solver);
+    REQUIRE(stats.conflicts > 0);
+    REQUIRE(stats.propagations > 0);
+    REQUIRE(stats.blocker_hits <= stats.watch_visits);
+    REQUIRE(stats.replacement_searches <= stats.watch_visits);
+    unsigned long sizes = 0;
+    unsigned long lbds = 0;
+    for (unsigned i = 0; i < STAT_HISTOGRAM_SIZE; i++) {
+      sizes += stats.size_histogram[i];
+      lbds += stats.lbd_histogram[i];
+    }
+    REQUIRE(sizes == stats.learned_clauses);
+    REQUIRE(lbds == stats.learned_clauses);
+    REQUIRE(stats.lbd_histogram[0] == 0);
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Clause tiers" ) {
+  SECTION ("Only local clauses") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"--core-lbd", "0", "--tier2-lbd", "0"});
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+  SECTION ("Only core clauses") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"--core-lbd", "1000", "--tier2-lbd", "1000"});
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+  SECTION ("Aggressive reduction") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"--local-reduction-fraction", "1"});
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Clause minimization" ) {
+  SECTION ("Minimized literals") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf");
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).minimized_literals > 0);
+    teardown(solver);
+  }
+  SECTION ("No minimization") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-rmin", "off", "-bmin", "off"});
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).minimized_literals == 0);
+    teardown(solver);
+  }
+  SECTION ("Proof") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-bp"});
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(check_proof(solver));
+    teardown(solver);
+  }
+  SECTION ("Proof with chronological backtracking") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-bp", "-lscb"});
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(check_proof(solver));
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Proof checking" ) {
+  SECTION ("Parallel proof checking") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-bp", "-cpt", "4"});
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(check_proof(solver));
+    // the clauses are unmarked after the check
+    REQUIRE(check_proof(solver));
+    teardown(solver);
+  }
+  // x1 | x2, -x1 | x2, -x2 and -x3 | x2, where x3 only occurs negated
+  const Tlit x1 = literal(1, true), x2 = literal(2, true), x3 = literal(3, true);
+  vector<vector<Tlit>> input = {{x1, x2}, {lit_neg(x1), x2}, {lit_neg(x2)}, {lit_neg(x3), x2}};
+  SECTION ("Valid chains") {
+    proof::resolution_proof proof;
+    for (unsigned i = 0; i < input.size(); i++)
+      proof.input_clause(i, input[i].data(), input[i].size());
+    proof.start_resolution_chain();
+    proof.link_resolution(LIT_UNDEF, 0);
+    proof.link_resolution(x1, 1);
+    proof.finalize_resolution(4, &x2, 1);
+    proof.start_resolution_chain();
+    proof.link_resolution(LIT_UNDEF, 4);
+    proof.link_resolution(x2, 2);
+    proof.finalize_resolution(5, nullptr, 0);
+    REQUIRE(proof.check_proof());
+  }
+  SECTION ("Invalid pivot") {
+    proof::resolution_proof proof(false);
+    for (unsigned i = 0; i < input.size(); i++)
+      proof.input_clause(i, input[i].data(), input[i].size());
+    // the negation of the pivot x3 is larger than every literal of the proof
+    proof.start_resolution_chain();
+    proof.link_resolution(LIT_UNDEF, 0);
+    proof.link_resolution(lit_neg(x3), 3);
+    proof.finalize_resolution(4, &x2, 1);
+    proof.start_resolution_chain();
+    proof.link_resolution(LIT_UNDEF, 4);
+    proof.link_resolution(x2, 2);
+    proof.finalize_resolution(5, nullptr, 0);
+    REQUIRE(!proof.check_proof());
+  }
+  SECTION ("Invalid resolvent") {
+    proof::resolution_proof proof(false);
+    for (unsigned i = 0; i < input.size(); i++)
+      proof.input_clause(i, input[i].data(), input[i].size());
+    // the chain derives x2, not the empty clause
+    proof.start_resolution_chain();
+    proof.link_resolution(LIT_UNDEF, 0);
+    proof.link_resolution(x1, 1);
+    proof.finalize_resolution(4, nullptr, 0);
+    REQUIRE(!proof.check_proof());
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Restart policies" ) {
+  vector<vector<string>> configurations = {
+    {"-restart", "luby"},
+    {"-restart", "geometric"},
+    {"-restart", "glucose"},
+    {"-restart", "geometric", "-prst"},
+    {"-restart", "luby", "-prst", "-lscb"}
+  };
+  for (vector<string>& configuration : configurations) {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", configuration);
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).restarts > 0);
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Decision heuristics" ) {
+  vector<vector<string>> configurations = {
+    {"-dh", "vmtf"},
+    {"-dh", "vmtf", "-wcb"},
+    {"-dh", "vmtf", "-rscb"},
+    {"-dh", "vmtf", "-lscb"},
+    {"-dh", "vmtf", "-restart", "luby", "-prst"},
+    {"-dh", "vmtf", "-bp"}
+  };
+  for (vector<string>& configuration : configurations) {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", configuration);
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+    solver = setup("../tests/cnf/sat-03.cnf", configuration);
+    REQUIRE(solve(solver) == SAT);
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Adaptive backtracking" ) {
+  vector<vector<string>> configurations = {
+    {"-acb", "--adaptive-backtracking-levels", "2", "--adaptive-backtracking-margin", "1"},
+    {"-acb", "--adaptive-backtracking-levels", "2", "--adaptive-backtracking-margin", "1", "-rscb"},
+    {"-acb", "--adaptive-backtracking-levels", "2", "--adaptive-backtracking-margin", "1", "-lscb"},
+    {"-acb", "--adaptive-backtracking-levels", "2", "--adaptive-backtracking-margin", "1", "-bp"}
+  };
+  for (vector<string>& configuration : configurations) {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", configuration);
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).chronological_backtracks > 0);
+    REQUIRE(get_statistics(solver).chronological_backtracks < get_statistics(solver).conflicts);
+    if (find(configuration.begin(), configuration.end(), "-bp") != configuration.end())
+      REQUIRE(check_proof(solver));
+    teardown(solver);
+    solver = setup("../tests/cnf/sat-03.cnf", configuration);
+    REQUIRE(solve(solver) == SAT);
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Rephasing" ) {
+  vector<vector<string>> configurations = {
+    {"-rephase", "--rephase-interval", "1", "-restart", "luby"},
+    {"-rephase", "--rephase-interval", "1", "-restart", "luby", "-lscb"},
+    {"-rephase", "--rephase-interval", "1", "-restart", "luby", "-wcb", "-seed", "3"},
+    {"-rephase", "--rephase-interval", "1", "-restart", "geometric", "-prst", "-rscb"}
+  };
+  for (vector<string>& configuration : configurations) {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", configuration);
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).rephases > 0);
+    teardown(solver);
+    solver = setup("../tests/cnf/sat-03.cnf", configuration);
+    REQUIRE(solve(solver) == SAT);
+    teardown(solver);
+  }
+}
+
+/**
+ * @brief Literal of the variable "pigeon i is in hole j" in the pigeonhole instances.
+ */
+static Tlit pigeon(unsigned i, unsigned j, bool positive = true) {
+  return literal(7 * (i - 1) + j, positive);
+}
+
+static bool assigned(NapSAT* solver, Tlit lit) {
+  const vector<Tlit>& trail = get_partial_assignment(solver);
+  return find(trail.begin(), trail.end(), lit) != trail.end();
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Assumptions" ) {
+  vector<vector<string>> configurations = {{}, {"-wcb"}, {"-rscb"}, {"-lscb"}};
+  for (vector<string>& configuration : configurations) {
+    SECTION ("Successive calls " + (configuration.empty() ? string("-ncb") : configuration[0])) {
+      NapSAT* solver = setup("../tests/cnf/sat-03.cnf", configuration);
+      REQUIRE(solve(solver) == SAT);
+
+      // no pigeon in the last hole
+      vector<Tlit> assumptions;
+      for (unsigned i = 1; i <= 7; i++)
+        assumptions.push_back(pigeon(i, 7, false));
+      REQUIRE(solve(solver, assumptions.data(), assumptions.size()) == UNSAT);
+      const vector<Tlit>& failed = get_failed_assumptions(solver);
+      REQUIRE(!failed.empty());
+      for (Tlit lit : failed)
+        REQUIRE(find(assumptions.begin(), assumptions.end(), lit) != assumptions.end());
+
+      Tlit lit = pigeon(1, 7);
+      REQUIRE(solve(solver, &lit, 1) == SAT);
+      REQUIRE(assigned(solver, lit));
+      REQUIRE(get_failed_assumptions(solver).empty());
+
+      // the irrelevant assumption is not in the failed assumptions
+      assumptions = {pigeon(3, 3), pigeon(1, 1), pigeon(2, 1)};
+      REQUIRE(solve(solver, assumptions.data(), assumptions.size()) == UNSAT);
+      REQUIRE(get_failed_assumptions(solver).size() == 2);
+      REQUIRE(find(failed.begin(), failed.end(), pigeon(3, 3)) == failed.end());
+
+      REQUIRE(solve(solver) == SAT);
+      teardown(solver);
+    }
+  }
+  SECTION ("Clauses added between calls") {
+    NapSAT* solver = setup("../tests/cnf/sat-03.cnf");
+    Tlit lit = pigeon(1, 1);
+    REQUIRE(solve(solver, &lit, 1) == SAT);
+    Tlit clause[] = {pigeon(1, 1, false)};
+    add_clause(solver, clause, 1);
+    REQUIRE(solve(solver, &lit, 1) == UNSAT);
+    REQUIRE(get_failed_assumptions(solver) == vector<Tlit>{lit});
+    REQUIRE(solve(solver) == SAT);
+    REQUIRE(assigned(solver, pigeon(1, 1, false)));
+    teardown(solver);
+  }
+  SECTION ("Unsatisfiable clause set") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf");
+    Tlit lit = pigeon(1, 1);
+    REQUIRE(solve(solver, &lit, 1) == UNSAT);
+    REQUIRE(get_failed_assumptions(solver).size() <= 1);
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_failed_assumptions(solver).empty());
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Cube and conquer" ) {
+  vector<vector<string>> configurations = {{}, {"-wcb"}, {"-rscb"}, {"-lscb"}};
+  for (vector<string>& configuration : configurations) {
+    SECTION ("Satisfiable " + (configuration.empty() ? string("-ncb") : configuration[0])) {
+      NapSAT* solver = setup("../tests/cnf/sat-03.cnf", configuration);
+      REQUIRE(cube(solver, 8) == UNDEF);
+      vector<vector<Tlit>> cubes = get_cubes(solver);
+      REQUIRE(!cubes.empty());
+      REQUIRE(cubes.size() <= 8);
+      REQUIRE(write_icnf(solver, "test-cubes.icnf"));
+      // the clause set can still be solved after the split
+      REQUIRE(solve(solver) == SAT);
+      teardown(solver);
+
+      solver = setup("test-cubes.icnf", configuration);
+      REQUIRE(get_cubes(solver) == cubes);
+      unsigned satisfiable = 0;
+      for (vector<Tlit>& cube : cubes)
+        satisfiable += solve(solver, cube.data(), cube.size()) == SAT;
+      REQUIRE(satisfiable > 0);
+      teardown(solver);
+    }
+    SECTION ("Unsatisfiable " + (configuration.empty() ? string("-ncb") : configuration[0])) {
+      NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", configuration);
+      status result = cube(solver, 16);
+      for (vector<Tlit> cube : get_cubes(solver))
+        REQUIRE(solve(solver, cube.data(), cube.size()) == UNSAT);
+      REQUIRE((result == UNDEF || result == UNSAT));
+      REQUIRE(solve(solver) == UNSAT);
+      teardown(solver);
+    }
+  }
+  SECTION ("Refuted by the lookahead") {
+    // both values of x1 are refuted by propagation, but not at level 0
+    vector<vector<Tlit>> clauses = {
+      {literal(1, true), literal(2, true)},
+      {literal(1, true), literal(2, false)},
+      {literal(1, false), literal(3, true)},
+      {literal(1, false), literal(3, false)}
+    };
+    for (vector<string> configuration : vector<vector<string>>{{}, {"-bp"}}) {
+      options options = setup_options(configuration);
+      NapSAT* solver = create_solver(3, 4, options);
+      for (vector<Tlit>& clause : clauses)
+        add_clause(solver, clause.data(), clause.size());
+      REQUIRE(cube(solver, 4) == UNSAT);
+      REQUIRE(get_cubes(solver).empty());
+      if (configuration.empty())
+        REQUIRE(get_status(solver) == UNSAT);
+      else {
+        // the proof of the refutation is built by the search
+        REQUIRE(get_status(solver) == UNDEF);
+        REQUIRE(solve(solver) == UNSAT);
+        REQUIRE(check_proof(solver));
+      }
+      teardown(solver);
+    }
+  }
+  remove("test-cubes.icnf");
+}
+
+static string read_file(const char* filename) {
+  ifstream file(filename, ios::binary);
+  return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Saved state" ) {
+  vector<vector<string>> configurations = {{}, {"-wcb"}, {"-rscb"}, {"-lscb"}, {"-dh", "vmtf"}};
+  for (vector<string>& configuration : configurations) {
+    SECTION ("Resumed search " + (configuration.empty() ? string("-ncb") : configuration.back())) {
+      NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", configuration);
+      set_conflict_budget(solver, 300);
+      REQUIRE(solve(solver) == UNDEF);
+      REQUIRE(save_state(solver, "test-state.bin"));
+      teardown(solver);
+
+      options options = setup_options(configuration);
+      solver = create_solver(0, 0, options);
+      REQUIRE(load_state(solver, "test-state.bin"));
+      REQUIRE(get_statistics(solver).conflicts == 300);
+      // the clauses, the variables and the schedulers are restored as they were saved
+      REQUIRE(save_state(solver, "test-state-copy.bin"));
+      REQUIRE(read_file("test-state.bin") == read_file("test-state-copy.bin"));
+      REQUIRE(solve(solver) == UNSAT);
+      teardown(solver);
+    }
+  }
+  SECTION ("Satisfiable") {
+    NapSAT* solver = setup("../tests/cnf/sat-03.cnf");
+    REQUIRE(solve(solver) == SAT);
+    REQUIRE(save_state(solver, "test-state.bin"));
+    teardown(solver);
+    options options = setup_options({});
+    solver = create_solver(0, 0, options);
+    REQUIRE(load_state(solver, "test-state.bin"));
+    REQUIRE(solve(solver) == SAT);
+    teardown(solver);
+  }
+  SECTION ("Invalid state") {
+    // the solver already has clauses
+    NapSAT* solver = setup("../tests/cnf/sat-03.cnf");
+    REQUIRE(save_state(solver, "test-state.bin"));
+    REQUIRE(!load_state(solver, "test-state.bin"));
+    teardown(solver);
+    options options = setup_options({});
+    solver = create_solver(0, 0, options);
+    REQUIRE(!load_state(solver, find_file("../tests/cnf/sat-03.cnf")));
+    REQUIRE(!load_state(solver, "missing-state.bin"));
+    // a truncated state is rejected before the solver is modified
+    string state = read_file("test-state.bin");
+    ofstream("test-state-copy.bin", ios::binary).write(state.data(), state.size() / 2);
+    REQUIRE(!load_state(solver, "test-state-copy.bin"));
+    REQUIRE(load_state(solver, "test-state.bin"));
+    REQUIRE(solve(solver) == SAT);
+    teardown(solver);
+  }
+  SECTION ("Proofs") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf");
+    set_conflict_budget(solver, 300);
+    REQUIRE(solve(solver) == UNDEF);
+    REQUIRE(save_state(solver, "test-state.bin"));
+    teardown(solver);
+    // the learned clauses of the state are not justified in the proof
+    vector<vector<string>> proof_configurations = {{"-bp"}, {"-drat", "test-proof.drat"}};
+    for (vector<string>& configuration : proof_configurations) {
+      options options = setup_options(configuration);
+      solver = create_solver(0, 0, options);
+      REQUIRE(!load_state(solver, "test-state.bin"));
+      teardown(solver);
+    }
+    remove("test-proof.drat");
+  }
+  remove("test-state.bin");
+  remove("test-state-copy.bin");
+}
+
+/**
+ * @brief Adds the pigeonhole problem with the given number of pigeons and 7 holes, with an at-most-one
+ * constraint for each hole instead of the clauses.
+ */
+static void add_pigeonhole(NapSAT* solver, unsigned pigeons) {
+  for (unsigned i = 1; i <= pigeons; i++) {
+    vector<Tlit> holes;
+    for (unsigned j = 1; j <= 7; j++)
+      holes.push_back(pigeon(i, j));
+    add_clause(solver, holes.data(), holes.size());
+  }
+  for (unsigned j = 1; j <= 7; j++) {
+    vector<Tlit> hole;
+    for (unsigned i = 1; i <= pigeons; i++)
+      hole.push_back(pigeon(i, j));
+    REQUIRE(add_at_most_one(solver, hole.data(), hole.size()));
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Cardinality constraints" ) {
+  vector<vector<string>> configurations = {{}, {"-wcb"}, {"-rscb"}, {"-lscb"}};
+  for (vector<string>& configuration : configurations) {
+    SECTION ("Pigeonhole " + (configuration.empty() ? string("-ncb") : configuration[0])) {
+      options options = setup_options(configuration);
+      NapSAT* solver = create_solver(0, 0, options);
+      add_pigeonhole(solver, 8);
+      REQUIRE(solve(solver) == UNSAT);
+      REQUIRE(get_statistics(solver).theory_propagations > 0);
+      REQUIRE(get_statistics(solver).theory_clauses > 0);
+      teardown(solver);
+    }
+    SECTION ("Satisfiable " + (configuration.empty() ? string("-ncb") : configuration[0])) {
+      options options = setup_options(configuration);
+      NapSAT* solver = create_solver(0, 0, options);
+      add_pigeonhole(solver, 7);
+      REQUIRE(solve(solver) == SAT);
+      for (unsigned j = 1; j <= 7; j++) {
+        unsigned count = 0;
+        for (unsigned i = 1; i <= 7; i++)
+          count += assigned(solver, pigeon(i, j));
+        REQUIRE(count == 1);
+      }
+      // the constraints also hold under assumptions
+      vector<Tlit> assumptions = {pigeon(1, 1), pigeon(2, 2)};
+      REQUIRE(solve(solver, assumptions.data(), assumptions.size()) == SAT);
+      for (unsigned i = 2; i <= 7; i++)
+        REQUIRE(assigned(solver, pigeon(i, 1, false)));
+      assumptions.push_back(pigeon(3, 1));
+      REQUIRE(solve(solver, assumptions.data(), assumptions.size()) == UNSAT);
+      const vector<Tlit>& failed = get_failed_assumptions(solver);
+      REQUIRE(find(failed.begin(), failed.end(), pigeon(2, 2)) == failed.end());
+      teardown(solver);
+    }
+  }
+  SECTION ("Bound") {
+    options options = setup_options({});
+    NapSAT* solver = create_solver(0, 0, options);
+    vector<Tlit> lits;
+    for (unsigned var = 1; var <= 6; var++)
+      lits.push_back(literal(var, 1));
+    REQUIRE(add_cardinality(solver, lits.data(), lits.size(), 3));
+    vector<Tlit> assumptions = {lits[0], lits[2], lits[4]};
+    REQUIRE(solve(solver, assumptions.data(), assumptions.size()) == SAT);
+    REQUIRE(assigned(solver, literal(2, 0)));
+    REQUIRE(assigned(solver, literal(4, 0)));
+    REQUIRE(assigned(solver, literal(6, 0)));
+    assumptions.push_back(lits[5]);
+    REQUIRE(solve(solver, assumptions.data(), assumptions.size()) == UNSAT);
+    REQUIRE(get_failed_assumptions(solver).size() == 4);
+    // a literal with its negation counts for one true literal
+    Tlit pair[] = {literal(1, 1), literal(1, 0), literal(2, 1), literal(3, 1)};
+    REQUIRE(add_cardinality(solver, pair, 4, 1));
+    REQUIRE(solve(solver) == SAT);
+    REQUIRE(assigned(solver, literal(2, 0)));
+    REQUIRE(assigned(solver, literal(3, 0)));
+    REQUIRE(add_cardinality(solver, pair, 2, 0));
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+  SECTION ("Proof") {
+    options options = setup_options({"-drat", "test-proof.drat"});
+    NapSAT* solver = create_solver(0, 0, options);
+    Tlit lits[] = {literal(1, 1), literal(2, 1), literal(3, 1)};
+    REQUIRE(!add_at_most_one(solver, lits, 3));
+    teardown(solver);
+    remove("test-proof.drat");
+  }
+}
+
+/**
+ * @brief Adds the pigeonhole problem with 8 pigeons and 7 holes, with the quadratic clausal encoding of the
+ * at-most-one constraints.
+ */
+static void add_clausal_pigeonhole(NapSAT* solver) {
+  for (unsigned i = 1; i <= 8; i++) {
+    vector<Tlit> holes;
+    for (unsigned j = 1; j <= 7; j++)
+      holes.push_back(pigeon(i, j));
+    add_clause(solver, holes.data(), holes.size());
+  }
+  for (unsigned j = 1; j <= 7; j++)
+    for (unsigned i = 1; i <= 8; i++)
+      for (unsigned k = i + 1; k <= 8; k++) {
+        Tlit lits[2] = {pigeon(i, j, false), pigeon(k, j, false)};
+        add_clause(solver, lits, 2);
+      }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Memory budget" ) {
+  SECTION ("Accounting") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-bp"});
+    REQUIRE(solve(solver) == UNSAT);
+    memory_usage memory = get_memory_usage(solver);
+    REQUIRE(memory.clauses > 0);
+    REQUIRE(memory.watches > 0);
+    REQUIRE(memory.binaries > 0);
+    REQUIRE(memory.variables > 0);
+    REQUIRE(memory.propagators == 0);
+    REQUIRE(memory.proof > 0);
+    REQUIRE(memory.total == memory.clauses + memory.watches + memory.binaries + memory.variables
+                            + memory.propagators + memory.proof + memory.observer);
+    teardown(solver);
+  }
+  SECTION ("Propagators") {
+    options options = setup_options({});
+    NapSAT* solver = create_solver(0, 0, options);
+    add_pigeonhole(solver, 8);
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_memory_usage(solver).propagators > 0);
+    teardown(solver);
+  }
+  vector<vector<string>> configurations = {{}, {"-wcb"}, {"-rscb"}, {"-lscb"}};
+  for (vector<string>& configuration : configurations) {
+    SECTION ("Reductions " + (configuration.empty() ? string("-ncb") : configuration[0])) {
+      options unlimited_options = setup_options(configuration);
+      NapSAT* unlimited = create_solver(0, 0, unlimited_options);
+      add_clausal_pigeonhole(unlimited);
+      REQUIRE(solve(unlimited) == UNSAT);
+      REQUIRE(get_statistics(unlimited).memory_reductions == 0);
+
+      // the budget is exceeded from the start, every check reduces the clause set
+      configuration.insert(configuration.end(), {"-mem", "16"});
+      options options = setup_options(configuration);
+      NapSAT* solver = create_solver(0, 0, options);
+      add_clausal_pigeonhole(solver);
+      REQUIRE(solve(solver) == UNSAT);
+      const statistics stats = get_statistics(solver);
+      REQUIRE(stats.memory_reductions > 0);
+      REQUIRE(stats.memory_reductions <= stats.conflicts / 1000);
+      REQUIRE(get_memory_usage(solver).clauses < get_memory_usage(unlimited).clauses);
+      teardown(unlimited);
+      teardown(solver);
+    }
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Long clauses" ) {
+  vector<vector<string>> configurations = {{}, {"-wcb"}, {"-rscb"}, {"-lscb"}};
+  for (vector<string>& configuration : configurations) {
+    SECTION ("Replacement search " + (configuration.empty() ? string("-ncb") : configuration[0])) {
+      NapSAT* solver = setup("../tests/cnf/test-long-clause.cnf", configuration);
+      REQUIRE(solve(solver) == SAT);
+      REQUIRE(assigned(solver, literal(40, true)));
+      for (unsigned i = 1; i < 40; i++)
+        REQUIRE(assigned(solver, literal(i, false)));
+      teardown(solver);
+    }
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Oversized clauses" ) {
+  options options = setup_options({});
+  NapSAT* solver = create_solver(2, 2, options);
+  // the literals are repeated, such that the solver does not allocate 2^25 variables
+  vector<Tlit> lits(1 << 25, literal(1, true));
+  REQUIRE(add_clause(solver, lits.data(), lits.size()) == CLAUSE_UNDEF);
+  vector<unsigned> offsets = {0, (unsigned) lits.size(), (unsigned) lits.size() + 2};
+  lits.push_back(literal(1, true));
+  lits.push_back(literal(2, true));
+  add_clauses(solver, lits.data(), offsets.data(), 2);
+  // only the clause (x1 x2) of the batch is added, the oversized one would have implied x1
+  Tlit unit = literal(1, false);
+  add_clause(solver, &unit, 1);
+  REQUIRE(solve(solver) == SAT);
+  REQUIRE(assigned(solver, literal(2, true)));
+  teardown(solver);
+}
+
+/**
+ * @brief Adds the implications x1 -> x2 -> ... -> xn, whose middle variables can be eliminated.
+ */
+static vector<vector<Tlit>> add_implication_chain(NapSAT* solver, unsigned n) {
+  vector<vector<Tlit>> clauses;
+  for (unsigned i = 1; i < n; i++)
+    clauses.push_back({literal(i, false), literal(i + 1, true)});
+  clauses.push_back({literal(1, true), literal(n, true)});
+  for (vector<Tlit>& clause : clauses)
+    add_clause(solver, clause.data(), clause.size());
+  return clauses;
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Preprocessing" ) {
+  SECTION ("Model reconstruction") {
+    options options = setup_options({"-pre"});
+    NapSAT* solver = create_solver(0, 0, options);
+    vector<vector<Tlit>> clauses = add_implication_chain(solver, 10);
+    REQUIRE(solve(solver) == SAT);
+    REQUIRE(get_statistics(solver).eliminated_variables > 0);
+    REQUIRE(get_partial_assignment(solver).size() == 10);
+    for (vector<Tlit>& clause : clauses)
+      REQUIRE(any_of(clause.begin(), clause.end(), [&](Tlit lit) { return assigned(solver, lit); }));
+    teardown(solver);
+  }
+  SECTION ("Restored variables") {
+    options options = setup_options({"-pre", "-bp"});
+    NapSAT* solver = create_solver(0, 0, options);
+    add_implication_chain(solver, 10);
+    REQUIRE(solve(solver) == SAT);
+    REQUIRE(get_statistics(solver).eliminated_variables > 0);
+    Tlit lit = literal(1, true);
+    Tlit clause[] = {literal(5, false)};
+    add_clause(solver, clause, 1);
+    REQUIRE(solve(solver, &lit, 1) == UNSAT);
+    REQUIRE(get_failed_assumptions(solver) == vector<Tlit>{lit});
+    REQUIRE(solve(solver) == SAT);
+    REQUIRE(assigned(solver, literal(1, false)));
+    REQUIRE(assigned(solver, literal(10, true)));
+    teardown(solver);
+  }
+  SECTION ("Repeated variables") {
+    options options = setup_options({"-pre"});
+    NapSAT* solver = create_solver(0, 0, options);
+    // a repeated literal and a tautology, as they may appear in DIMACS files
+    vector<vector<Tlit>> clauses = {
+      {literal(2, false), literal(2, false), literal(5, false)},
+      {literal(1, false), literal(5, true), literal(1, true)}
+    };
+    for (vector<Tlit>& clause : clauses)
+      add_clause(solver, clause.data(), clause.size());
+    REQUIRE(solve(solver) == SAT);
+    for (vector<Tlit>& clause : clauses)
+      REQUIRE(any_of(clause.begin(), clause.end(), [&](Tlit lit) { return assigned(solver, lit); }));
+    teardown(solver);
+  }
+  SECTION ("Proof") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-pre", "-bp"});
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).eliminated_variables > 0);
+    REQUIRE(check_proof(solver));
+    teardown(solver);
+  }
+  SECTION ("No preprocessing") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf");
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).eliminated_variables == 0);
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Vivification" ) {
+  SECTION ("Vivified clauses") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf");
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).vivified_clauses > 0);
+    REQUIRE(get_statistics(solver).vivified_literals >= get_statistics(solver).vivified_clauses);
+    teardown(solver);
+  }
+  SECTION ("No vivification") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-viv", "off"});
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).vivified_clauses == 0);
+    REQUIRE(get_statistics(solver).vivification_deletions == 0);
+    teardown(solver);
+  }
+  SECTION ("Proof") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-bp"});
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(check_proof(solver));
+    teardown(solver);
+  }
+  SECTION ("Proof with chronological backtracking") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-bp", "-lscb"});
+    REQUIRE(solve(solver) == UNSAT);
+    REQUIRE(check_proof(solver));
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Portfolio" ) {
+  SECTION ("Configurations") {
+    vector<options> configurations = portfolio_configurations(setup_options({"-seed", "5"}), 8);
+    REQUIRE(configurations.size() == 8);
+    REQUIRE(configurations[0].seed == 5);
+    REQUIRE(!configurations[0].chronological_backtracking);
+    REQUIRE(configurations[1].weak_chronological_backtracking);
+    REQUIRE(configurations[2].restoring_strong_chronological_backtracking);
+    REQUIRE(configurations[3].lazy_strong_chronological_backtracking);
+    for (unsigned i = 0; i < configurations.size(); i++)
+      for (unsigned j = 0; j < i; j++)
+        REQUIRE(describe_configuration(configurations[i]) != describe_configuration(configurations[j]));
+  }
+  SECTION ("Unsatisfiable") {
+    vector<options> configurations = portfolio_configurations(setup_options({}), 4);
+    unsigned winner;
+    NapSAT* solver = solve_portfolio(find_file("../tests/cnf/unsat-07.cnf"), configurations, winner);
+    REQUIRE(solver != nullptr);
+    REQUIRE(winner < 4);
+    REQUIRE(get_status(solver) == UNSAT);
+    teardown(solver);
+  }
+  SECTION ("Satisfiable") {
+    vector<options> configurations = portfolio_configurations(setup_options({}), 4);
+    unsigned winner;
+    NapSAT* solver = solve_portfolio(find_file("../tests/cnf/sat-03.cnf"), configurations, winner);
+    REQUIRE(solver != nullptr);
+    REQUIRE(get_status(solver) == SAT);
+    teardown(solver);
+  }
+  SECTION ("Clause sharing") {
+    vector<options> configurations = portfolio_configurations(setup_options({}), 4);
+    unsigned winner;
+    NapSAT* solver = solve_portfolio(find_file("../tests/cnf/unsat-07.cnf"), configurations, winner);
+    REQUIRE(solver != nullptr);
+    REQUIRE(get_status(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).exported_clauses > 0);
+    teardown(solver);
+
+    configurations = portfolio_configurations(setup_options({"-share", "off"}), 4);
+    solver = solve_portfolio(find_file("../tests/cnf/unsat-07.cnf"), configurations, winner);
+    REQUIRE(solver != nullptr);
+    REQUIRE(get_status(solver) == UNSAT);
+    REQUIRE(get_statistics(solver).exported_clauses == 0);
+    REQUIRE(get_statistics(solver).imported_clauses == 0);
+    teardown(solver);
+  }
+  SECTION ("Imported clauses") {
+    options options = setup_options({});
+    NapSAT* solver = create_solver(4, 4, options);
+    Tlit unit = literal(1, true);
+    add_clause(solver, &unit, 1);
+    utils::clause_exchange exchange(2, 16);
+    solver->set_clause_exchange(&exchange, 0);
+    vector<vector<Tlit>> clauses = {
+      {literal(1, true), literal(2, true)},
+      {literal(2, true), literal(3, true)},
+      {literal(3, true), literal(2, true)},
+      {literal(1, false), literal(2, false), literal(4, true)}
+    };
+    for (vector<Tlit>& clause : clauses)
+      exchange.export_clause(1, clause.data(), clause.size(), 2);
+    REQUIRE(solve(solver) == SAT);
+    // the first clause is satisfied at level 0, and the third one is a duplicate of the second one
+    REQUIRE(get_statistics(solver).imported_clauses == 2);
+    solver->set_clause_exchange(nullptr, 0);
+    teardown(solver);
+
+    // the clauses left unread by a bounded import are read by the next one
+    for (vector<Tlit>& clause : clauses)
+      exchange.export_clause(0, clause.data(), clause.size(), 2);
+    unsigned consumed = 0;
+    auto consume = [&consumed](const Tlit*, unsigned, unsigned) { consumed++; };
+    REQUIRE(exchange.import_clauses(1, 3, consume) == 3);
+    REQUIRE(exchange.import_clauses(1, 3, consume) == 1);
+    REQUIRE(exchange.import_clauses(1, 3, consume) == 0);
+    REQUIRE(consumed == 4);
+  }
+  SECTION ("Missing file") {
+    vector<options> configurations = portfolio_configurations(setup_options({}), 2);
+    unsigned winner;
+    REQUIRE(solve_portfolio("missing.cnf", configurations, winner) == nullptr);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Termination flag" ) {
+  NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-seed", "1"});
+  atomic<bool> terminate(true);
+  set_termination_flag(solver, &terminate);
+  REQUIRE(solve(solver) == UNDEF);
+  terminate = false;
+  REQUIRE(solve(solver) == UNSAT);
+  teardown(solver);
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Bulk clause loading" ) {
+  SECTION ("Pigeonhole") {
+    // 7 pigeons in 6 holes, the variable 6 * (i - 1) + j is true if pigeon i is in hole j
+    vector<Tlit> lits;
+    vector<unsigned> offsets = {0};
+    for (unsigned i = 1; i <= 7; i++) {
+      for (unsigned j = 1; j <= 6; j++)
+        lits.push_back(literal(6 * (i - 1) + j, true));
+      offsets.push_back(lits.size());
+    }
+    for (unsigned j = 1; j <= 6; j++) {
+      for (unsigned i = 1; i <= 7; i++) {
+        for (unsigned k = i + 1; k <= 7; k++) {
+          lits.push_back(literal(6 * (i - 1) + j, false));
+          lits.push_back(literal(6 * (k - 1) + j, false));
+          offsets.push_back(lits.size());
+        }
+      }
+    }
+    vector<vector<string>> configurations = {{}, {"-lscb"}, {"-dh", "vmtf"}, {"-bp"}};
+    for (vector<string>& configuration : configurations) {
+      options options = setup_options(configuration);
+      NapSAT* solver = create_solver(0, 0, options);
+      add_clauses(solver, lits.data(), offsets.data(), offsets.size() - 1);
+      REQUIRE(solve(solver) == UNSAT);
+      if (options.build_proof)
+        REQUIRE(check_proof(solver));
+      teardown(solver);
+    }
+  }
+  SECTION ("Units and duplicate literals") {
+    vector<Tlit> lits = {
+      literal(1, true), literal(2, true), literal(3, true),
+      literal(1, false),
+      literal(2, true), literal(2, true), literal(3, false),
+      literal(2, false), literal(3, true), literal(4, true)
+    };
+    vector<unsigned> offsets = {0, 3, 4, 7, 10};
+    options options = setup_options({});
+    NapSAT* solver = create_solver(0, 0, options);
+    add_clauses(solver, lits.data(), offsets.data(), offsets.size() - 1);
+    REQUIRE(solve(solver) == SAT);
+    REQUIRE(assigned(solver, literal(1, false)));
+    REQUIRE((assigned(solver, literal(2, true)) || assigned(solver, literal(3, true))));
+    // a second batch is added to a solver that already has clauses
+    vector<Tlit> more = {literal(2, false), literal(3, false), literal(4, false)};
+    offsets = {0, 1, 2, 3};
+    add_clauses(solver, more.data(), offsets.data(), offsets.size() - 1);
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : Budgets" ) {
+  SECTION ("Conflict budget") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf");
+    set_conflict_budget(solver, 10);
+    REQUIRE(solve(solver) == UNDEF);
+    REQUIRE(get_statistics(solver).conflicts == 10);
+    REQUIRE(solve(solver) == UNDEF);
+    set_conflict_budget(solver, 0);
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+  SECTION ("Propagation budget") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf");
+    set_propagation_budget(solver, 100);
+    REQUIRE(solve(solver) == UNDEF);
+    REQUIRE(get_statistics(solver).propagations >= 100);
+    set_propagation_budget(solver, 0);
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+  SECTION ("Time budget") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf");
+    set_time_budget(solver, 1e-9);
+    REQUIRE(solve(solver) == UNDEF);
+    set_time_budget(solver, 0);
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+  SECTION ("Interrupt") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf");
+    interrupt(solver);
+    REQUIRE(solve(solver) == UNDEF);
+    // the interruption is consumed by the search it stopped
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+  }
+}
+
+/**
+ * @brief Step of a DRAT proof: a lemma, or the deletion of a clause.
+ */
+typedef pair<bool, vector<int>> drat_step;
+
+/**
+ * @brief Reads the clauses of a DIMACS file, or the steps of a text DRAT proof, whose deletions start
+ * with "d". The steps of a DIMACS file are all lemmas.
+ */
+static vector<drat_step> read_text_clauses(const char* filename) {
+  ifstream file(find_file(filename));
+  vector<drat_step> steps;
+  drat_step step(false, {});
+  string token;
+  while (file >> token) {
+    if (token == "c" || token == "p")
+      getline(file, token);
+    else if (token == "d")
+      step.first = true;
+    else if (token != "0")
+      step.second.push_back(stoi(token));
+    else {
+      steps.push_back(step);
+      step = drat_step(false, {});
+    }
+  }
+  return steps;
+}
+
+/**
+ * @brief Reads the steps of a binary DRAT proof. Each step starts with 'a' or 'd', and each literal l is
+ * encoded as 2 * |l| + (l < 0) in 7-bit groups, the least significant first, until a 0. A malformed
+ * proof is read as an empty proof.
+ */
+static vector<drat_step> read_binary_proof(const char* filename) {
+  ifstream file(filename, ios::binary);
+  vector<drat_step> steps;
+  int c;
+  while ((c = file.get()) != EOF) {
+    if (c != 'a' && c != 'd')
+      return {};
+    drat_step step(c == 'd', {});
+    while (true) {
+      unsigned encoded = 0;
+      unsigned shift = 0;
+      do {
+        c = file.get();
+        if (c == EOF)
+          return {};
+        encoded |= (c & 0x7f) << shift;
+        shift += 7;
+      } while (c & 0x80);
+      if (encoded == 0)
+        break;
+      step.second.push_back(encoded & 1 ? -(int) (encoded >> 1) : (int) (encoded >> 1));
+    }
+    steps.push_back(step);
+  }
+  return steps;
+}
+
+/**
+ * @brief Checks a DRAT proof of the formula forward. Each lemma must be a reverse unit propagation
+ * (RUP) consequence of the clauses so far, that is, unit propagation from the negation of the lemma must
+ * reach a conflict. Each deletion must remove a clause of the formula or a lemma. The proof must derive
+ * the empty clause.
+ */
+static bool check_drat(const vector<drat_step>& formula, const vector<drat_step>& proof) {
+  vector<vector<int>> clauses;
+  int max_var = 0;
+  for (const vector<drat_step>* steps : {&formula, &proof})
+    for (const drat_step& step : *steps)
+      for (int lit : step.second)
+        max_var = max(max_var, abs(lit));
+  for (const drat_step& step : formula) {
+    clauses.push_back(step.second);
+    sort(clauses.back().begin(), clauses.back().end());
+  }
+  vector<int> value(max_var + 1, 0);
+  vector<int> assigned;
+  auto lit_value = [&value](int lit) { return lit > 0 ? value[lit] : -value[-lit]; };
+  auto assign = [&value, &assigned](int lit) {
+    value[abs(lit)] = lit > 0 ? 1 : -1;
+    assigned.push_back(abs(lit));
+  };
+  auto rup = [&](const vector<int>& lemma) {
+    bool conflict = false;
+    for (int lit : lemma) {
+      // a tautology is trivially implied
+      conflict = conflict || lit_value(lit) > 0;
+      if (!conflict && lit_value(lit) == 0)
+        assign(-lit);
+    }
+    for (bool changed = true; changed && !conflict;) {
+      changed = false;
+      for (unsigned i = 0; i < clauses.size() && !conflict; i++) {
+        unsigned unassigned = 0;
+        int last = 0;
+        bool satisfied = false;
+        for (int lit : clauses[i]) {
+          satisfied = satisfied || lit_value(lit) > 0;
+          if (lit_value(lit) == 0) {
+            unassigned++;
+            last = lit;
+          }
+        }
+        if (satisfied || unassigned > 1)
+          continue;
+        conflict = unassigned == 0;
+        if (!conflict) {
+          assign(last);
+          changed = true;
+        }
+      }
+    }
+    for (int var : assigned)
+      value[var] = 0;
+    assigned.clear();
+    return conflict;
+  };
+  for (const drat_step& step : proof) {
+    vector<int> clause = step.second;
+    sort(clause.begin(), clause.end());
+    if (step.first) {
+      auto it = find(clauses.begin(), clauses.end(), clause);
+      if (it == clauses.end())
+        return false;
+      clauses.erase(it);
+      continue;
+    }
+    if (!rup(clause))
+      return false;
+    if (clause.empty())
+      return true;
+    clauses.push_back(clause);
+  }
+  return false;
+}
+
+TEST_CASE( "[SAT-Integration] Integration Test : DRAT proof" ) {
+  vector<drat_step> formula = read_text_clauses("../tests/cnf/unsat-07.cnf");
+  vector<vector<string>> configurations = {{}, {"-lscb"}, {"-pre", "-viv"}};
+  for (vector<string>& configuration : configurations) {
+    configuration.insert(configuration.end(), {"-drat", "test-proof.drat", "--binary-proof", "off"});
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", configuration);
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+    REQUIRE(check_drat(formula, read_text_clauses("test-proof.drat")));
+  }
+  SECTION ("Binary proof") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-drat", "test-proof.drat"});
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+    REQUIRE(check_drat(formula, read_binary_proof("test-proof.drat")));
+  }
+  SECTION ("Incremental preprocessing") {
+    options options = setup_options({"-pre", "-drat", "test-proof.drat", "--binary-proof", "off"});
+    NapSAT* solver = create_solver(0, 0, options);
+    vector<vector<Tlit>> clauses = add_implication_chain(solver, 10);
+    REQUIRE(solve(solver) == SAT);
+    // the variables are kept, such that the clauses added later can be justified in the proof
+    REQUIRE(get_statistics(solver).eliminated_variables == 0);
+    clauses.push_back({literal(5, false)});
+    add_clause(solver, clauses.back().data(), 1);
+    REQUIRE(solve(solver) == SAT);
+    clauses.push_back({literal(10, false)});
+    add_clause(solver, clauses.back().data(), 1);
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+    vector<drat_step> chain;
+    for (vector<Tlit>& clause : clauses) {
+      chain.push_back(drat_step(false, {}));
+      for (Tlit lit : clause)
+        chain.back().second.push_back(lit_to_int(lit));
+    }
+    REQUIRE(check_drat(chain, read_text_clauses("test-proof.drat")));
+  }
+  SECTION ("Invalid proof") {
+    NapSAT* solver = setup("../tests/cnf/unsat-07.cnf", {"-drat", "test-proof.drat", "--binary-proof", "off"});
+    REQUIRE(solve(solver) == UNSAT);
+    teardown(solver);
+    vector<drat_step> proof = read_text_clauses("test-proof.drat");
+    // the empty clause alone is not implied by unit propagation
+    REQUIRE(!check_drat(formula, {proof.back()}));
+    // nor is the proof of a weaker formula
+    REQUIRE(!check_drat(vector<drat_step>(formula.begin() + 1, formula.end()), proof));
+  }
+  remove("test-proof.drat");
 }